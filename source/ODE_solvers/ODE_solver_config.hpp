@@ -61,6 +61,8 @@ struct ODE_solver_config {
     double absolute_error;
     double a_State;          //weights for computation of relative error (for error estimate)
     double a_dState_dLambda;  //weights for computation of relative error (for error estimate)
+
+    ODE_solverType solver_type = ODE_SOLVER_TYPE;  // Runge-Kutta method of ode_solver()
 };
 
 
@@ -8,6 +8,7 @@
 #include "../parameters/master_parameters.hpp"                             // needed for the vector of grid values to add
 #include "../postprocessing/causality_FDT_checks.hpp"    // check causality and FDTs at each step in the flow
 #include "../utilities/hdf5_routines.hpp"
+#include "../utilities/checkpoint_writer.hpp"
 #include "../correlation_functions/state.hpp"
 #include "old_solvers.hpp"
 #include "ODE_solver_config.hpp"
@@ -34,8 +35,18 @@ void postRKstep_stuff(Y& y_run, System& rhs, double x_run, const vec<double>& x_
         check_SE_causality(y_run); // check if the self-energy is causal at each step of the flow
         if constexpr(KELDYSH and (REG!=5)) check_FDTs(y_run, verbose); // check FDTs for Sigma and K1r at each step of the flow
 
-        if (filename != "") {
-            const bool is_converged = std::abs(x_run - config.Lambda_f) <= 1e-10 * (1 + std::abs(config.Lambda_f));
+        const bool is_converged = std::abs(x_run - config.Lambda_f) <= 1e-10 * (1 + std::abs(config.Lambda_f));
+        if constexpr (ASYNC_CHECKPOINTS) {
+            // snapshot of the state and the statistics, written in the background
+            if (filename != "" and mpi_world_rank() == 0) {
+                async_checkpoints().wait(); // finish the previous checkpoint before copying, such that at most one snapshot is kept in memory
+                async_checkpoints().submit([filename, iteration, is_converged, snapshot = y_run, stats = rhs.stats]() {
+                    add_state_to_hdf(filename, iteration + 1, snapshot, is_converged); // save result to hdf5 file
+                    stats.write_to_hdf(filename, snapshot.config, iteration + 1);
+                });
+            }
+        }
+        else if (filename != "") {
             add_state_to_hdf(filename, iteration + 1, y_run, is_converged); // save result to hdf5 file
         }
         #ifdef ADAPTIVE_GRID
@@ -50,10 +61,11 @@ void postRKstep_stuff(Y& y_run, System& rhs, double x_run, const vec<double>& x_
         #endif
 
 
-        rhs.stats.write_to_hdf(filename, y_run.config, iteration + 1);
+        if constexpr (not ASYNC_CHECKPOINTS) rhs.stats.write_to_hdf(filename, y_run.config, iteration + 1);
         rhs.stats.number_of_SE_iterations = 0;
         rhs.stats.time = 0.;
         rhs.stats.RKattempts = 0;
+        rhs.stats.RHS_evaluations = 0;
 
     }
     else {
@@ -128,6 +140,12 @@ namespace ode_solver_impl
         const std::array<double, stages - 1> c;
         const bool adaptive;
         const std::string name;
+        const int order;    // order of the method with the weights b_high
+
+        const bool first_same_as_last = false;  // if true, the last stage is evaluated at the result of the step (FSAL) and reused as dydx of the next step
+
+        static constexpr size_t n_derivative_buffers = stages;  // one buffer per stage in rk_workspace::k
+        static constexpr bool keeps_first_derivative = true;    // k[0] (dydx) remains valid after a step attempt
 
         double get_a(size_t row_index, size_t column_index) const
         {
@@ -171,7 +189,8 @@ namespace ode_solver_impl
             // c (nodes)
             .c = {1. / 5., 3. / 10., 3. / 5., 1., 7. / 8.},
             .adaptive = true,
-            .name = "Cash-Carp"
+            .name = "Cash-Carp",
+            .order = 5
     };
 
     const butcher_tableau<4> RK4basic{
@@ -186,7 +205,8 @@ namespace ode_solver_impl
             // c (nodes)
             .c = {1./2, 1./2., 1.},
             .adaptive = false,
-            .name = "basic Runge-Kutta 4"
+            .name = "basic Runge-Kutta 4",
+            .order = 4
     };
 
 
@@ -203,11 +223,205 @@ namespace ode_solver_impl
             // c (nodes)
             .c = {1./2., 3./4., 1.},
             .adaptive = true,
-            .name = "Bogacki–Shampine"
+            .name = "Bogacki–Shampine",
+            .order = 3
+    };
+
+    // Dormand, J. R., & Prince, P. J. (1980). A family of embedded Runge-Kutta formulae. Journal of Computational and Applied Mathematics, 6(1), 19–26. https://doi.org/10.1016/0771-050X(80)90013-3
+    // The last row of a equals b_high: the last stage is the right-hand side at the result of the step, which is reused
+    // as dydx of the next step (FSAL), such that an accepted step needs six evaluations of the right-hand side.
+    const butcher_tableau<7> dormand_prince{
+            // a (Runge-Kutta Matrix)
+            .a = {1. / 5.,           0.,                 0.,             0.,             0.,                 0.,
+                  3. / 40.,          9. / 40.,           0.,             0.,             0.,                 0.,
+                  44. / 45.,         -56. / 15.,         32. / 9.,       0.,             0.,                 0.,
+                  19372. / 6561.,    -25360. / 2187.,    64448. / 6561., -212. / 729.,   0.,                 0.,
+                  9017. / 3168.,     -355. / 33.,        46732. / 5247., 49. / 176.,     -5103. / 18656.,    0.,
+                  35. / 384.,        0.,                 500. / 1113.,   125. / 192.,    -2187. / 6784.,     11. / 84.},
+            // b (weights) for the 5th order solution
+            .b_high = {35. / 384., 0., 500. / 1113., 125. / 192., -2187. / 6784., 11. / 84., 0.},
+            // b (weights) for the 4th order solution
+            .b_low = {5179. / 57600., 0., 7571. / 16695., 393. / 640., -92097. / 339200., 187. / 2100., 1. / 40.},
+            // c (nodes)
+            .c = {1. / 5., 3. / 10., 4. / 5., 8. / 9., 1., 1.},
+            .adaptive = true,
+            .name = "Dormand-Prince",
+            .order = 5,
+            .first_same_as_last = true
+    };
+
+    /**
+     * Low-storage Runge-Kutta method in the 2N form of Williamson: with the registers y and dy, stage i computes
+     *      dy = A_i dy + h f(y, x + c_i h),
+     *      y  = y + B_i dy.
+     * Instead of one State per stage, only y, dy, the right-hand side of the current stage and the error estimate
+     *      err = h sum_i error_b_i f_i
+     * are kept (besides the initial state, which is needed if the step is rejected).
+     */
+    template <size_t stages>
+    struct low_storage_tableau
+    {
+        const std::array<double, stages> A;         // A[0] = 0
+        const std::array<double, stages> B;
+        const std::array<double, stages> c;         // nodes
+        const std::array<double, stages> error_b;   // weights of the method minus weights of the embedded method
+        const bool adaptive;
+        const std::string name;
+        const int order;
+
+        static constexpr size_t n_derivative_buffers = 2;       // k[0]: right-hand side of the current stage, k[1]: error estimate
+        static constexpr bool keeps_first_derivative = false;   // k[0] is overwritten by the later stages
+        static constexpr bool first_same_as_last = false;
+    };
+
+    // Carpenter, M. H., & Kennedy, C. A. (1994). Fourth-order 2N-storage Runge-Kutta schemes. NASA Technical Memorandum 109112.
+    // The embedded third-order weights (which do not use the second stage) are obtained from the order conditions of the equivalent Butcher tableau.
+    const low_storage_tableau<5> carpenter_kennedy_2N{
+            .A = {0.,
+                  -567301805773. / 1357537059087.,
+                  -2404267990393. / 2016746695238.,
+                  -3550918686646. / 2091501179385.,
+                  -1275806237668. / 842570457699.},
+            .B = {1432997174477. / 9575080441755.,
+                  5161836677717. / 13612068292357.,
+                  1720146321549. / 2090206949498.,
+                  3134564353537. / 4481467310338.,
+                  2277821191437. / 14882151754819.},
+            .c = {0.,
+                  0.1496590219992291173264914,
+                  0.3704009573642047729478154,
+                  0.6222557631344431677902413,
+                  0.9582821306746902543183510},
+            .error_b = {-0.1603343564100823542779280,
+                        0.3447430423405670752030927,
+                        -0.2440731265941595400348435,
+                        0.05465152707957369523487431,
+                        0.005012913584101123874804517},
+            .adaptive = true,
+            .name = "Carpenter-Kennedy 4(3) low-storage (2N)",
+            .order = 4
     };
 
 
 
+    /**
+     * Buffers of the Runge-Kutta stages, owned by ode_solver and reused in all steps. The buffers are allocated as
+     * copies of the state in the first step; afterwards, all arithmetic of the stepper works in place (see axpy), such
+     * that no further objects of type Y have to be allocated (the right-hand side itself may still allocate).
+     * @tparam Y    datatype of y, in fRG: State<Q>
+     */
+    template <typename Y>
+    struct rk_workspace {
+        vec<Y> k;           // right-hand sides of the stages (without multiplication with the step size); k[0] = dydx
+        Y state_stage;      // argument of the right-hand side at the current stage; error estimate after the last stage
+        Y result;           // result of the current step attempt
+        bool has_dydx = false;          // if true, k[0] already holds dydx at the current state (from the last stage of an FSAL method)
+        size_t rhs_evaluations = 0;     // total number of evaluations of the right-hand side
+
+        // stages of an interrupted step, see MIDSTEP_CHECKPOINTS
+        bool try_restore = true;        // the side files are only read in the first step after a (re)start
+        size_t n_restored_stages = 0;   // the stages 0, ..., n_restored_stages-1 of the current attempt have been read from the side files
+        double Lambda_step = 0.;        // Lambda at the beginning of the current step
+        double checksum_step = 0.;      // norm of the state at the beginning of the current step
+
+        /// Allocates the buffers as copies of y (only if this has not been done before)
+        void initialize(const Y& y, const size_t stages) {
+            if (k.size() == stages) return;
+            k = vec<Y>(stages, y);
+            state_stage = y;
+            result = y;
+            has_dydx = false;
+        }
+
+        /// Evaluates the right-hand side at the given stage of the step and counts the evaluation
+        template <typename System>
+        void evaluate_rhs(const System& rhs, const Y& y, Y& dydx, const double Lambda, const size_t stage) {
+            // the side files of the multiloop right-hand side belong to the stage (see rhs_checkpoint)
+            if constexpr (MIDSTEP_CHECKPOINTS and std::is_same_v<Y, State<state_datatype>>) rhs.checkpoint_config.stage = (int) stage;
+            rhs(y, dydx, Lambda);
+            rhs_evaluations++;
+        }
+    };
+
+    /// True if the stages of tableau are written into side files (see MIDSTEP_CHECKPOINTS); low-storage methods overwrite their stages
+    template <typename Y, typename Tableau>
+    constexpr bool stage_checkpoints = MIDSTEP_CHECKPOINTS and std::is_same_v<Y, State<state_datatype>> and Tableau::keeps_first_derivative;
+
+    /// Name of the side file which holds stage number stage of the current Runge-Kutta step
+    inline std::string stage_checkpoint_name(const std::string& filename, const size_t stage) {
+        return filename + "_RKstage" + std::to_string(stage);
+    }
+
+    /**
+     * Writes the stage k[stage] into its side file (in the background with ASYNC_CHECKPOINTS), identified by Lambda and
+     * the norm of the state at the beginning of the step, by the step size t_step of the attempt, by the stage index and
+     * by the method (config.solver_type).
+     */
+    template <typename Y>
+    void save_stage(const rk_workspace<Y>& workspace, const size_t stage, const double t_step, const ODE_solver_config& config) {
+        if (config.filename == "") return;
+        write_checkpoint_to_hdf_async(stage_checkpoint_name(config.filename, stage),
+                                      {workspace.Lambda_step, workspace.checksum_step, t_step, (double) stage, (double) config.solver_type},
+                                      workspace.k[stage]);
+    }
+
+    /**
+     * Identifies the step which starts at (state_i, Lambda_i). In the first step after a (re)start, the stages of an
+     * interrupted attempt of this step are read from the side files, as long as they belong to this step (same Lambda
+     * and norm of the state), to the same attempt (same step size), to the same stage and to the same method. If more
+     * than the first stage are restored, the step size of the interrupted attempt is adopted in t_step.
+     */
+    template <typename Y>
+    void begin_stage_checkpoints(rk_workspace<Y>& workspace, const Y& state_i, const double Lambda_i, double& t_step, const ODE_solver_config& config) {
+        workspace.Lambda_step = Lambda_i;
+        workspace.checksum_step = state_i.norm();
+        workspace.n_restored_stages = 0;
+        if (not workspace.try_restore or config.filename == "") return;
+        workspace.try_restore = false;
+
+        const auto agrees = [](const double a, const double b) { return std::abs(a - b) <= 1e-10 * (std::abs(a) + std::abs(b)); };
+        size_t& n = workspace.n_restored_stages;
+        double t_step_attempt = t_step;
+        std::vector<double> info;
+        while (n < workspace.k.size() and read_checkpoint_info_from_hdf(stage_checkpoint_name(config.filename, n), info)) {
+            if (info.size() != 5 or not agrees(info[0], workspace.Lambda_step) or not agrees(info[1], workspace.checksum_step)) break;
+            if (info[3] != (double) n or info[4] != (double) config.solver_type) break;
+            // stage 0 does not depend on the step size, the later stages have to belong to the attempt of stage 1
+            if (n == 1) t_step_attempt = info[2];
+            else if (n > 1 and info[2] != t_step_attempt) break;
+            workspace.k[n] = read_state_from_hdf(stage_checkpoint_name(config.filename, n), 0);
+            n++;
+        }
+        if (n > 1) t_step = t_step_attempt;
+#ifdef USE_MPI
+        MPI_Barrier(MPI_COMM_WORLD); // all processes have read the side files before they are overwritten
+#endif
+        if (n > 0) utils::print("Restored ", n, " stages of the Runge-Kutta step at Lambda = ", Lambda_i, " from side files.\n");
+    }
+
+    /// y += alpha * x without temporaries
+    template <typename Y>
+    void axpy(Y& y, const double alpha, const Y& x) {
+        if constexpr (std::is_arithmetic_v<Y> or std::is_same_v<Y, comp>) y += alpha * x;
+        else y.axpy(alpha, x);
+    }
+
+    /**
+     * Error estimate of a Runge-Kutta step: maximal relative deviation of err with respect to the scale
+     *      (|y| * a_State + |dydx * stepsize| * a_dState_dLambda) * relative_error + absolute_error
+     */
+    template <typename Y>
+    double max_rel_err_scaled(const Y& err, const Y& y, const Y& dydx, const double stepsize, const ODE_solver_config& config) {
+        if constexpr (std::is_same_v<Y, State<state_datatype>>) {
+            // fused reduction, without forming the scale
+            return err.norm() / y.norm_of_error_scale(dydx, config.a_State, std::abs(stepsize) * config.a_dState_dLambda, config.relative_error, config.absolute_error);
+        }
+        else {
+            Y y_scale = (abs(y) * config.a_State + abs(dydx*stepsize) * config.a_dState_dLambda) * config.relative_error + config.absolute_error;
+            return max_rel_err(err, y_scale);
+        }
+    }
+
     /**
      * Runge Kutta solver for methods that can be represented by a butcher tableau
      * @tparam Y                datatype of y, in fRG: State<Q>
@@ -215,75 +429,148 @@ namespace ode_solver_impl
      * @tparam stages           number of stages for the Runge-Kutta method specified in tableau
      * @param tableau           butcher tableau
      * @param y_init            initial state
-     * @param result            (returned) result of Runge-Kutte step
+     * @param workspace         buffers of the stages; workspace.k[0] has to contain the right-hand side at y_init,
+     *                          the result of the Runge-Kutta step is returned in workspace.result
      * @param t_value           gives initial x via FlowGrid
      * @param t_step            step size in x
      * @param maxrel_error      (returned) maximal relative deviation between 5-point and 4-point rule
      * @param rhs               function that computes the right-hand side of the flow equation
      */
     template <typename Y, typename FlowGrid, size_t stages, typename System>
-    void rk_step(const butcher_tableau<stages> &tableau, const Y &y_init, const Y &dydx,
-                   Y &result, const double t_value, const double t_step, double &maxrel_error, const System& rhs, const ODE_solver_config& config)
+    void rk_step(const butcher_tableau<stages> &tableau, const Y &y_init, rk_workspace<Y>& workspace,
+                 const double t_value, const double t_step, double &maxrel_error, const System& rhs, const ODE_solver_config& config)
     {
-        Y state_stage=y_init; // temporary state
-        //
-        vec<Y> k; // stores the pure right-hand-sides ( without multiplication with an step size )
-
-        k.reserve(stages);
-        k.push_back( dydx
+        vec<Y>& k = workspace.k;
+        Y& state_stage = workspace.state_stage;
+        Y& result = workspace.result;
+        std::array<double, stages> k_factor; // the derivatives with respect to the integration variable are k_factor[i] * k[i]
+        k_factor[0] =
 #ifdef REPARAMETRIZE_FLOWGRID
-        * FlowGrid::dlambda_dt(t_value)
+                FlowGrid::dlambda_dt(t_value);
+#else
+                1.;
 #endif
-        );
-
 
         double Lambda_stage;
         double t_stage, stepsize;
-        // Start at 1 because 0th stage is already contained in dydx parameter
+#ifdef REPARAMETRIZE_FLOWGRID
+        stepsize = t_step;
+#else
+        const double Lambda = FlowGrid::lambda_from_t(t_value);
+        const double dLambda = FlowGrid::lambda_from_t(t_value + t_step) - Lambda;
+        stepsize = dLambda;
+#endif
+        // Start at 1 because 0th stage is already contained in k[0]
         for (size_t stage = 1; stage < stages; stage++)
         {
 #ifdef REPARAMETRIZE_FLOWGRID
             t_stage = t_value + t_step* tableau.get_node(stage);
             Lambda_stage = FlowGrid::lambda_from_t(t_stage);
-            stepsize = t_step;
             //utils::print("\t current t_stage: ", t_stage, "\n" );
 #else
-            const double Lambda = FlowGrid::lambda_from_t(t_value);
-            double dLambda = FlowGrid::lambda_from_t(t_value + t_step) - Lambda;
             Lambda_stage = Lambda + dLambda * tableau.get_node(stage);
-            stepsize = dLambda;
 #endif
 
-            state_stage = y_init;
-            for (size_t col_index = 0; col_index < stage; col_index++)
-            {
-                double factor = stepsize * tableau.get_a(stage, col_index);
-                state_stage += k[col_index] * factor;
-            }
+            if (stage >= workspace.n_restored_stages) { // not yet computed in an interrupted run
+                state_stage = y_init;   // copied into the existing buffer
+                for (size_t col_index = 0; col_index < stage; col_index++)
+                {
+                    const double factor = stepsize * tableau.get_a(stage, col_index) * k_factor[col_index];
+                    if (factor != 0.) axpy(state_stage, factor, k[col_index]);
+                }
 
-            Y dydx_temp;
-            rhs(state_stage, dydx_temp, Lambda_stage)
-            ;
-            k.push_back( dydx_temp
+                workspace.evaluate_rhs(rhs, state_stage, k[stage], Lambda_stage, stage);
+                if constexpr (stage_checkpoints<Y, butcher_tableau<stages>>) save_stage(workspace, stage, t_step, config);
+            }
+            k_factor[stage] =
 #ifdef REPARAMETRIZE_FLOWGRID
-                    * FlowGrid::dlambda_dt(t_stage)
+                    FlowGrid::dlambda_dt(t_stage);
+#else
+                    1.;
 #endif
-            );
         }
+        workspace.n_restored_stages = 0; // a repeated attempt computes all stages
 
         result = y_init;
         for (size_t stage = 0; stage < stages; stage++)
         {
-            result += k[stage] * stepsize * tableau.b_high[stage];
+            if (tableau.b_high[stage] != 0.) axpy(result, stepsize * tableau.b_high[stage] * k_factor[stage], k[stage]);
         }
 
-        Y err = k[0] * stepsize * tableau.get_error_b(0);
+        // the buffer of the stages is not needed anymore and holds the error estimate
+        Y& err = state_stage;
+        err = k[0];
+        err *= stepsize * tableau.get_error_b(0) * k_factor[0];
         for (size_t stage = 1; stage < stages; stage++)
         {
-            err += k[stage] * stepsize * tableau.get_error_b(stage);
+            if (tableau.get_error_b(stage) != 0.) axpy(err, stepsize * tableau.get_error_b(stage) * k_factor[stage], k[stage]);
         }
-        Y y_scale = (abs(result) * config.a_State + abs(dydx*stepsize) * config.a_dState_dLambda) * config.relative_error + config.absolute_error;
-        maxrel_error = max_rel_err(err, y_scale); // alternatively state yscal = abs_sum_tiny(integrated, h * dydx, tiny);
+        maxrel_error = max_rel_err_scaled(err, result, k[0], stepsize, config); // alternatively state yscal = abs_sum_tiny(integrated, h * dydx, tiny);
+        if (VERBOSE) utils::print("ODE solver error estimate: ", maxrel_error, "\n");
+    }
+
+    /**
+     * Step of a low-storage Runge-Kutta method (see low_storage_tableau), with the same interface as the step for
+     * butcher tableaus. On entry, workspace.k[0] has to contain the right-hand side at y_init. The registers are
+     * workspace.result (y), workspace.state_stage (dy), workspace.k[0] (right-hand side of the current stage) and
+     * workspace.k[1] (error estimate).
+     */
+    template <typename Y, typename FlowGrid, size_t stages, typename System>
+    void rk_step(const low_storage_tableau<stages> &tableau, const Y &y_init, rk_workspace<Y>& workspace,
+                 const double t_value, const double t_step, double &maxrel_error, const System& rhs, const ODE_solver_config& config)
+    {
+        Y& f = workspace.k[0];
+        Y& err = workspace.k[1];
+        Y& dy = workspace.state_stage;
+        Y& y = workspace.result;
+
+        double Lambda_stage;
+        double t_stage = t_value, stepsize;
+#ifdef REPARAMETRIZE_FLOWGRID
+        stepsize = t_step;
+#else
+        const double Lambda = FlowGrid::lambda_from_t(t_value);
+        const double dLambda = FlowGrid::lambda_from_t(t_value + t_step) - Lambda;
+        stepsize = dLambda;
+#endif
+        for (size_t stage = 0; stage < stages; stage++)
+        {
+            if (stage > 0)
+            {
+#ifdef REPARAMETRIZE_FLOWGRID
+                t_stage = t_value + t_step * tableau.c[stage];
+                Lambda_stage = FlowGrid::lambda_from_t(t_stage);
+#else
+                Lambda_stage = Lambda + dLambda * tableau.c[stage];
+#endif
+                workspace.evaluate_rhs(rhs, y, f, Lambda_stage, stage);
+            }
+            const double h =
+#ifdef REPARAMETRIZE_FLOWGRID
+                    stepsize * FlowGrid::dlambda_dt(t_stage);
+#else
+                    stepsize;
+#endif
+
+            if (stage == 0)
+            {
+                dy = f;
+                dy *= h;
+                err = f;
+                err *= h * tableau.error_b[0];
+                y = y_init;
+            }
+            else
+            {
+                dy *= tableau.A[stage];
+                axpy(dy, h, f);
+                axpy(err, h * tableau.error_b[stage], f);
+            }
+            axpy(y, tableau.B[stage], dy);
+        }
+
+        // dydx at y_init is not kept; the scale of the error uses the right-hand side of the last stage instead
+        maxrel_error = max_rel_err_scaled(err, y, f, stepsize, config);
         if (VERBOSE) utils::print("ODE solver error estimate: ", maxrel_error, "\n");
     }
 
@@ -299,34 +586,43 @@ namespace ode_solver_impl
  * @param max_t_step
  * @param lambda_checkpoints
  * @param rhs
+ * @param workspace     buffers of the Runge-Kutta stages (reused in all steps)
  */
-    template <typename Y, typename FlowGrid, size_t stages, typename System>
-    void rkqs(butcher_tableau<stages> tableau, Y &state_i, double &Lambda_i, double htry, double &hdid, double &hnext,
+    template <typename Y, typename FlowGrid, typename Tableau, typename System>
+    void rkqs(const Tableau& tableau, Y &state_i, double &Lambda_i, double htry, double &hdid, double &hnext,
               double min_t_step, double max_t_step,
-              const System& rhs, size_t iteration, const ODE_solver_config& config, const bool verbose)
+              const System& rhs, size_t iteration, const ODE_solver_config& config, const bool verbose, rk_workspace<Y>& workspace)
     {
 
 
         // Safety intentionally chosen smaller than in Numerical recipes, because the step
         // size estimates were consistently too large and repeated steps are very expensive
-        const double SAFETY = 0.8, PGROW = -0.2, PSHRINK = -0.25, MAXGROW = 2.;
+        // Exponents for a method of order p with an embedded method of order p-1 (Cash-Karp: PGROW = -0.2, PSHRINK = -0.25)
+        const double SAFETY = 0.8, PGROW = -1. / tableau.order, PSHRINK = -1. / (tableau.order - 1), MAXGROW = 2.;
 
         int world_rank = mpi_world_rank();
 
 
         const double t_value = FlowGrid::t_from_lambda(Lambda_i);
         double t_step = FlowGrid::t_from_lambda(Lambda_i + htry) - t_value;
-        Y dydx;
-        rhs(state_i, dydx, Lambda_i); // const State_t& state_in, State_t& dState_dt, double Lambda_in
+        workspace.initialize(state_i, Tableau::n_derivative_buffers);
+        if constexpr (stage_checkpoints<Y, Tableau>) begin_stage_checkpoints(workspace, state_i, Lambda_i, t_step, config);
+        // dydx is only known from the previous step for FSAL methods (not after a restart or a modification of the state)
+        if (not workspace.has_dydx and workspace.n_restored_stages == 0) workspace.evaluate_rhs(rhs, state_i, workspace.k[0], Lambda_i, 0); // const State_t& state_in, State_t& dState_dt, double Lambda_in
+        if constexpr (stage_checkpoints<Y, Tableau>) {
+            if (workspace.n_restored_stages == 0) save_stage(workspace, 0, t_step, config);
+        }
+        workspace.has_dydx = false;
         bool rejected = false;
         double errmax;
         unsigned int attempts = 0;
 
         //const auto &lattice = state_i.vertex.lattice;
-        Y temporary = state_i;
         for (;;)    // infinite loop
         {
             // === Evaluation ===
+            // low-storage methods overwrite dydx, which has to be recomputed after a rejected step
+            if (rejected and not Tableau::keeps_first_derivative) workspace.evaluate_rhs(rhs, state_i, workspace.k[0], Lambda_i, 0);
             if (verbose and world_rank == 0)
             {
                 utils::print("Try stepsize t ", t_step, " (from Lambda = ", Lambda_i
@@ -334,7 +630,7 @@ namespace ode_solver_impl
                           , ").\n");
                 utils::print("Current t: ", t_value, "\n");
             };
-            ode_solver_impl::rk_step<Y, FlowGrid>(tableau, state_i, dydx, temporary, t_value, t_step, errmax, rhs, config);
+            ode_solver_impl::rk_step<Y, FlowGrid>(tableau, state_i, workspace, t_value, t_step, errmax, rhs, config);
 
             if constexpr(std::is_same<State<state_datatype>, Y>::value) {
                 rhs.rk_step = 1;
@@ -419,150 +715,194 @@ namespace ode_solver_impl
         Lambda_i = FlowGrid::lambda_from_t(t_value + t_step);
         hdid = Lambda_i - FlowGrid::lambda_from_t(t_value);
         hnext = FlowGrid::lambda_from_t(t_value + t_step + t_next_step) - Lambda_i;
-        state_i = temporary;
+        std::swap(state_i, workspace.result);   // the old state is kept as buffer for the next step
+        if (tableau.first_same_as_last) {
+            // the last stage was evaluated at the new state_i and Lambda_i: it is dydx of the next step
+            std::swap(workspace.k[0], workspace.k[Tableau::n_derivative_buffers - 1]);
+            workspace.has_dydx = true;
+        }
+        if (verbose) utils::print_memory_usage();
         //assert(t_next_step>=0);
     }
 
-} // namespace ode_solver_impl
-
-
-/**
- * ODE solver, by default implementing a fourth-order Runge-Kutta (Cash-Karp) algorithm.
- * (Other options are possible but not recommended!)
- * @tparam Y Type of the data to be handled by the solver. Can be double, comp, State, ...
- * @tparam FlowGrid Suggests a set of step sizes:
- * - for non-adaptive rules, these are used directly --> lambdas_try
- * - for adaptive rules, FlowGrid only approximately "guides" the step sizes;
- *   e.g. for FlowGrid::exp_parametrization we have Lambda(t) = exp(-t) such that equal step sizes in t lead to
- *   exponentially decaying step sizes. Adaptive rules can grow or shrink the step sizes in terms of t!
- * @tparam System
- * @param result Final state.
- * @param state_ini Initial state of type Y.
- * @param rhs Callable instance of a class used to implement the RHS of the differential equation.
- * @param config Config struct holding all relevant parameters for the ODE.
- * @param verbose If true, additional information is printed into the log file. Recommendation: true.
- */
-template <typename Y, typename FlowGrid = flowgrid::sqrt_parametrization, typename System
-        >
-void ode_solver(Y& result, const Y& state_ini, const System& rhs,
-                const ODE_solver_config& config=ODE_solver_config(), const bool verbose=true) {
-    int world_rank = mpi_world_rank();
+    /**
+     * Adaptive ODE solver with the Runge-Kutta method given by tableau (butcher_tableau or low_storage_tableau), see ::ode_solver().
+     */
+    template <typename Y, typename FlowGrid, typename Tableau, typename System>
+    void ode_solver(const Tableau& tableau, Y& result, const Y& state_ini, const System& rhs,
+                    const ODE_solver_config& config, const bool verbose) {
+        int world_rank = mpi_world_rank();
 
 
-    // quality-controlled RK-step (cf. Numerical recipes in C, page 723)
+        // quality-controlled RK-step (cf. Numerical recipes in C, page 723)
 
-    const auto tableau = ode_solver_impl::cash_carp;
-    if (verbose and world_rank == 0) {
-        const std::string message =
-                "\n-------------------------------------------------------------------------\n\tStarting ODE solver with method: " + tableau.name + " \n"
-               +"-------------------------------------------------------------------------\n";
-        std::cout << message;
-    }
+        if (verbose and world_rank == 0) {
+            const std::string message =
+                    "\n-------------------------------------------------------------------------\n\tStarting ODE solver with method: " + tableau.name + " \n"
+                   +"-------------------------------------------------------------------------\n";
+            std::cout << message;
+        }
 
 
-    const unsigned int MAXSTP = config.maximal_number_of_ODE_steps + config.lambda_checkpoints.size(); //maximal number of steps that is computed
-    vec<double> lambdas (MAXSTP+1); // contains all lambdas (including starting point)
-    lambdas[0] = config.Lambda_i;
-    if constexpr (std::is_same_v<Y,State<state_datatype>>) {
-        /// load lambdas from file to continue ODE solver
-        if (config.iter_start > 0) {
-            H5::H5File file_out(config.filename, H5F_ACC_RDONLY);
-            read_from_hdf<double>(file_out, LAMBDA_LIST, lambdas);
-            file_out.close();
+        const unsigned int MAXSTP = config.maximal_number_of_ODE_steps + config.lambda_checkpoints.size(); //maximal number of steps that is computed
+        vec<double> lambdas (MAXSTP+1); // contains all lambdas (including starting point)
+        lambdas[0] = config.Lambda_i;
+        if constexpr (std::is_same_v<Y,State<state_datatype>>) {
+            /// load lambdas from file to continue ODE solver
+            if (config.iter_start > 0) {
+                std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
+                H5::H5File file_out(config.filename, H5F_ACC_RDONLY);
+                read_from_hdf<double>(file_out, LAMBDA_LIST, lambdas);
+                file_out.close();
+            }
+            // the side files of the multiloop right-hand side belong to the method (see rhs_checkpoint)
+            if constexpr (MIDSTEP_CHECKPOINTS) rhs.checkpoint_config.method = (int) config.solver_type;
         }
-    }
 
-    // get lambdas according to FlowGrid (for hybridization flow: + checkpoints acc. to U_NRG  ) -> for non-adaptive method
-    const vec<double> lambdas_try = flowgrid::construct_flow_grid(config.Lambda_f, config.Lambda_i, FlowGrid::t_from_lambda, FlowGrid::lambda_from_t, config.maximal_number_of_ODE_steps, tableau.adaptive ? std::vector<double>() : config.lambda_checkpoints);
-
-    const double max_t_step = 1e1;  // maximal step size in terms of t
-    const double min_t_step = 1e-5; // minimal step size in terms of t
-
-    double Lambda = config.Lambda_now;    // step size to try (in terms of Lambda)
-    double h_try;
-    if (tableau.adaptive and config.iter_start > 0) {
-        /// next: try an equal stepsize in terms of the reparametrized flow parameter t
-        double lambdas_0 = lambdas[config.iter_start-1];
-        double lambdas_1 = lambdas[config.iter_start];
-        double htry_last_reparametrized = FlowGrid::t_from_lambda(lambdas_1) - FlowGrid::t_from_lambda(lambdas_0);
-        htry_last_reparametrized = std::min(std::abs(htry_last_reparametrized), max_t_step) ;
-        htry_last_reparametrized = std::max(std::abs(htry_last_reparametrized), min_t_step) ;
-        h_try = FlowGrid::lambda_from_t(FlowGrid::t_from_lambda(Lambda) + htry_last_reparametrized) - Lambda;
-    }
-    else {
-        h_try = lambdas_try[config.iter_start + 1]-lambdas_try[config.iter_start];
-    }
+        // get lambdas according to FlowGrid (for hybridization flow: + checkpoints acc. to U_NRG  ) -> for non-adaptive method
+        const vec<double> lambdas_try = flowgrid::construct_flow_grid(config.Lambda_f, config.Lambda_i, FlowGrid::t_from_lambda, FlowGrid::lambda_from_t, config.maximal_number_of_ODE_steps, tableau.adaptive ? std::vector<double>() : config.lambda_checkpoints);
+
+        const double max_t_step = 1e1;  // maximal step size in terms of t
+        const double min_t_step = 1e-5; // minimal step size in terms of t
+
+        double Lambda = config.Lambda_now;    // step size to try (in terms of Lambda)
+        double h_try;
+        if (tableau.adaptive and config.iter_start > 0) {
+            /// next: try an equal stepsize in terms of the reparametrized flow parameter t
+            double lambdas_0 = lambdas[config.iter_start-1];
+            double lambdas_1 = lambdas[config.iter_start];
+            double htry_last_reparametrized = FlowGrid::t_from_lambda(lambdas_1) - FlowGrid::t_from_lambda(lambdas_0);
+            htry_last_reparametrized = std::min(std::abs(htry_last_reparametrized), max_t_step) ;
+            htry_last_reparametrized = std::max(std::abs(htry_last_reparametrized), min_t_step) ;
+            h_try = FlowGrid::lambda_from_t(FlowGrid::t_from_lambda(Lambda) + htry_last_reparametrized) - Lambda;
+        }
+        else {
+            h_try = lambdas_try[config.iter_start + 1]-lambdas_try[config.iter_start];
+        }
 
-    double hnext, hdid, h_try_prev{}; // step size to try next; actually performed step size
-    bool just_hit_a_lambda_checkpoint = false;
-    result = state_ini;
+        double hnext, hdid, h_try_prev{}; // step size to try next; actually performed step size
+        bool just_hit_a_lambda_checkpoint = false;
+        result = state_ini;
+        rk_workspace<Y> workspace; // buffers of the stages, allocated in the first step
 
-    for (unsigned int i = config.iter_start; i < MAXSTP; i++)
-    {
-        if (verbose and world_rank == 0)
+        for (unsigned int i = config.iter_start; i < MAXSTP; i++)
         {
-            std::cout <<"-------------------------------------------------------------------------\n";
-            utils::print("Now do ODE step number \t\t", i, true);
-            utils::print("Lambda: ", Lambda, true);
-        };
-        if constexpr(std::is_same<State<state_datatype>, Y>::value) {
-            rhs.iteration = i;
-        }
+            if (verbose and world_rank == 0)
+            {
+                std::cout <<"-------------------------------------------------------------------------\n";
+                utils::print("Now do ODE step number \t\t", i, true);
+                utils::print("Lambda: ", Lambda, true);
+            };
+            if constexpr(std::is_same<State<state_datatype>, Y>::value) {
+                rhs.iteration = i;
+            }
 
-        //if next step would get us outside the interval [Lambda_f, Lambda_i]
-        if ((Lambda + h_try - config.Lambda_f) * (Lambda + h_try - config.Lambda_now) > 0.0)
-        {
-            // if remaining Lambda step is negligibly small
-            if (std::abs(config.Lambda_f - Lambda) / config.Lambda_f < 1e-8)
+            //if next step would get us outside the interval [Lambda_f, Lambda_i]
+            if ((Lambda + h_try - config.Lambda_f) * (Lambda + h_try - config.Lambda_now) > 0.0)
             {
-                if (verbose and world_rank == 0)
+                // if remaining Lambda step is negligibly small
+                if (std::abs(config.Lambda_f - Lambda) / config.Lambda_f < 1e-8)
                 {
-                    std::cout << "Final Lambda=Lambda_f reached. Program terminated." << std::endl;
+                    if (verbose and world_rank == 0)
+                    {
+                        std::cout << "Final Lambda=Lambda_f reached. Program terminated." << std::endl;
+                    };
+                    break;
+                }
+                else
+                {
+                    h_try = config.Lambda_f - Lambda;
                 };
-                break;
-            }
-            else
-            {
-                h_try = config.Lambda_f - Lambda;
             };
-        };
 
-        if (just_hit_a_lambda_checkpoint) {h_try = std::max(h_try_prev, h_try_prev - h_try);} // jump to previously suggested Lambda_next if we just hit a Lambda checkpoint
-        h_try_prev = h_try; // remember h_try from this iteration in case we hit a Lambda checkpoint
-        just_hit_a_lambda_checkpoint = false;
+            if (just_hit_a_lambda_checkpoint) {h_try = std::max(h_try_prev, h_try_prev - h_try);} // jump to previously suggested Lambda_next if we just hit a Lambda checkpoint
+            h_try_prev = h_try; // remember h_try from this iteration in case we hit a Lambda checkpoint
+            just_hit_a_lambda_checkpoint = false;
 
-        // === Checkpoints ===
-        const double Lambda_next = config.Lambda_now + h_try;
-        for (const double checkpoint : config.lambda_checkpoints)
-        {
-            // Guard against float arithmetic fails
-            if ((config.Lambda_now - checkpoint) * (Lambda_next - checkpoint) < -1e-10 and tableau.adaptive)
+            // === Checkpoints ===
+            const double Lambda_next = config.Lambda_now + h_try;
+            for (const double checkpoint : config.lambda_checkpoints)
             {
-                h_try = checkpoint - config.Lambda_now;
-                just_hit_a_lambda_checkpoint = true;
-                break;
+                // Guard against float arithmetic fails
+                if ((config.Lambda_now - checkpoint) * (Lambda_next - checkpoint) < -1e-10 and tableau.adaptive)
+                {
+                    h_try = checkpoint - config.Lambda_now;
+                    just_hit_a_lambda_checkpoint = true;
+                    break;
+                }
             }
-        }
 
-        // fix step size for non-adaptive methods
-        if (not tableau.adaptive) h_try = lambdas_try[i+1] - lambdas_try[i];
-        ode_solver_impl::rkqs<Y, FlowGrid>(tableau, result, Lambda, h_try, hdid, hnext, min_t_step, max_t_step, rhs, i, config, verbose);
-        // Pick h_suggested and set Lambda_i for next iteration
-        if (tableau.adaptive) {
-            config.Lambda_now += hdid;
-            if (just_hit_a_lambda_checkpoint){h_try = hdid;} else {h_try = hnext;}
-        }
+            // fix step size for non-adaptive methods
+            if (not tableau.adaptive) h_try = lambdas_try[i+1] - lambdas_try[i];
+            rkqs<Y, FlowGrid>(tableau, result, Lambda, h_try, hdid, hnext, min_t_step, max_t_step, rhs, i, config, verbose, workspace);
+            // Pick h_suggested and set Lambda_i for next iteration
+            if (tableau.adaptive) {
+                config.Lambda_now += hdid;
+                if (just_hit_a_lambda_checkpoint){h_try = hdid;} else {h_try = hnext;}
+            }
 
 
 
-        lambdas[i+1] = Lambda;
+            lambdas[i+1] = Lambda;
 
-        // if Y == State: save state in hdf5
-        postRKstep_stuff<Y>(result, rhs, Lambda, lambdas, i, config.filename, config, verbose);
+            // if Y == State: save state in hdf5
+            postRKstep_stuff<Y>(result, rhs, Lambda, lambdas, i, config.filename, config, verbose);
 
+            // the frequency grids of a State are changed after each step; a reused dydx has to follow
+            if constexpr (std::is_same_v<Y, State<state_datatype>>) {
+                if (workspace.has_dydx) {
+#ifdef ADAPTIVE_GRID
+                    workspace.has_dydx = false; // the grids depend on the data, dydx is recomputed
+#else
+                    workspace.k[0].update_grid(Lambda);
+#endif
+                }
+            }
 
+        };
+        if (verbose and world_rank == 0) utils::print("Evaluations of the right-hand side (", tableau.name, "): ", workspace.rhs_evaluations, "\n");
+        if constexpr (ASYNC_CHECKPOINTS) async_checkpoints().wait(); // the last checkpoint is complete when the solver returns
+        if constexpr (stage_checkpoints<Y, Tableau>) {
+            // the side files of the stages are not needed after the flow is completed
+            if (config.filename != "" and world_rank == 0) {
+                for (size_t stage = 0; stage < Tableau::n_derivative_buffers; stage++) std::remove(stage_checkpoint_name(config.filename, stage).c_str());
+            }
+        }
+    }
 
-    };
+} // namespace ode_solver_impl
+
+
+/**
+ * ODE solver, by default implementing a fourth-order Runge-Kutta (Cash-Karp) algorithm.
+ * The method is chosen by config.solver_type (see ODE_solverType): the low-storage method keeps fewer States in memory.
+ * @tparam Y Type of the data to be handled by the solver. Can be double, comp, State, ...
+ * @tparam FlowGrid Suggests a set of step sizes:
+ * - for non-adaptive rules, these are used directly --> lambdas_try
+ * - for adaptive rules, FlowGrid only approximately "guides" the step sizes;
+ *   e.g. for FlowGrid::exp_parametrization we have Lambda(t) = exp(-t) such that equal step sizes in t lead to
+ *   exponentially decaying step sizes. Adaptive rules can grow or shrink the step sizes in terms of t!
+ * @tparam System
+ * @param result Final state.
+ * @param state_ini Initial state of type Y.
+ * @param rhs Callable instance of a class used to implement the RHS of the differential equation.
+ * @param config Config struct holding all relevant parameters for the ODE.
+ * @param verbose If true, additional information is printed into the log file. Recommendation: true.
+ */
+template <typename Y, typename FlowGrid = flowgrid::sqrt_parametrization, typename System
+        >
+void ode_solver(Y& result, const Y& state_ini, const System& rhs,
+                const ODE_solver_config& config=ODE_solver_config(), const bool verbose=true) {
+    switch (config.solver_type) {
+        case low_storage_4_3:
+            ode_solver_impl::ode_solver<Y, FlowGrid>(ode_solver_impl::carpenter_kennedy_2N, result, state_ini, rhs, config, verbose);
+            break;
+        case dormand_prince_5_4:
+            ode_solver_impl::ode_solver<Y, FlowGrid>(ode_solver_impl::dormand_prince, result, state_ini, rhs, config, verbose);
+            break;
+        default:
+            ode_solver_impl::ode_solver<Y, FlowGrid>(ode_solver_impl::cash_carp, result, state_ini, rhs, config, verbose);
+    }
 }
 
 
@@ -2,6 +2,11 @@
 #define KELDYSH_MFRG_BUBBLE_HPP
 
 #include <cmath>                            // for using the macro M_PI as pi
+#include <array>
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
 #include "../symmetries/Keldysh_symmetries.hpp"  // for independent Keldysh components and utilities
 #include "../correlation_functions/four_point/vertex.hpp"                         // vertex class
 #include "../correlation_functions/two_point/selfenergy.hpp"                     // self-energy class
@@ -13,6 +18,99 @@
 #include "../utilities/write_data2file.hpp"      // write vectors into hdf5 file
 
 
+/**
+ * Cache for the values of the bubble Pi(w, v'') in the Keldysh formalism (4x4 matrix in Keldysh indices).
+ * Within one Bubble object, the same pairs (w, v'') are needed again and again by K1, K2 and K3 and by the loop
+ * contributions of higher order. The frequencies are quantized in units of a resolution (see bubble_cache_resolution):
+ * the key consists of the index of w and of v'' on this mesh, and the value of a key is always computed at the
+ * quantized v'' (see Bubble::value_vectorized()), such that the results do not depend on the order of the evaluations.
+ * Thread-safe: the entries are distributed over shards with separate locks.
+ * The a- and t-channel share their entries, since their bubbles coincide.
+ */
+template <typename Q>
+class BubbleCache {
+public:
+    using value_type = Eigen::Matrix<Q, 4, 4>;
+
+    BubbleCache(const size_t max_entries, const double resolution_in)
+    : max_entries_per_shard(max_entries / n_shards + 1), resolution(resolution_in) {}
+
+    /// index of the frequency v on the mesh of the cache
+    long long quantize(const freqType v) const {return std::llround(v / resolution);}
+    /// frequency of the mesh point with index i
+    freqType frequency(const long long i) const {return i * resolution;}
+
+    /// Returns the cached value if present, otherwise computes it with compute() and stores it (unless the cache is full).
+    template <typename Function>
+    value_type get(const char channel, const long long iw, const long long ivpp, const int i_in, Function&& compute) {
+        const key_type key {channel == 'p', iw, ivpp, i_in};
+        const size_t hash = key_hash()(key);
+        shard& s = shards[hash % n_shards];
+        {
+            std::shared_lock<std::shared_mutex> lock(s.mutex);
+            const auto it = s.values.find(key);
+            if (it != s.values.end()) {
+                hits.fetch_add(1, std::memory_order_relaxed);
+                return it->second;
+            }
+        }
+        misses.fetch_add(1, std::memory_order_relaxed);
+        const value_type value = compute();
+        {
+            std::unique_lock<std::shared_mutex> lock(s.mutex);
+            if (s.values.size() < max_entries_per_shard) s.values.emplace(key, value);
+        }
+        return value;
+    }
+
+    size_t get_hits() const {return hits.load();}
+    size_t get_misses() const {return misses.load();}
+    size_t size() const {
+        size_t n = 0;
+        for (const shard& s : shards) {
+            std::shared_lock<std::shared_mutex> lock(s.mutex);
+            n += s.values.size();
+        }
+        return n;
+    }
+
+    void print_statistics() const {
+        const size_t n_hits = get_hits(), n_misses = get_misses();
+        utils::print("Bubble cache: " + std::to_string(n_hits) + " hits, " + std::to_string(n_misses) + " misses (hit rate "
+                     + std::to_string(n_hits + n_misses > 0 ? 100. * n_hits / (n_hits + n_misses) : 0.) + " %), "
+                     + std::to_string(size()) + " entries", true);
+    }
+
+private:
+    struct key_type {
+        bool p_channel;
+        long long iw;       // index of w on the mesh of the cache
+        long long ivpp;     // index of v'' on the mesh of the cache
+        int i_in;
+        bool operator==(const key_type& other) const {
+            return p_channel == other.p_channel and iw == other.iw and ivpp == other.ivpp and i_in == other.i_in;
+        }
+    };
+    struct key_hash {
+        size_t operator()(const key_type& key) const {
+            size_t hash = std::hash<long long>()(key.iw);
+            hash ^= std::hash<long long>()(key.ivpp) + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+            hash ^= std::hash<int>()(2 * key.i_in + key.p_channel) + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+            return hash;
+        }
+    };
+    struct shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<key_type, value_type, key_hash> values;
+    };
+
+    static constexpr size_t n_shards = 64;
+    const size_t max_entries_per_shard;
+    const double resolution;    // spacing of the frequency mesh of the keys
+    std::array<shard, n_shards> shards;
+    std::atomic<size_t> hits {0}, misses {0};
+};
+
 /**
  * Class combining two propagators, either GG or GS+SG
  * @tparam Q Type of the data.
@@ -23,6 +121,8 @@ public:
     const Propagator<Q>& g; // Access needed when computing the full bubble
     const Propagator<Q>& s;
     const bool diff;
+    /// cache for value_vectorized(), shared by all copies of the Bubble object (see CACHE_BUBBLE_VALUES)
+    std::shared_ptr<BubbleCache<Q>> cache;
 
     /**
      * Constructor:
@@ -34,6 +134,10 @@ public:
         :g(propagatorG), s(propagatorS), diff(diff_in) {
         g.initInterpolator();
         s.initInterpolator();
+        if constexpr(CACHE_BUBBLE_VALUES and KELDYSH) {
+            const double Delta = (g.Lambda + g.Gamma) / 2.; // hybridization, sets the scale of the features of Pi
+            cache = std::make_shared<BubbleCache<Q>>(bubble_cache_max_entries, bubble_cache_resolution * Delta);
+        }
     };
 
     /**
@@ -221,9 +325,29 @@ public:
 
     /**
      * Version of the value function used if vectorization over Keldysh indices is to be used.
+     * With CACHE_BUBBLE_VALUES, v'' is rounded to the mesh of the cache (w is a grid point and only used to identify
+     * the entry), and the Keldysh matrices are taken from the cache if they have been computed before.
      */
     template<char ch_bubble>
     auto value_vectorized(const freqType w, const freqType vpp, const int i_in) const {
+        if constexpr(CACHE_BUBBLE_VALUES and KELDYSH) {
+            const long long ivpp = cache->quantize(vpp);
+            return cache->get(ch_bubble, cache->quantize(w), ivpp, i_in,
+                              [&]() {return compute_value_vectorized<ch_bubble>(w, cache->frequency(ivpp), i_in);});
+        }
+        else {
+            return compute_value_vectorized<ch_bubble>(w, vpp, i_in);
+        }
+    }
+
+    /// Prints the hit/miss statistics of the cache (if CACHE_BUBBLE_VALUES)
+    void print_cache_statistics() const {
+        if (cache) cache->print_statistics();
+    }
+
+private:
+    template<char ch_bubble>
+    auto compute_value_vectorized(const freqType w, const freqType vpp, const int i_in) const {
         if constexpr(KELDYSH) {
             //static_assert(KELDYSH, "vector-valued integrand only allowed for Keldysh formalism.");
             using result_type = Eigen::Matrix<Q, 4, 4>;
@@ -2,6 +2,10 @@
 #define KELDYSH_MFRG_BUBBLE_FUNCTION_HPP
 
 #include <cmath>                            // for using the macro M_PI as pi
+#include <atomic>                           // for counting the queued OMP tasks
+#include <numeric>                          // for std::iota
+#include <list>                             // for the results with pending MPI communication
+#include <omp.h>                            // for the OMP task pool used with dynamic MPI scheduling
 #include "../symmetries/Keldysh_symmetries.hpp"  // for independent Keldysh components and utilities
 #include "../correlation_functions/four_point/vertex.hpp"                         // vertex class
 #include "../correlation_functions/two_point/selfenergy.hpp"                     // self-energy class
@@ -47,8 +51,9 @@ class BubbleFunctionCalculator{
     Q prefactor = 1.;
 
     size_t number_of_nodes;
-    size_t mpi_size = mpi_world_size(); // number of mpi processes
-    size_t mpi_rank = mpi_world_rank(); // number of the current mpi process
+    const mpi_communicator comm;        // mpi processes sharing the computation of this bubble
+    size_t mpi_size = mpi_comm_size(comm); // number of mpi processes
+    size_t mpi_rank = mpi_comm_rank(comm); // number of the current mpi process
     std::array<std::size_t,my_defs::K1::rank> dimsK1; // number of vertex components over which i_mpi and i_omp are looped
     std::array<std::size_t,my_defs::K2::rank> dimsK2; // number of vertex components over which i_mpi and i_omp are looped
     std::array<std::size_t,my_defs::K3::rank> dimsK3; // number of vertex components over which i_mpi and i_omp are looped
@@ -60,36 +65,73 @@ class BubbleFunctionCalculator{
     int Nmin, Nmax; // Matsubara indices for minimal and maximal frequency. Only needed for finite-temperature Matsubara calculations!
 
     double tK1 = 0, tK2 = 0, tK3 = 0;
+    double t_busy = 0, t_idle = 0; // time spent on integrations / waiting for the other MPI processes (incl. communication)
+    static constexpr size_t chunks_per_process = 16; // dynamic MPI scheduling: average number of chunks fetched per MPI process
 
     std::array<bool,3> tobecomputed; // indicates whether classes K1, K2 and K3 are to be computed
 
+    /// Results of a diagrammatic class whose collection from all MPI processes is still in progress.
+    /// They are completed after all classes have been computed, such that the communication overlaps with the
+    /// computation of the following classes.
+    struct pending_result {
+        mpi_request request = MPI_REQUEST_NULL_HANDLE; // nothing to wait for while the results are computed
+        std::unique_ptr<mpi_gather_layout> layout;  // must not change until the request is completed
+        bool in_place = false;                      // true if the results are collected directly in dgamma
+        vec<Q> compact_result;                      // results of the symmetry-independent points (unless in_place),
+        vec<single_precision_t<Q>> compact_result_single; // in the precision in which dgamma stores them
+        std::vector<size_t> points;                 // flat indices of the points in compact_result
+        size_t n_vectorization = 1;
+        void (BubbleFunctionCalculator::*complete)(pending_result&); // writes the results into dgamma
+
+        /// compact results in the storage precision storage_type of dgamma
+        template<typename storage_type> vec<storage_type>& compact() {
+            if constexpr(std::is_same_v<storage_type, Q>) return compact_result;
+            else return compact_result_single;
+        }
+    };
+    std::list<pending_result> pending_results; // std::list: the buffers must not move while MPI is writing into them
+
     void check_presence_of_symmetry_related_contributions();
     void set_channel_specific_freq_ranges_and_prefactor();
     void find_vmin_and_vmax();
 
     template<K_class diag_class> void calculate_bubble_function();
-    template<K_class diag_class> value_type get_value(int i_mpi, int i_omp, int n_omp, int n_vectorization);
+    template<K_class diag_class> void calculate_bubble_function_dynamically(const std::vector<size_t>& points, size_t n_vectorization);
+    template<K_class diag_class> void calculate_bubble_function_statically(const std::vector<size_t>& points, size_t n_vectorization);
+    void report_load_balance();
+
+    void calculate_K3_on_fixed_nodes();
+    template<int spin> void calculate_K3_on_fixed_nodes(Q* result, int iw, int i_in);
+    void get_fixed_node_mesh(freqType w, vec<freqType>& nodes, vec<double>& weights) const;
+    double validate_K3_on_fixed_nodes(const Q* result_group, size_t iflat_first, size_t n_points, int n_samples, int& n_compared);
+
+    template<K_class diag_class> value_type get_value(size_t iflat, int n_vectorization);
     template<K_class diag_class,int spin> void calculate_value(value_type &value, int i0, int i_in, int iw, freqType w, freqType v, freqType vp);
 
-    void write_out_results(const vec<Q>& Ordered_result, K_class diag_class);
-    void write_out_results_K1(const vec<Q>& K1_ordered_result);
-    void write_out_results_K2(const vec<Q>& K2_ordered_result);
-    void write_out_results_K2b(const vec<Q>& K2b_ordered_result);
-    void write_out_results_K3(const vec<Q>& K3_ordered_result);
-
-    void set_external_arguments_for_parallelization(size_t& n_mpi, size_t& n_omp, size_t& n_vectorization, K_class diag_class);
-
-    void convert_external_MPI_OMP_indices_to_physical_indices_K1(int& iK1, int& i0, int& ispin, int& iw, int& i_in, freqType & w,
-                                                                 int i_mpi, int n_omp, int i_omp);
-    void convert_external_MPI_OMP_indices_to_physical_indices_K2(int& iK2, int& i0, int& ispin, int& iw, int& iv, int& i_in,
-                                                                 freqType& w, freqType& v,
-                                                                 int i_mpi, int n_omp, int i_omp);
-    void convert_external_MPI_OMP_indices_to_physical_indices_K2b(int& iK2, int& i0, int& ispin, int& iw, int& ivp, int& i_in,
-                                                                  freqType& w, freqType& vp,
-                                                                 int i_mpi, int n_omp, int i_omp);
-    void convert_external_MPI_OMP_indices_to_physical_indices_K3(int& iK3, int& i0, int& ispin, int& iw, int& iv, int& ivp, int& i_in,
-                                                                 freqType& w, freqType& v, freqType& vp,
-                                                                 int i_mpi, int n_omp, int i_omp);
+    template<K_class diag_class> void complete_result(pending_result& result);
+    void progress_pending_results();
+    void finish_pending_results();
+    template<K_class diag_class, typename storage_type> void scatter_results(const vec<storage_type>& Compact_result, const std::vector<size_t>& points, size_t n_vectorization);
+    void write_out_results(K_class diag_class);
+    void write_out_results_K1();
+    void write_out_results_K2();
+    void write_out_results_K3();
+
+    size_t get_n_vectorization(K_class diag_class);
+
+    void convert_flat_index_to_physical_indices_K1(int& i0, int& ispin, int& iw, int& i_in, freqType & w, size_t iK1);
+    void convert_flat_index_to_physical_indices_K2(int& i0, int& ispin, int& iw, int& iv, int& i_in,
+                                                   freqType& w, freqType& v, size_t iK2);
+    void convert_flat_index_to_physical_indices_K2b(int& i0, int& ispin, int& iw, int& ivp, int& i_in,
+                                                    freqType& w, freqType& vp, size_t iK2);
+    void convert_flat_index_to_physical_indices_K3(int& i0, int& ispin, int& iw, int& iv, int& ivp, int& i_in,
+                                                   freqType& w, freqType& v, freqType& vp, size_t iK3);
+
+    template<K_class diag_class> auto get_result_buffer() -> decltype(auto);
+    template<K_class diag_class> const std::vector<size_t>& get_iteration_space();
+    template<K_class diag_class> const std::vector<int>& get_freq_transformations() const;
+    template<K_class diag_class> int get_trafo_and_cost(size_t iflat, double& cost);
+    double estimate_cost(freqType w, freqType v, freqType vp) const;
 
     int get_trafo_K1(int i0, freqType w);
     int get_trafo_K2(int i0, freqType w, freqType v);
@@ -104,15 +146,22 @@ class BubbleFunctionCalculator{
     public:
     void perform_computation();
 
+    /// K3 is integrated on a fixed mesh of internal frequencies if possible (see K3_FIXED_NODE_QUADRATURE)
+    static constexpr bool fixed_node_quadrature_K3_supported = KELDYSH_FORMALISM and VECTORIZED_INTEGRATION
+                                                               and SWITCH_SUM_N_INTEGRAL and not SBE_DECOMPOSITION and GRID == 0;
+    static constexpr bool fixed_node_quadrature_K3 = K3_FIXED_NODE_QUADRATURE and fixed_node_quadrature_K3_supported;
+    double compare_K3_on_fixed_nodes(int iw, int n_samples);
+
     BubbleFunctionCalculator(vertexType_result& dgamma_in,
                              const vertexType_left& vertex1_in,
                              const vertexType_right& vertex2_in,
                              const Bubble_Object& Pi_in,
                              const int number_of_nodes_in,
-                             const std::array<bool,3> tobecomputed
+                             const std::array<bool,3> tobecomputed,
+                             const mpi_communicator comm_in = MPI_COMM_WORLD_HANDLE
                              )
                              :dgamma(dgamma_in), vertex1(vertex1_in), vertex2(vertex2_in),
-                             Pi(Pi_in), number_of_nodes(number_of_nodes_in), tobecomputed(tobecomputed){
+                             Pi(Pi_in), number_of_nodes(number_of_nodes_in), comm(comm_in), tobecomputed(tobecomputed){
 #if not  DEBUG_SYMMETRIES
         //check_presence_of_symmetry_related_contributions();
 #endif
@@ -245,6 +294,11 @@ BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexT
             //utils::get_time(t_start);
         }
     }
+    finish_pending_results();
+    if constexpr(MPI_DYNAMIC_SCHEDULING) report_load_balance();
+    if constexpr(CACHE_BUBBLE_VALUES and KELDYSH) {
+        if (VERBOSE) Pi.print_cache_statistics(); // accumulated over all bubbles computed with Pi so far
+    }
 
 }
 
@@ -256,52 +310,557 @@ BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexT
         Bubble_Object>::calculate_bubble_function(){
     if (diag_class < k1 || diag_class > k3){utils::print("Incompatible diagrammatic class! Abort."); assert(false); return;}
 
-    std::size_t n_mpi, n_omp, n_vectorization;
-    set_external_arguments_for_parallelization(n_mpi, n_omp, n_vectorization, diag_class);
+    const size_t n_vectorization = get_n_vectorization(diag_class);
 
-
-    // initialize buffer into which each MPI process writes their results
-    vec<Q> Buffer = mpi_initialize_buffer<Q>(n_mpi, n_omp * n_vectorization);
     vertex1.initializeInterpol();
     vertex2.initializeInterpol();
 
-    // start for-loop over external arguments, using MPI and OMP
-    int iterator = 0;
-    // total number of processes for MPI and OMP parallelization:
-    const int dimsKi_flat = diag_class == k1 ? dims_flat_K1 : (diag_class == k3 ? dims_flat_K3 : dims_flat_K2);
-    for (int i_mpi = 0; i_mpi < n_mpi; ++i_mpi) {
-        if (i_mpi % mpi_size == mpi_rank) {
-#pragma omp parallel for schedule(dynamic)
-            for (int i_omp = 0; i_omp < n_omp; ++i_omp) {
-                if (i_mpi * n_omp + i_omp < dimsKi_flat) {
-                    value_type value = get_value<diag_class>(i_mpi, i_omp, n_omp, n_vectorization);
-                    for (int k = 0; k < n_vectorization; k++) {
-                        Buffer[(iterator * n_omp + i_omp) * n_vectorization + k] = value[k]; // write result of integration into MPI buffer
+    if constexpr (fixed_node_quadrature_K3 and diag_class == k3) {
+        calculate_K3_on_fixed_nodes();
+    }
+    else {
+        // only the symmetry-independent points are distributed
+        const std::vector<size_t>& points = get_iteration_space<diag_class>();
+        if constexpr (MPI_DYNAMIC_SCHEDULING) {
+            calculate_bubble_function_dynamically<diag_class>(points, n_vectorization);
+        }
+        else {
+            calculate_bubble_function_statically<diag_class>(points, n_vectorization);
+        }
+    }
+
+    vertex1.set_initializedInterpol(false);
+    vertex2.set_initializedInterpol(false);
+
+}
+
+template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
+        typename vertexType_right, class Bubble_Object>
+template<K_class diag_class>
+void
+BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
+        Bubble_Object>::calculate_bubble_function_dynamically(const std::vector<size_t>& points, const size_t n_vectorization){
+    /// The list of points is cut into chunks which are handed out to the MPI processes on demand.
+    /// Within each MPI process, the master thread fetches the chunks and feeds their points into a pool of OMP tasks.
+    /// If the pool is full, the master thread computes points itself instead of fetching the next chunk
+    /// (only the master thread communicates via MPI).
+    /// Every MPI process writes its results to their final position in dgamma, the rest remains zero, such that the
+    /// results of all processes are summed up in place by MPI_Iallreduce. The results are collected in the precision
+    /// in which dgamma stores them (see K2_SINGLE_PRECISION and K3_SINGLE_PRECISION).
+    const double t_start = utils::get_time();
+
+    const size_t n_tasks = points.size();
+    pending_result& result = pending_results.emplace_back();
+    result.n_vectorization = n_vectorization;
+    result.complete = &BubbleFunctionCalculator::complete_result<diag_class>;
+
+    auto& destination = get_result_buffer<diag_class>();
+    using storage_type = std::remove_pointer_t<decltype(destination.storage_ptr())>;
+    result.in_place = std::remove_reference_t<decltype(destination)>::row_major_storage; // not if dgamma is tiled or stored only partially
+    const bool in_place = result.in_place;
+    storage_type* data;
+    size_t size;
+    if (in_place) {
+        destination.set_zero();
+        data = destination.storage_ptr();
+        size = destination.storage_size();
+        assert(size == n_vectorization * (diag_class == k1 ? dims_flat_K1 : (diag_class == k3 ? dims_flat_K3 : dims_flat_K2)));
+    }
+    else {
+        vec<storage_type>& compact_result = result.template compact<storage_type>();
+        compact_result = vec<storage_type> (n_tasks * n_vectorization);
+        result.points = points;
+        data = compact_result.data();
+        size = compact_result.size();
+    }
+    const size_t n_threads = omp_get_max_threads();
+    const size_t max_queued_tasks = 2 * n_threads;
+    const size_t chunk_size = std::max(n_threads, n_tasks / (chunks_per_process * mpi_size));
+    mpi_dynamic_scheduler scheduler(n_tasks, chunk_size, comm);
+
+    std::atomic<size_t> n_queued (0);
+    auto compute_point = [&](const size_t i_point) {
+        const value_type value = get_value<diag_class>(points[i_point], n_vectorization);
+        storage_type* const result_point = data + (in_place ? points[i_point] : i_point) * n_vectorization;
+        for (int k = 0; k < n_vectorization; k++) {
+            result_point[k] = static_cast<storage_type>(value[k]);
+        }
+    };
+#pragma omp parallel
+    {
+#pragma omp master
+        {
+            size_t begin, end;
+            while (scheduler.next_chunk(begin, end)) {
+                progress_pending_results();
+                for (size_t i_point = begin; i_point < end; ++i_point) {
+                    if (n_queued < max_queued_tasks) {
+                        ++n_queued;
+#pragma omp task firstprivate(i_point) shared(compute_point, n_queued)
+                        {
+                            compute_point(i_point);
+                            --n_queued;
+                        }
                     }
+                    else {
+                        compute_point(i_point);
+                    }
+                }
+            }
+        }
+    } // implicit barrier: all tasks of this process are finished here
+
+    result.request = mpi_iallreduce_sum(data, size, comm);
+    t_busy += utils::get_time() - t_start;
+}
+
+template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
+        typename vertexType_right, class Bubble_Object>
+template<K_class diag_class>
+void
+BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
+        Bubble_Object>::calculate_bubble_function_statically(const std::vector<size_t>& points, const size_t n_vectorization){
+    /// The points are split into one contiguous block per MPI process (in the order of their flat index), which is
+    /// computed using OMP. The blocks are then exchanged in place by MPI_Iallgatherv. If all points are independent,
+    /// the compact and the full iteration space coincide and the results are collected directly in dgamma.
+    /// The results are collected in the precision in which dgamma stores them.
+    const size_t n_points = points.size();
+    pending_result& pending = pending_results.emplace_back();
+    pending.points = points;
+    std::sort(pending.points.begin(), pending.points.end());
+    pending.layout = std::make_unique<mpi_gather_layout>(n_points, n_vectorization, comm);
+    pending.n_vectorization = n_vectorization;
+    pending.complete = &BubbleFunctionCalculator::complete_result<diag_class>;
+
+    auto& destination = get_result_buffer<diag_class>();
+    using storage_type = std::remove_pointer_t<decltype(destination.storage_ptr())>;
+    pending.in_place = n_points * n_vectorization == getFlatSize(destination.get_dims())
+                       and std::remove_reference_t<decltype(destination)>::row_major_storage; // not if dgamma is tiled or stored only partially
+    if (!pending.in_place) pending.template compact<storage_type>() = vec<storage_type> (n_points * n_vectorization);
+    storage_type* const result = pending.in_place ? destination.storage_ptr() : pending.template compact<storage_type>().data();
+    const std::vector<size_t>& points_ordered = pending.points;
+
+    const size_t first = pending.layout->first_task(mpi_rank);
+    const size_t last  = pending.layout->last_task(mpi_rank);
+#pragma omp parallel for schedule(dynamic)
+    for (size_t i_point = first; i_point < last; ++i_point) {
+        if (omp_get_thread_num() == 0) progress_pending_results(); // only the master thread communicates via MPI
+        value_type value = get_value<diag_class>(points_ordered[i_point], n_vectorization);
+        for (int k = 0; k < n_vectorization; k++) {
+            result[i_point * n_vectorization + k] = static_cast<storage_type>(value[k]);
+        }
+    }
+    pending.request = mpi_iallgatherv_in_place(result, *pending.layout);
+}
+
+template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
+        typename vertexType_right, class Bubble_Object>
+void
+BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
+        Bubble_Object>::calculate_K3_on_fixed_nodes(){
+    /// All K3 entries with the same spin and bosonic frequency w (a "group") share the internal frequency mesh.
+    /// The groups are contiguous in dgamma; they are distributed statically over the MPI processes and
+    /// exchanged in place by MPI_Iallgatherv. All points are computed, the symmetry-related ones are overwritten by
+    /// write_out_results() afterwards. Each group is computed in the precision Q and then converted to the precision in
+    /// which dgamma stores K3 (see K3_SINGLE_PRECISION), such that only one group is held in the precision Q.
+    const double t_start = utils::get_time();
+    const size_t n_groups = dimsK3[my_defs::K3::spin] * dimsK3[my_defs::K3::omega];
+    const size_t group_size = dims_flat_K3 / n_groups;
+    const int n_in = dimsK3[my_defs::K3::internal];
+
+    pending_result& pending = pending_results.emplace_back();
+    pending.layout = std::make_unique<mpi_gather_layout>(n_groups, group_size * n_vectorization_K3, comm);
+    pending.n_vectorization = n_vectorization_K3;
+    pending.complete = &BubbleFunctionCalculator::complete_result<k3>;
+
+    auto& destination = get_result_buffer<k3>();
+    using storage_type = std::remove_pointer_t<decltype(destination.storage_ptr())>;
+    storage_type* result = destination.storage_ptr();
+    pending.in_place = std::remove_reference_t<decltype(destination)>::row_major_storage;
+    if (!pending.in_place) {
+        // K3 is tiled or stored only partially: collect all results and write them into dgamma afterwards
+        pending.template compact<storage_type>() = vec<storage_type> (dims_flat_K3 * n_vectorization_K3);
+        pending.points.resize(dims_flat_K3);
+        std::iota(pending.points.begin(), pending.points.end(), 0);
+        result = pending.template compact<storage_type>().data();
+    }
+    const size_t first = pending.layout->first_task(mpi_rank);
+    const size_t last  = pending.layout->last_task(mpi_rank);
+    vec<Q> result_group (group_size * n_vectorization_K3);
+    for (size_t group = first; group < last; ++group) {
+        progress_pending_results();
+        const int ispin = group / nw3_w;
+        const int iw = group % nw3_w;
+        for (int i_in = 0; i_in < n_in; i_in++) {
+            if (ispin == 0 or n_spin == 1) calculate_K3_on_fixed_nodes<0>(result_group.data(), iw, i_in);
+            else                           calculate_K3_on_fixed_nodes<1>(result_group.data(), iw, i_in);
+        }
+        if (VERBOSE and group == first) {
+            constexpr int n_samples = 4;
+            int n_compared;
+            const double deviation = validate_K3_on_fixed_nodes(result_group.data(), first * group_size, group_size, n_samples, n_compared);
+            std::ostringstream report;
+            report << "K3 in channel " << channel << " on fixed nodes (" << K3_quadrature_nodes_per_panel
+                   << " per panel): max. deviation from adaptive integration at " << n_compared << " points on rank "
+                   << mpi_rank << ": " << deviation << " (rel)";
+            utils::print(report.str(), true);
+        }
+        storage_type* const destination_group = result + group * group_size * n_vectorization_K3;
+        for (size_t i = 0; i < result_group.size(); i++) destination_group[i] = static_cast<storage_type>(result_group[i]);
+    }
+
+    pending.request = mpi_iallgatherv_in_place(result, *pending.layout);
+    t_busy += utils::get_time() - t_start;
+}
+
+template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
+        typename vertexType_right, class Bubble_Object>
+template<int spin>
+void
+BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
+        Bubble_Object>::calculate_K3_on_fixed_nodes(Q* const result, const int iw, const int i_in){
+    /// The integrand factorizes as L(v, v'') * Pi(w, v'') * R(v'', v') (see Integrand::load_left_factor()).
+    /// On the fixed mesh v''_k with weights g_k, the K3 entries at w are given by the matrix product
+    ///     K3(v, v') = sum_k L(v, v''_k) [g_k Pi(w, v''_k) R(v''_k, v')],
+    /// where the Keldysh (and summed spin) indices are treated as blocks of the matrices.
+    using Integrand_class = Integrand<k3, channel, spin, Q, vertexType_left, vertexType_right, Bubble_Object, Eigen::Matrix<Q,4,4>>;
+    constexpr int n_block = 4 * Integrand_class::n_spin_sum_factorized;
+    const int n_in = dimsK3[my_defs::K3::internal];
+    const auto& frequencies = dgamma.get_rvertex(channel).K3.frequencies;
+
+    freqType w, v, vp;
+    frequencies.get_freqs_w(w, v, vp, iw, 0, 0);
+    vec<freqType> nodes;
+    vec<double> weights;
+    get_fixed_node_mesh(w, nodes, weights);
+    const int n_nodes = nodes.size();
+
+    Eigen::Matrix<Q, Eigen::Dynamic, Eigen::Dynamic> left (4 * nw3_v, n_block * n_nodes);
+    Eigen::Matrix<Q, Eigen::Dynamic, Eigen::Dynamic> right(n_block * n_nodes, 4 * nw3_v_p);
+#pragma omp parallel for schedule(dynamic)
+    for (int iv = 0; iv < nw3_v; iv++) {
+        freqType w_iv, v_iv, vp_iv;
+        frequencies.get_freqs_w(w_iv, v_iv, vp_iv, iw, iv, 0);
+        const Integrand_class integrand(vertex1, vertex2, Pi, 0, 0, channel=='a' ? iw : (channel=='p' ? iv : 0), w, v_iv, 0., i_in, 0, diff);
+        for (int k = 0; k < n_nodes; k++) {
+            left.template block<4, n_block>(4 * iv, n_block * k) = integrand.load_left_factor(nodes[k]);
+        }
+    }
+#pragma omp parallel for schedule(dynamic)
+    for (int ivp = 0; ivp < nw3_v_p; ivp++) {
+        freqType w_ivp, v_ivp, vp_ivp;
+        frequencies.get_freqs_w(w_ivp, v_ivp, vp_ivp, iw, 0, ivp);
+        const Integrand_class integrand(vertex1, vertex2, Pi, 0, 0, channel=='a' ? iw : (channel=='p' ? 0 : ivp), w, 0., vp_ivp, i_in, 0, diff);
+        for (int k = 0; k < n_nodes; k++) {
+            right.template block<n_block, 4>(n_block * k, 4 * ivp) = weights[k] * integrand.load_right_factor(nodes[k]);
+        }
+    }
+
+    const Eigen::Matrix<Q, Eigen::Dynamic, Eigen::Dynamic> K3_values = bubble_value_prefactor() * (left * right);
+
+    for (int iv = 0; iv < nw3_v; iv++) {
+        for (int ivp = 0; ivp < nw3_v_p; ivp++) {
+            Q* const value = result + ((iv * nw3_v_p + ivp) * n_in + i_in) * n_vectorization_K3;
+            for (int i = 0; i < 4; i++) {
+                for (int j = 0; j < 4; j++) {
+                    value[rotate_Keldysh_matrix<channel, true>(i * 4 + j)] = K3_values(4 * iv + i, 4 * ivp + j);
                 }
             }
-            ++iterator;
         }
     }
-    // collect+combine results from different MPI processes, reorder them appropriately
-    vec<Q> Result = mpi_initialize_result<Q> (n_mpi, n_omp * n_vectorization);
-    mpi_collect(Buffer, Result, n_mpi, n_omp * n_vectorization);
-    vec<Q> Ordered_result = mpi_reorder_result(Result, n_mpi, n_omp * n_vectorization);
+}
+
+template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
+        typename vertexType_right, class Bubble_Object>
+void
+BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
+        Bubble_Object>::get_fixed_node_mesh(const freqType w, vec<freqType>& nodes, vec<double>& weights) const {
+    /// Composite Gauss-Legendre rule in the auxiliary variable t of the fermionic K3 grid of the left vertex:
+    /// The panels are bounded by the auxiliary grid points and by the features of the bubble at v'' = +-w/2.
+    /// The tails t -> +-1 are included via the substitution t = +-(1 - u^2), which removes the singularity of the
+    /// integration measure dv''/dt.
+    const auto& grid = vertex1.get_rvertex(channel).K3.frequencies.get_freqGrid_f();
+    vec<double> boundaries = grid.get_all_auxiliary_gridpoints();
+    boundaries.push_back(grid.t_from_frequency( w / 2.));
+    boundaries.push_back(grid.t_from_frequency(-w / 2.));
+    boundaries.erase(std::remove_if(boundaries.begin(), boundaries.end(),
+                                    [](const double t) {return std::abs(t) >= 1.;}), boundaries.end());
+    std::sort(boundaries.begin(), boundaries.end());
+    boundaries.erase(std::unique(boundaries.begin(), boundaries.end(),
+                                 [](const double t1, const double t2) {return std::abs(t2 - t1) < 1e-12;}), boundaries.end());
+
+    vec<double> x, g;
+    gauss_legendre_rule(K3_quadrature_nodes_per_panel, x, g);
+    const size_t n = x.size();
+    nodes.clear();
+    weights.clear();
+    nodes.reserve(n * (boundaries.size() + 1));
+    weights.reserve(n * (boundaries.size() + 1));
+
+    // tails
+    const double u_lower = sqrt(1. + boundaries.front());
+    const double u_upper = sqrt(1. - boundaries.back());
+    for (size_t j = 0; j < n; j++) {
+        const double u = u_lower * 0.5 * (1. + x[j]);
+        const double t = -1. + u * u;
+        nodes.push_back(grid.frequency_from_t(t));
+        weights.push_back(u_lower * 0.5 * g[j] * 2. * u * integration_measure_v2(t, grid.W_scale));
+    }
+    for (size_t j = 0; j < n; j++) {
+        const double u = u_upper * 0.5 * (1. + x[j]);
+        const double t = 1. - u * u;
+        nodes.push_back(grid.frequency_from_t(t));
+        weights.push_back(u_upper * 0.5 * g[j] * 2. * u * integration_measure_v2(t, grid.W_scale));
+    }
+    // panels between the boundaries
+    for (size_t i = 0; i + 1 < boundaries.size(); i++) {
+        const double center = 0.5 * (boundaries[i + 1] + boundaries[i]);
+        const double half_width = 0.5 * (boundaries[i + 1] - boundaries[i]);
+        for (size_t j = 0; j < n; j++) {
+            const double t = center + half_width * x[j];
+            nodes.push_back(grid.frequency_from_t(t));
+            weights.push_back(half_width * g[j] * integration_measure_v2(t, grid.W_scale));
+        }
+    }
+}
+
+template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
+        typename vertexType_right, class Bubble_Object>
+double
+BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
+        Bubble_Object>::validate_K3_on_fixed_nodes(const Q* const result_group, const size_t iflat_first,
+                                                   const size_t n_points, const int n_samples, int& n_compared){
+    /// Compares the results of the fixed-node quadrature at a few symmetry-independent points of a group with the
+    /// adaptive integration. Returns the max. deviation relative to the max. value at these points.
+    double deviation = 0., norm = 0.;
+    n_compared = 0;
+    for (size_t i = 0; i < n_points and n_compared < n_samples; i += std::max<size_t>(1, n_points / (4 * n_samples))) {
+        const size_t iflat = iflat_first + i;
+        double cost;
+        if (get_trafo_and_cost<k3>(iflat, cost) != 0) continue;
+        const value_type value = get_value<k3>(iflat, n_vectorization_K3);
+        for (size_t k = 0; k < n_vectorization_K3; k++) {
+            deviation = std::max(deviation, std::abs(result_group[i * n_vectorization_K3 + k] - value[k]));
+            norm = std::max(norm, std::abs(value[k]));
+        }
+        n_compared++;
+    }
+    return norm > 0. ? deviation / norm : deviation;
+}
+
+template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
+        typename vertexType_right, class Bubble_Object>
+double
+BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
+        Bubble_Object>::compare_K3_on_fixed_nodes(const int iw, const int n_samples){
+    /// Integrates the K3 entries of spin 0 at the bosonic frequency index iw on the fixed mesh (without storing them
+    /// in dgamma) and compares them with the adaptive integration at n_samples symmetry-independent points.
+    /// Returns the max. deviation relative to the max. value at these points.
+    if constexpr (not fixed_node_quadrature_K3_supported) {
+        utils::print("K3 cannot be integrated on fixed nodes in this configuration.", true);
+        assert(false);
+        return 0.;
+    }
+    else {
+        const size_t n_groups = dimsK3[my_defs::K3::spin] * dimsK3[my_defs::K3::omega];
+        const size_t group_size = dims_flat_K3 / n_groups;
+        const int n_in = dimsK3[my_defs::K3::internal];
+        vec<Q> result_group (group_size * n_vectorization_K3);
+
+        vertex1.initializeInterpol();
+        vertex2.initializeInterpol();
+        for (int i_in = 0; i_in < n_in; i_in++) calculate_K3_on_fixed_nodes<0>(result_group.data(), iw, i_in);
+        int n_compared;
+        const double deviation = validate_K3_on_fixed_nodes(result_group.data(), iw * group_size, group_size, n_samples, n_compared);
+        vertex1.set_initializedInterpol(false);
+        vertex2.set_initializedInterpol(false);
+        return deviation;
+    }
+}
+
+template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
+        typename vertexType_right, class Bubble_Object>
+template<K_class diag_class>
+void
+BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
+        Bubble_Object>::complete_result(pending_result& result){
+    if (!result.in_place) {
+        using storage_type = std::remove_pointer_t<decltype(get_result_buffer<diag_class>().storage_ptr())>;
+        scatter_results<diag_class>(result.template compact<storage_type>(), result.points, result.n_vectorization);
+    }
+    write_out_results(diag_class);
+}
 
-    const int target_size_of_result = diag_class == k1 ? dims_flat_K1 * n_vectorization_K1 : (diag_class == k3 ? dims_flat_K3 * n_vectorization_K3 : dims_flat_K2 * n_vectorization_K2);
-#ifndef NDEBUG
-    const int current_size_of_result = Ordered_result.size();
-    for (int i = target_size_of_result; i < current_size_of_result; i++) {
-        assert(std::abs(Ordered_result[i]) < 1e-12);
+template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
+        typename vertexType_right, class Bubble_Object>
+void
+BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
+        Bubble_Object>::progress_pending_results(){
+    for (pending_result& result : pending_results) mpi_test(result.request);
+}
+
+template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
+        typename vertexType_right, class Bubble_Object>
+void
+BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
+        Bubble_Object>::finish_pending_results(){
+    // complete the results in the order in which they were computed
+    for (pending_result& result : pending_results) {
+        const double t_start = utils::get_time();
+        mpi_wait(result.request);
+        t_idle += utils::get_time() - t_start;
+        (this->*result.complete)(result);
     }
+    pending_results.clear();
+}
+
+template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
+        typename vertexType_right, class Bubble_Object>
+template<K_class diag_class, typename storage_type>
+void
+BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
+        Bubble_Object>::scatter_results(const vec<storage_type>& Compact_result, const std::vector<size_t>& points, const size_t n_vectorization){
+    // write the results into dgamma; the symmetry-related points are set to zero
+    auto& destination = get_result_buffer<diag_class>();
+    destination.set_zero();
+    for (size_t i_point = 0; i_point < points.size(); i_point++) {
+        for (int k = 0; k < n_vectorization; k++) {
+            destination.direct_set(points[i_point] * n_vectorization + k, static_cast<Q>(Compact_result[i_point * n_vectorization + k]));
+        }
+    }
+}
+
+template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
+        typename vertexType_right, class Bubble_Object>
+template<K_class diag_class>
+auto
+BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
+        Bubble_Object>::get_result_buffer() -> decltype(auto) {
+    if constexpr (diag_class == k1) return (dgamma.get_rvertex(channel).K1);
+    else if constexpr (diag_class == k2) return (dgamma.get_rvertex(channel).K2);
+#if DEBUG_SYMMETRIES
+    else if constexpr (diag_class == k2b) return (dgamma.get_rvertex(channel).K2b);
 #endif
-    // cut off superflous vector elements:
-    Ordered_result.resize(target_size_of_result);
-    write_out_results(Ordered_result, diag_class);
+    else return (dgamma.get_rvertex(channel).K3);
+}
 
-    vertex1.set_initializedInterpol(false);
-    vertex2.set_initializedInterpol(false);
+template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
+        typename vertexType_right, class Bubble_Object>
+template<K_class diag_class>
+const std::vector<size_t>&
+BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
+        Bubble_Object>::get_iteration_space(){
+    /// Returns the flat indices of all points which are not related to other points by symmetries, sorted by
+    /// decreasing estimated cost (such that expensive points are started first and the cheap ones fill the gaps).
+    /// The list only depends on the frequency grid and the frequency symmetries of the result vertex and is therefore
+    /// cached on the grid of the result vertex, keyed on the channel, the size and the symmetries.
+    const size_t dimsKi_flat = diag_class == k1 ? dims_flat_K1 : (diag_class == k3 ? dims_flat_K3 : dims_flat_K2);
+    const auto& frequencies = get_result_buffer<diag_class>().frequencies;
+    const std::vector<int>& freq_transformations = get_freq_transformations<diag_class>();
+    if (frequencies.has_iteration_space(channel, dimsKi_flat, freq_transformations)) return frequencies.iteration_space.points;
+
+    std::vector<size_t> points;
+    std::vector<double> cost;
+    points.reserve(dimsKi_flat);
+    cost.reserve(dimsKi_flat);
+    for (size_t iflat = 0; iflat < dimsKi_flat; iflat++) {
+        double cost_point;
+        if (get_trafo_and_cost<diag_class>(iflat, cost_point) == 0) {
+            points.push_back(iflat);
+            cost.push_back(cost_point);
+        }
+    }
 
+    std::vector<size_t> order (points.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](const size_t i, const size_t j) {return cost[i] > cost[j];});
+
+    auto& cache = frequencies.iteration_space;
+    cache.valid = true;
+    cache.channel = channel;
+    cache.flat_size = dimsKi_flat;
+    cache.freq_transformations = freq_transformations;
+    cache.points.resize(points.size());
+    cache.cost.resize(points.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        cache.points[i] = points[order[i]];
+        cache.cost[i] = cost[order[i]];
+    }
+    return cache.points;
+}
+
+template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
+        typename vertexType_right, class Bubble_Object>
+template<K_class diag_class>
+const std::vector<int>&
+BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
+        Bubble_Object>::get_freq_transformations() const {
+    /// Frequency symmetries which decide whether a point of diag_class is computed (see get_trafo_K1/K2/K3).
+    /// K2b has no symmetry-reduced sector, all its points are computed.
+    static const std::vector<int> no_transformations;
+    const auto& freq_transformations = dgamma.get_rvertex(channel).freq_transformations;
+    switch (diag_class) {
+        case k1: return freq_transformations.K1;
+        case k2: return freq_transformations.K2;
+        case k3: return freq_transformations.K3;
+        default: return no_transformations;
+    }
+}
+
+template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
+        typename vertexType_right, class Bubble_Object>
+template<K_class diag_class>
+int
+BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
+        Bubble_Object>::get_trafo_and_cost(const size_t iflat, double& cost){
+    int i0, ispin, iw, iv, ivp, i_in;
+    freqType w = 0, v = 0, vp = 0;
+    int trafo = 1;
+    switch (diag_class) {
+        case k1:
+            convert_flat_index_to_physical_indices_K1(i0, ispin, iw, i_in, w, iflat);
+            trafo = get_trafo_K1(i0, w);
+            break;
+        case k2:
+            convert_flat_index_to_physical_indices_K2(i0, ispin, iw, iv, i_in, w, v, iflat);
+            trafo = get_trafo_K2(i0, w, v);
+            break;
+#if DEBUG_SYMMETRIES
+        case k2b:
+            convert_flat_index_to_physical_indices_K2b(i0, ispin, iw, ivp, i_in, w, vp, iflat);
+            trafo = 0; // compute integrals for all frequency components
+            if (!KELDYSH and !ZERO_T and -vp + signFlipCorrection_MF(w)*0.5 < vertex1.avertex().K2b.frequencies.get_wlower_f()) {
+                trafo = -1;
+            }
+            break;
+#endif
+        case k3:
+            convert_flat_index_to_physical_indices_K3(i0, ispin, iw, iv, ivp, i_in, w, v, vp, iflat);
+            trafo = get_trafo_K3(i0, w, v, vp);
+            break;
+        default:;
+    }
+    cost = estimate_cost(w, v, vp);
+    return trafo;
+}
+
+template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
+        typename vertexType_right, class Bubble_Object>
+double
+BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
+        Bubble_Object>::estimate_cost(const freqType w, const freqType v, const freqType vp) const {
+    /// Rough estimate of the relative cost of an integration: The adaptive integrator has to resolve the features of the
+    /// integrand, which sit at v'' = +-w/2 (propagators) and v'' = +-v, +-vp (vertices). Every distinct feature
+    /// within the integration domain [vmin, vmax] adds one unit of cost.
+    std::array<freqType,6> features = {w/2, -w/2, v, -v, vp, -vp};
+    std::sort(features.begin(), features.end());
+    double cost = 1.;
+    for (size_t i = 0; i < features.size(); i++) {
+        const bool inside = features[i] > vmin and features[i] < vmax;
+        const bool distinct = i == 0 or features[i] - features[i-1] > Delta;
+        if (inside and distinct) cost += 1.;
+    }
+    return cost;
 }
 
 template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
@@ -309,15 +868,14 @@ template<char channel, typename Q, typename vertexType_result, typename vertexTy
 template<K_class diag_class>
 auto
 BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
-        Bubble_Object>::get_value(const int i_mpi, const int i_omp, const int n_omp, const int n_vectorization) -> value_type{
+        Bubble_Object>::get_value(const size_t iflat, const int n_vectorization) -> value_type{
     value_type value(n_vectorization);
-    int iK1, iK2, i0, ispin, iw, iv, ivp, i_in;
+    int i0, ispin, iw, iv, ivp, i_in;
     freqType w, v, vp;
     int trafo;
     switch (diag_class) {
         case k1:
-            convert_external_MPI_OMP_indices_to_physical_indices_K1(iK1, i0, ispin,iw, i_in, w,
-                                                                    i_mpi, n_omp, i_omp);
+            convert_flat_index_to_physical_indices_K1(i0, ispin, iw, i_in, w, iflat);
             trafo = get_trafo_K1(i0, w);
             if (trafo == 0) {
                 if (ispin == 0 or n_spin == 1)  calculate_value<diag_class,0>(value, i0, i_in, 0, w, 0, 0);
@@ -325,8 +883,7 @@ BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexT
             }
             break;
         case k2:
-            convert_external_MPI_OMP_indices_to_physical_indices_K2(iK2, i0, ispin, iw, iv, i_in, w, v,
-                                                                    i_mpi, n_omp, i_omp);
+            convert_flat_index_to_physical_indices_K2(i0, ispin, iw, iv, i_in, w, v, iflat);
             trafo = get_trafo_K2(i0, w, v);
             if (trafo == 0) {
                 if (ispin == 0 or n_spin == 1) calculate_value<diag_class,0>(value, i0, i_in, 0, w, v, 0);
@@ -334,8 +891,7 @@ BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexT
             break;
 #if DEBUG_SYMMETRIES
         case k2b:
-            convert_external_MPI_OMP_indices_to_physical_indices_K2b(iK2, i0, ispin, iw, ivp, i_in, w, vp,
-                                                                    i_mpi, n_omp, i_omp);
+            convert_flat_index_to_physical_indices_K2b(i0, ispin, iw, ivp, i_in, w, vp, iflat);
             trafo = 0; // compute integrals for all frequency components
             if (!KELDYSH and !ZERO_T and -vp + signFlipCorrection_MF(w)*0.5 < vertex1.avertex().K2b.frequencies.get_wlower_f()) {
                 trafo = -1;
@@ -347,8 +903,7 @@ BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexT
             break;
 #endif
         case k3:
-            convert_external_MPI_OMP_indices_to_physical_indices_K3(iK2, i0, ispin, iw, iv, ivp, i_in, w, v, vp,
-                                                                    i_mpi, n_omp, i_omp);
+            convert_flat_index_to_physical_indices_K3(i0, ispin, iw, iv, ivp, i_in, w, v, vp, iflat);
             trafo = get_trafo_K3(i0, w, v, vp);
             if (trafo == 0) {
                 if (ispin == 0 or n_spin == 1) calculate_value<diag_class,0>(value, i0, i_in, channel=='a' ? iw : (channel=='p' ? iv : ivp), w, v, vp);  // for 2D interpolation of K3 we need to know the index of the constant bosonic frequency w_r (r = channel of the bubble)
@@ -531,21 +1086,35 @@ template<char channel, typename Q, typename vertexType_result, typename vertexTy
         typename vertexType_right, class Bubble_Object>
 void
 BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
-        Bubble_Object>::write_out_results(const vec<Q>& Ordered_result, const K_class diag_class){
+        Bubble_Object>::report_load_balance(){
+    // collective call: all processes send their timings to rank 0
+    const vec<double> busy_times = mpi_gather_on_root(t_busy, comm);
+    const vec<double> idle_times = mpi_gather_on_root(t_idle, comm);
+    if (VERBOSE and mpi_rank == 0) {
+        std::ostringstream report;
+        report << "Load balance of bubble in channel " << channel << " (busy / idle in s):";
+        for (size_t i = 0; i < busy_times.size(); i++) {
+            report << "  rank " << i << ": " << busy_times[i] << " / " << idle_times[i];
+        }
+        utils::print(report.str(), true);
+    }
+}
+
+template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
+        typename vertexType_right, class Bubble_Object>
+void
+BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
+        Bubble_Object>::write_out_results(const K_class diag_class){
+    // the results of the symmetry-reduced sector have been collected in dgamma already
     switch (diag_class) {
         case k1:
-            write_out_results_K1(Ordered_result);
+            write_out_results_K1();
             break;
         case k2:
-            write_out_results_K2(Ordered_result);
+            write_out_results_K2();
             break;
-#if DEBUG_SYMMETRIES
-        case k2b:
-            write_out_results_K2b(Ordered_result);
-            break;
-#endif
         case k3:
-            write_out_results_K3(Ordered_result);
+            write_out_results_K3();
             break;
         default: ;
     }
@@ -556,8 +1125,7 @@ template<char channel, typename Q, typename vertexType_result, typename vertexTy
         typename vertexType_right, class Bubble_Object>
 void
 BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
-                Bubble_Object>::write_out_results_K1(const vec<Q>& K1_ordered_result){
-    dgamma.get_rvertex(channel).K1.set_vec(K1_ordered_result);
+                Bubble_Object>::write_out_results_K1(){
     if constexpr(not DEBUG_SYMMETRIES) {
         dgamma.initializeInterpol();     // initialize Interpolator with the symmetry-reduced sector of the vertex to retrieve all remaining entries
         dgamma.get_rvertex(channel).enforce_freqsymmetriesK1(dgamma.get_rvertex(channel));
@@ -569,32 +1137,18 @@ template<char channel, typename Q, typename vertexType_result, typename vertexTy
         typename vertexType_right, class Bubble_Object>
 void
 BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
-        Bubble_Object>::write_out_results_K2(const vec<Q>& K2_ordered_result){
-    //assert( K2_ordered_result.size() == nK_K2*n_spin*nBOS2*nFER2*n_in);
-    dgamma.get_rvertex(channel).K2.set_vec(K2_ordered_result);
+        Bubble_Object>::write_out_results_K2(){
     if constexpr(not DEBUG_SYMMETRIES) {
         dgamma.initializeInterpol();     // initialize Interpolator with the symmetry-reduced sector of the vertex to retrieve all remaining entries
         dgamma.get_rvertex(channel).enforce_freqsymmetriesK2(dgamma.get_rvertex(channel));
     }
 }
 
-#if DEBUG_SYMMETRIES
 template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
         typename vertexType_right, class Bubble_Object>
 void
 BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
-        Bubble_Object>::write_out_results_K2b(const vec<Q>& K2b_ordered_result){
-    //assert( K2b_ordered_result.size() == nK_K2*n_spin*nBOS2*nFER2*n_in);
-    dgamma.get_rvertex(channel).K2b.set_vec(K2b_ordered_result);
-}
-#endif
-
-template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
-        typename vertexType_right, class Bubble_Object>
-void
-BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
-        Bubble_Object>::write_out_results_K3(const vec<Q>& K3_ordered_result){
-    dgamma.get_rvertex(channel).K3.set_vec(K3_ordered_result);
+        Bubble_Object>::write_out_results_K3(){
     if constexpr(not DEBUG_SYMMETRIES) {
         dgamma.initializeInterpol();     // initialize Interpolator with the symmetry-reduced sector of the vertex to retrieve all remaining entries
         dgamma.get_rvertex(channel).enforce_freqsymmetriesK3(dgamma.get_rvertex(channel));
@@ -603,43 +1157,28 @@ BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexT
 
 template<char channel, typename Q, typename vertexType_result, typename vertexType_left,
         typename vertexType_right, class Bubble_Object>
-void
+size_t
 BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
-        Bubble_Object>::set_external_arguments_for_parallelization(size_t& n_mpi, size_t& n_omp, size_t& n_vectorization, const K_class diag_class){
+        Bubble_Object>::get_n_vectorization(const K_class diag_class){
 
     /// The computation of the vertex components of dgamma.Ki (i = 1, 2, 2', 3) can be parallelized
     /// parallelization is achieved via...
-    ///     ... MPI --> distribute over multiple nodes (n_mpi = maximal number of MPI processes)
-    ///     ... OMP --> distribute over multiple threads within the same node (n_omp = number of
+    ///     ... MPI --> distribute the symmetry-independent points over multiple nodes (see get_iteration_space())
+    ///     ... OMP --> distribute over multiple threads within the same node
     ///     ... vectorization --> use efficient matrix routines
     ///                           If vectorization is used (*this)->get_value() returns a vector with the components over which we vectorize
     ///                           and in (*this)->calculate_bubble_function() we need to loop over the remaining dimensions (these are given in dimsK1, dimsK2 and dimsK3)
 
-    const size_t nK_K1 = dimsK1[my_defs::K1::keldysh];
-    const size_t nK_K2 = dimsK2[my_defs::K2::keldysh];
-    const size_t nK_K3 = dimsK3[my_defs::K3::keldysh];
-
     switch (diag_class) {
         case k1:
-            // set external arguments for MPI-parallelization (# of tasks distributed via MPI)
-            n_mpi = number_of_nodes;
-            n_vectorization = n_vectorization_K1;
-            // set external arguments for OMP-parallelization (# of tasks per MPI-task distributed via OMP)
-            // below formula performs integer division with rounding up
-            n_omp = (dims_flat_K1 + n_mpi - 1) / n_mpi;
-            break;
+            return n_vectorization_K1;
         case k2:
         case k2b:
-            n_mpi = number_of_nodes;        // set external arguments for MPI-parallelization (# of tasks distributed via MPI)
-            n_vectorization = n_vectorization_K2;
-            n_omp = (dims_flat_K2 + n_mpi - 1) / n_mpi;
-            break;
+            return n_vectorization_K2;
         case k3:
-            n_mpi = number_of_nodes;        // set external arguments for MPI-parallelization (# of tasks distributed via MPI)
-            n_vectorization = n_vectorization_K3;
-            n_omp = (dims_flat_K3 + n_mpi - 1) / n_mpi;
-            break;
-        default: ;
+            return n_vectorization_K3;
+        default:
+            return 1;
     }
 }
 
@@ -647,10 +1186,8 @@ template<char channel, typename Q, typename vertexType_result, typename vertexTy
         typename vertexType_right, class Bubble_Object>
 void
 BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
-        Bubble_Object>::convert_external_MPI_OMP_indices_to_physical_indices_K1(int& iK1, int& i0, int& ispin, int& iw, int& i_in, freqType& w,
-                                                                                     const int i_mpi, const int n_omp, const int i_omp){
-    iK1 = i_mpi * n_omp + i_omp;
-
+        Bubble_Object>::convert_flat_index_to_physical_indices_K1(int& i0, int& ispin, int& iw, int& i_in, freqType& w,
+                                                                  const size_t iK1){
     my_defs::K1::index_type idx;
     getMultIndex<rank_K1>(idx, iK1, dimsK1);
     i0       = (int) idx[my_defs::K1::keldysh];
@@ -668,11 +1205,8 @@ template<char channel, typename Q, typename vertexType_result, typename vertexTy
         typename vertexType_right, class Bubble_Object>
 void
 BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
-        Bubble_Object>::convert_external_MPI_OMP_indices_to_physical_indices_K2(int& iK2, int& i0, int& ispin,  int& iw, int& iv, int& i_in,
-                                                                                freqType& w, freqType& v,
-                                                                                const int i_mpi, const int n_omp, const int i_omp){
-    iK2 = i_mpi * n_omp + i_omp;
-
+        Bubble_Object>::convert_flat_index_to_physical_indices_K2(int& i0, int& ispin,  int& iw, int& iv, int& i_in,
+                                                                  freqType& w, freqType& v, const size_t iK2){
     my_defs::K2::index_type idx;
     getMultIndex<rank_K2>(idx, iK2, dimsK2);
     i0       = (int) idx[my_defs::K2::keldysh];
@@ -691,11 +1225,8 @@ template<char channel, typename Q, typename vertexType_result, typename vertexTy
         typename vertexType_right, class Bubble_Object>
 void
 BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
-        Bubble_Object>::convert_external_MPI_OMP_indices_to_physical_indices_K2b(int& iK2, int& i0, int& ispin,  int& iw, int& ivp, int& i_in,
-                                                                                freqType& w, freqType& vp,
-                                                                                const int i_mpi, const int n_omp, const int i_omp){
-    iK2 = i_mpi * n_omp + i_omp;
-
+        Bubble_Object>::convert_flat_index_to_physical_indices_K2b(int& i0, int& ispin,  int& iw, int& ivp, int& i_in,
+                                                                   freqType& w, freqType& vp, const size_t iK2){
     my_defs::K2::index_type idx;
     getMultIndex<rank_K2>(idx, iK2, dimsK2);
     i0       = (int) idx[my_defs::K2b::keldysh];
@@ -714,11 +1245,8 @@ template<char channel, typename Q, typename vertexType_result, typename vertexTy
         typename vertexType_right, class Bubble_Object>
 void
 BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexType_right,
-        Bubble_Object>::convert_external_MPI_OMP_indices_to_physical_indices_K3(int& iK3, int& i0, int& ispin,  int& iw, int& iv, int& ivp, int& i_in,
-                                                                                freqType& w, freqType& v, freqType& vp,
-                                                                                     const int i_mpi, const int n_omp, const int i_omp){
-    iK3 = i_mpi * n_omp + i_omp;
-
+        Bubble_Object>::convert_flat_index_to_physical_indices_K3(int& i0, int& ispin,  int& iw, int& iv, int& ivp, int& i_in,
+                                                                  freqType& w, freqType& v, freqType& vp, const size_t iK3){
     my_defs::K3::index_type idx;
     getMultIndex<rank_K3>(idx, iK3, dimsK3);
     i0       = (int) idx[my_defs::K3::keldysh];
@@ -951,6 +1479,7 @@ BubbleFunctionCalculator<channel, Q, vertexType_result, vertexType_left, vertexT
  * @param channel Two-particle channel of the computation. Can be a, p, or t.
  * @param config Struct with essential parameters.
  * @param tobecomputed Array of three booleans, specifying what diagrammatic classes shall be computed.
+ * @param comm MPI processes that share the computation (all processes by default).
  */
 template <
         typename vertexType_result,
@@ -963,27 +1492,107 @@ void bubble_function(vertexType_result& dgamma,
                                  const Bubble_Object& Pi,
                                  const char channel,
                                  const fRG_config& config,
-                                 const std::array<bool,3> tobecomputed = {true,true,true}){
+                                 const std::array<bool,3> tobecomputed = {true,true,true},
+                                 const mpi_communicator comm = MPI_COMM_WORLD_HANDLE){
     using Q = typename vertexType_result::base_type;
     if (channel == 'a') {
         BubbleFunctionCalculator<'a', Q, vertexType_result, vertexType_left, vertexType_right, Bubble_Object>
-                BubbleComputer (dgamma, vertex1, vertex2, Pi, config.number_of_nodes,tobecomputed);
+                BubbleComputer (dgamma, vertex1, vertex2, Pi, config.number_of_nodes, tobecomputed, comm);
         BubbleComputer.perform_computation();
     }
     else if (channel == 'p') {
         BubbleFunctionCalculator<'p', Q, vertexType_result, vertexType_left, vertexType_right, Bubble_Object>
-                BubbleComputer (dgamma, vertex1, vertex2, Pi, config.number_of_nodes,tobecomputed);
+                BubbleComputer (dgamma, vertex1, vertex2, Pi, config.number_of_nodes, tobecomputed, comm);
         BubbleComputer.perform_computation();
     }
     else if (channel == 't') {
         BubbleFunctionCalculator<'t', Q, vertexType_result, vertexType_left, vertexType_right, Bubble_Object>
-                BubbleComputer (dgamma, vertex1, vertex2, Pi, config.number_of_nodes,tobecomputed);
+                BubbleComputer (dgamma, vertex1, vertex2, Pi, config.number_of_nodes, tobecomputed, comm);
         BubbleComputer.perform_computation();
     }
     //else {utils::print("Error! Incompatible channel given to bubble_function. Abort"); }
 
 }
 
+/**
+ * Heuristic for bubble_function_all_channels(): The channels are computed concurrently if a single channel has too
+ * few points to keep all threads of all MPI processes busy, i.e. fewer than min_bubble_points_per_thread per thread.
+ * @param dgamma Vertex that the result of the computation shall be written to (determines the number of points).
+ * @return bool True if the channels shall be computed concurrently on three groups of MPI processes.
+ */
+template <typename vertexType_result>
+bool compute_channels_concurrently(const vertexType_result& dgamma) {
+    if constexpr (not BUBBLE_CHANNELS_CONCURRENTLY or not MPI_FLAG) return false;
+    const size_t n_processes = mpi_world_size();
+    if (n_processes < 3) return false;
+
+    // points of the largest diagrammatic class; the Keldysh components of one point are integrated together
+    size_t n_points;
+    const size_t n_keldysh = KELDYSH and VECTORIZED_INTEGRATION ? 16 : 1;
+    if constexpr (MAX_DIAG_CLASS == 3) n_points = getFlatSize(dgamma.get_rvertex('a').K3.get_dims()) / n_keldysh;
+    else if constexpr (MAX_DIAG_CLASS == 2) n_points = getFlatSize(dgamma.get_rvertex('a').K2.get_dims()) / n_keldysh;
+    else n_points = getFlatSize(dgamma.get_rvertex('a').K1.get_dims()) / n_keldysh;
+
+    return n_points < (size_t) min_bubble_points_per_thread * n_processes * omp_get_max_threads();
+}
+
+/**
+ * Computes the bubbles in all three channels a, p and t, see bubble_function(). \n
+ * If compute_channels_concurrently() decides so, the MPI processes are split into three groups of (almost) equal
+ * size, one per channel, which compute their channel concurrently. Afterwards, every group sends the result of its
+ * channel to all other processes (all broadcasts are in flight at the same time).
+ * Otherwise, the channels are computed one after another by all MPI processes.
+ * Parameters as for bubble_function().
+ */
+template <
+        typename vertexType_result,
+        typename vertexType_left,
+        typename vertexType_right,
+        class Bubble_Object>
+void bubble_function_all_channels(vertexType_result& dgamma,
+                                  const vertexType_left& vertex1,
+                                  const vertexType_right& vertex2,
+                                  const Bubble_Object& Pi,
+                                  const fRG_config& config,
+                                  const std::array<bool,3> tobecomputed = {true,true,true}){
+    const std::array<char,3> channels = {'a', 'p', 't'};
+    if (not compute_channels_concurrently(dgamma)) {
+        for (const char r : channels) {
+            bubble_function(dgamma, vertex1, vertex2, Pi, r, config, tobecomputed);
+        }
+        return;
+    }
+
+    const int n_processes = mpi_world_size();
+    const int my_group = mpi_world_rank() * 3 / n_processes; // contiguous groups of world ranks
+    if (VERBOSE) utils::print("Computing the channels a, p, t concurrently on " + std::to_string(n_processes) + " MPI processes.", true);
+    mpi_communicator comm = mpi_split_world(my_group);
+    bubble_function(dgamma, vertex1, vertex2, Pi, channels[my_group], config, tobecomputed, comm);
+    mpi_free_communicator(comm);
+
+    using Q = typename vertexType_result::base_type;
+    std::vector<mpi_request> requests;
+    auto broadcast = [&](auto& buffer, const int root) {
+        auto* const data = buffer.storage_ptr(); // in the precision in which the buffer is stored
+        requests.push_back(mpi_ibroadcast(data, buffer.storage_size(), root));
+    };
+    for (int group = 0; group < 3; group++) {
+        const int root = (group * n_processes + 2) / 3; // lowest world rank of the group
+        auto& result = dgamma.get_rvertex(channels[group]);
+        if (MAX_DIAG_CLASS >= 1 and tobecomputed[0]) broadcast(result.K1, root);
+        if (MAX_DIAG_CLASS >= 2 and tobecomputed[1]) {
+            broadcast(result.K2, root);
+#if DEBUG_SYMMETRIES
+            broadcast(result.K2b, root);
+#endif
+        }
+        if (MAX_DIAG_CLASS >= 3 and tobecomputed[2]) broadcast(result.K3, root);
+    }
+    for (mpi_request& request : requests) mpi_wait(request);
+    // as after sequential computation: the interpolators have to know the data of all channels
+    if constexpr(not DEBUG_SYMMETRIES) dgamma.initializeInterpol();
+}
+
 /**
  * Overload of the bubble_function in case no Bubble object has been initialized yet.
  * @tparam Q Template parameter specifying the type of the data.
@@ -173,6 +173,32 @@ private:
      */
     auto operator() (freqType vpp) const -> return_type;
 
+    /**
+     * Batched call operator, used by the adaptive integrator (see Adapt):
+     * The propagators and the left and right vertices are interpolated for all frequencies of the batch in separate
+     * loops before the results are contracted, such that the setup of the vertex input is shared and subsequent
+     * interpolations access the same data.
+     * @param vpp : frequencies at which to evaluate the integrand
+     * @param n   : number of frequencies
+     * @param out : values of the integrand at the frequencies vpp
+     */
+    void evaluate_batch(const freqType* vpp, int n, return_type* out) const;
+
+    /// Number of spin components which are summed over in the factorized form of the integrand (see load_left_factor)
+    static constexpr int n_spin_sum_factorized = ((channel == 't' and spin == 0)
+#if DEBUG_SYMMETRIES
+                                                  or (channel == 'a' and spin == 1)
+#endif
+                                                 ) ? 2 : 1;
+    /**
+     * Factorized form of the integrand for the fixed-node quadrature of K3 (Keldysh, SWITCH_SUM_N_INTEGRAL, without
+     * SBE decomposition): The integrand at vpp equals load_left_factor(vpp) * load_right_factor(vpp).
+     * The left factor contains the left vertex (and only depends on w, v), the right factor contains the bubble and the
+     * right vertex (and only depends on w, vp). Spin sums are written as sums over blocks of the internal index.
+     */
+    auto load_left_factor(freqType vpp) const -> Eigen::Matrix<Q, 4, 4 * n_spin_sum_factorized>;
+    auto load_right_factor(freqType vpp) const -> Eigen::Matrix<Q, 4 * n_spin_sum_factorized, 4>;
+
     void save_integrand() const;
     void save_integrand(const rvec& freqs, const std::string& filename_prefix) const;
     void get_integrand_vals(const rvec& freqs, Eigen::Matrix<Q,Eigen::Dynamic,Eigen::Dynamic>& integrand_vals, Eigen::Matrix<Q,Eigen::Dynamic,Eigen::Dynamic>& Pivals, Eigen::Matrix<Q,Eigen::Dynamic,Eigen::Dynamic>& vertex_vals1, Eigen::Matrix<Q,Eigen::Dynamic,Eigen::Dynamic>& vertex_vals2)  const;
@@ -374,6 +400,119 @@ auto Integrand<diag_class, channel, spin, Q, vertexType_left, vertexType_right,
     return result;
 }
 
+template<K_class diag_class, char channel, int spin, typename Q, typename vertexType_left, typename vertexType_right, class Bubble_Object,typename return_type>
+void Integrand<diag_class, channel, spin, Q, vertexType_left, vertexType_right, Bubble_Object,return_type>::evaluate_batch(const freqType* vpp, const int n, return_type* out) const {
+#if SWITCH_SUM_N_INTEGRAL
+    if constexpr(KELDYSH and not SBE_DECOMPOSITION) {
+        // same contractions as in sum_over_internal_vectorized()
+        constexpr bool spin_sum = (channel == 't' and spin == 0)
+#if DEBUG_SYMMETRIES
+                                  or (channel == 'a' and spin == 1)
+#endif
+                                  ;
+        constexpr bool other_spin_right = DEBUG_SYMMETRIES and channel == 'p' and spin == 1;
+
+        using Pi_type = std::decay_t<decltype(Pi.template value_vectorized<channel>(input_external.w, vpp[0], input_external.i_in))>;
+        constexpr int chunk_size = 16; // fixed-size buffers, the adaptive integrator uses at most 13 frequencies at once
+        std::array<Pi_type, chunk_size> Pi_values;
+        std::array<buffer_type_vertex_l, chunk_size> values_vertex_l, values_vertex_l_other;
+        std::array<buffer_type_vertex_r, chunk_size> values_vertex_r, values_vertex_r_other;
+
+        VertexInput input_l = input_external, input_r = input_external;
+        input_l.iK = i0_left; input_r.iK = i0_right;
+        input_l.spin = 0;
+        input_r.spin = 0;
+
+        for (int first = 0; first < n; first += chunk_size) {
+            const int m = std::min(chunk_size, n - first);
+            for (int i = 0; i < m; i++) {
+                Pi_values[i] = Pi.template value_vectorized<channel>(input_external.w, vpp[first + i], input_external.i_in);
+            }
+            for (int i = 0; i < m; i++) {
+                input_l.v2 = vpp[first + i];
+                load_vertex_keldyshComponents_left_vectorized<spin>(values_vertex_l[i], input_l);
+                if constexpr(spin_sum) load_vertex_keldyshComponents_left_vectorized<1-spin>(values_vertex_l_other[i], input_l);
+            }
+            for (int i = 0; i < m; i++) {
+                input_r.v1 = vpp[first + i];
+                load_vertex_keldyshComponents_right_vectorized<spin>(values_vertex_r[i], input_r);
+                if constexpr(spin_sum or other_spin_right) load_vertex_keldyshComponents_right_vectorized<1-spin>(values_vertex_r_other[i], input_r);
+            }
+            for (int i = 0; i < m; i++) {
+                const auto result = [&]() {
+                    if constexpr(spin_sum) {
+                        return ((values_vertex_l[i] + values_vertex_l_other[i]) * Pi_values[i] * values_vertex_r[i]
+                               + values_vertex_l[i] * Pi_values[i] * (values_vertex_r[i] + values_vertex_r_other[i])).eval();
+                    }
+                    else if constexpr(other_spin_right) {
+                        return (values_vertex_l[i] * Pi_values[i] * values_vertex_r_other[i]).eval();
+                    }
+                    else {
+                        return (values_vertex_l[i] * Pi_values[i] * values_vertex_r[i]).eval();
+                    }
+                }();
+                if constexpr(VECTORIZED_INTEGRATION) out[first + i] = result;
+                else out[first + i] = result[0];
+            }
+        }
+        return;
+    }
+#endif
+    for (int i = 0; i < n; i++) out[i] = (*this)(vpp[i]);
+}
+
+template<K_class diag_class, char channel, int spin, typename Q, typename vertexType_left, typename vertexType_right, class Bubble_Object,typename return_type>
+auto Integrand<diag_class, channel, spin, Q, vertexType_left, vertexType_right, Bubble_Object,return_type>::load_left_factor(const freqType vpp) const -> Eigen::Matrix<Q, 4, 4 * n_spin_sum_factorized> {
+    static_assert(diag_class == k3 and KELDYSH and VECTORIZED_INTEGRATION and not SBE_DECOMPOSITION, "Factorized integrand only implemented for K3 with the vectorized Keldysh integrand without SBE decomposition.");
+    VertexInput input_l = input_external;
+    input_l.v2 = vpp;
+    input_l.iK = i0_left;
+    input_l.spin = 0;
+
+    buffer_type_vertex_l values_vertex_l;
+    load_vertex_keldyshComponents_left_vectorized<spin>(values_vertex_l, input_l);
+
+    Eigen::Matrix<Q, 4, 4 * n_spin_sum_factorized> result;
+    if constexpr(n_spin_sum_factorized == 2) {
+        // (l + l_other) * Pi * r + l * Pi * (r + r_other)
+        buffer_type_vertex_l values_vertex_l_other;
+        load_vertex_keldyshComponents_left_vectorized<1-spin>(values_vertex_l_other, input_l);
+        result << values_vertex_l + values_vertex_l_other, values_vertex_l;
+    }
+    else {
+        result = values_vertex_l;
+    }
+    return result;
+}
+
+template<K_class diag_class, char channel, int spin, typename Q, typename vertexType_left, typename vertexType_right, class Bubble_Object,typename return_type>
+auto Integrand<diag_class, channel, spin, Q, vertexType_left, vertexType_right, Bubble_Object,return_type>::load_right_factor(const freqType vpp) const -> Eigen::Matrix<Q, 4 * n_spin_sum_factorized, 4> {
+    static_assert(diag_class == k3 and KELDYSH and VECTORIZED_INTEGRATION and not SBE_DECOMPOSITION, "Factorized integrand only implemented for K3 with the vectorized Keldysh integrand without SBE decomposition.");
+    VertexInput input_r = input_external;
+    input_r.v1 = vpp;
+    input_r.iK = i0_right;
+    input_r.spin = 0;
+
+    const auto Pi_matrix = Pi.template value_vectorized<channel>(input_external.w, vpp, input_external.i_in);
+    buffer_type_vertex_r values_vertex_r;
+    Eigen::Matrix<Q, 4 * n_spin_sum_factorized, 4> result;
+    if constexpr(n_spin_sum_factorized == 2) {
+        buffer_type_vertex_r values_vertex_r_other;
+        load_vertex_keldyshComponents_right_vectorized<spin>(values_vertex_r, input_r);
+        load_vertex_keldyshComponents_right_vectorized<1-spin>(values_vertex_r_other, input_r);
+        result << Pi_matrix * values_vertex_r, Pi_matrix * (values_vertex_r + values_vertex_r_other);
+    }
+    else if constexpr(DEBUG_SYMMETRIES and channel == 'p' and spin == 1) {
+        load_vertex_keldyshComponents_right_vectorized<1-spin>(values_vertex_r, input_r);
+        result = Pi_matrix * values_vertex_r;
+    }
+    else {
+        load_vertex_keldyshComponents_right_vectorized<spin>(values_vertex_r, input_r);
+        result = Pi_matrix * values_vertex_r;
+    }
+    return result;
+}
+
 template<K_class diag_class, char channel, int spin, typename Q, typename vertexType_left, typename vertexType_right, class Bubble_Object,typename return_type>
 bool Integrand<diag_class,channel, spin, Q, vertexType_left, vertexType_right, Bubble_Object,return_type>::case_always_has_to_be_zero() const {
     bool zero_result = false;
@@ -1334,6 +1473,7 @@ void Integrand<diag_class,channel, spin, Q, vertexType_left, vertexType_right, B
     filename += + ".h5";
 
     if (mpi_world_rank() == 0) {
+        std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
         H5::H5File file(filename, H5F_ACC_TRUNC);
         write_to_hdf(file, "v", freqs, false);
         write_to_hdf(file, "integrand", integrand_vals, false);
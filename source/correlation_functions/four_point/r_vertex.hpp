@@ -8,6 +8,7 @@
 #include "../../symmetries/symmetry_table.hpp"           // table containing information when to apply which symmetry transformations
 #include "../../utilities/math_utils.hpp"
 #include "../../utilities/minimizer.hpp"
+#include "../../utilities/checkpoint_writer.hpp" // mutex for accesses to HDF5 files
 #include "../n_point/data_buffer.hpp"
 
 
@@ -31,7 +32,8 @@ public:
     using buffer_type_K1 = dataBuffer<Q, k1, K1p_config.rank, K1p_config.num_freqs, K1p_config.position_first_freq_index, freqGrid_type_K1, INTERPOLATION>;
     using buffer_type_K2 = dataBuffer<Q, k2, K2p_config.rank, K2p_config.num_freqs, K2p_config.position_first_freq_index, freqGrid_type_K2, INTERPOLATION>;
     using buffer_type_K2b= dataBuffer<Q, k2b,K2p_config.rank, K2p_config.num_freqs, K2p_config.position_first_freq_index, freqGrid_type_K2, INTERPOLATION>;
-    using buffer_type_K3 = dataBuffer<Q, k3, K3_config.rank, K3_config.num_freqs, K3_config.position_first_freq_index, freqGrid_type_K3, INTERPOLATION>;
+    using buffer_type_K3 = dataBuffer<Q, k3, K3_config.rank, K3_config.num_freqs, K3_config.position_first_freq_index, freqGrid_type_K3, INTERPOLATION, SYMMETRY_REDUCED_STORAGE and KELDYSH and not DEBUG_SYMMETRIES>;
+    using buffer_type_K3_expanded = dataBuffer<Q, k3, K3_config.rank, K3_config.num_freqs, K3_config.position_first_freq_index, freqGrid_type_K3, INTERPOLATION>; // holds all Keldysh components
     using buffer_type_K3_SBE= dataBuffer<Q, k3, K3_config.rank, K3_config.num_freqs, K3_config.position_first_freq_index, freqGrid_type_K2, INTERPOLATION>;
 
     char channel;                       // reducibility channel
@@ -62,7 +64,7 @@ public:
     mutable buffer_type_K3_SBE K3_SBE_symmetry_expanded;
 
     buffer_type_K3 K3;
-    mutable buffer_type_K3 K3_symmetry_expanded;
+    mutable buffer_type_K3_expanded K3_symmetry_expanded;
 
 
     /**
@@ -72,7 +74,7 @@ public:
      * @return returns this.
      */
     template <typename Func>
-    auto apply_unary_op_to_all_vertexBuffers(Func&& f) {
+    rvert<Q>& apply_unary_op_to_all_vertexBuffers(Func&& f) {
         if (MAX_DIAG_CLASS > 0) f(K1);
         if (MAX_DIAG_CLASS > 1) f(K2);
 #if DEBUG_SYMMETRIES
@@ -90,7 +92,7 @@ public:
      * @return returns this.
      */
     template <typename Func>
-    auto apply_unary_op_to_all_vertexBuffers(Func&& f) const {
+    const rvert<Q>& apply_unary_op_to_all_vertexBuffers(Func&& f) const {
         if (MAX_DIAG_CLASS > 0) f(K1);
         if (MAX_DIAG_CLASS > 1) f(K2);
 #if DEBUG_SYMMETRIES
@@ -109,7 +111,7 @@ public:
      * @return returns this
      */
     template <typename Func>
-    auto apply_binary_op_to_all_vertexBuffers(Func&& f, const rvert<Q>& other_rvert) {
+    rvert<Q>& apply_binary_op_to_all_vertexBuffers(Func&& f, const rvert<Q>& other_rvert) {
 
         if (MAX_DIAG_CLASS > 0) f(K1, other_rvert.K1);
         if (MAX_DIAG_CLASS > 1) f(K2, other_rvert.K2);
@@ -146,6 +148,9 @@ public:
 #if DEBUG_SYMMETRIES
             K2b = buffer_type_K2b(Lambda, channel_in == 'p' ? K2p_config.dims : K2at_config.dims, config);
 #endif
+            if constexpr(buffer_type_K3::has_index_subset) {
+                if (MAX_DIAG_CLASS >= 3) K3.set_stored_values(nonzero_Keldysh_components(k3));
+            }
         }
       };
     rvert() = delete;
@@ -155,6 +160,9 @@ public:
 
     mutable bool calculated_crossprojections = false;
 
+    /// Keldysh components of the diagrammatic class k which are not zero according to the symmetry table (for any spin)
+    auto nonzero_Keldysh_components(K_class k) const -> std::vector<my_index_t>;
+
     double max_norm() const;
 
     /**
@@ -324,21 +332,25 @@ public:
 
 
     // Arithmetric operators act on vertexBuffers:
-    auto operator+= (const rvert<Q>& rhs) -> rvert<Q> {
+    auto operator+= (const rvert<Q>& rhs) -> rvert<Q>& {
         return apply_binary_op_to_all_vertexBuffers([&](auto&& left, auto&& right) -> void {left += right;}, rhs);
     }
     friend rvert<Q> operator+ (rvert<Q> lhs, const rvert<Q>& rhs) {
         lhs += rhs;
         return lhs;
     }
-    auto operator*= (const rvert<Q>& rhs) -> rvert<Q> {
+    /// this += alpha * rhs without temporaries
+    auto axpy(const double alpha, const rvert<Q>& rhs) -> rvert<Q>& {
+        return apply_binary_op_to_all_vertexBuffers([&](auto&& left, auto&& right) -> void {left.axpy(alpha, right);}, rhs);
+    }
+    auto operator*= (const rvert<Q>& rhs) -> rvert<Q>& {
         return apply_binary_op_to_all_vertexBuffers([&](auto&& left, auto&& right) -> void {left *= right;}, rhs);
     }
     friend rvert<Q> operator* (rvert<Q> lhs, const rvert<Q>& rhs) {
         lhs *= rhs;
         return lhs;
     }
-    auto operator-= (const rvert<Q>& rhs) -> rvert<Q> {
+    auto operator-= (const rvert<Q>& rhs) -> rvert<Q>& {
         return apply_binary_op_to_all_vertexBuffers([&](auto&& left, auto&& right) -> void {left -= right;}, rhs);
     }
     friend rvert<Q> operator- (rvert<Q> lhs, const rvert<Q>& rhs) {
@@ -346,7 +358,7 @@ public:
         return lhs;
     }
     // Elementwise divion:
-    auto operator/= (const rvert<Q>& rhs) -> rvert<Q> {
+    auto operator/= (const rvert<Q>& rhs) -> rvert<Q>& {
         return apply_binary_op_to_all_vertexBuffers([&](auto&& left, auto&& right) -> void {left /= right;}, rhs);
     }
     friend rvert<Q> operator/ (rvert<Q> lhs, const rvert<Q>& rhs) {
@@ -354,14 +366,14 @@ public:
         return lhs;
     }
 
-    auto operator*= (double alpha) -> rvert<Q> {
+    auto operator*= (double alpha) -> rvert<Q>& {
         return apply_unary_op_to_all_vertexBuffers([&](auto &&buffer) -> void { buffer *= alpha; });
     }
     friend rvert<Q> operator* (rvert<Q> lhs, const double& rhs) {
         lhs *= rhs;
         return lhs;
     }
-    auto operator+= (double alpha) -> rvert<Q> {
+    auto operator+= (double alpha) -> rvert<Q>& {
         return apply_unary_op_to_all_vertexBuffers([&](auto &&buffer) -> void { buffer += alpha; });
     }
     friend rvert<Q> operator+ (rvert<Q> lhs, const double& rhs) {
@@ -797,6 +809,7 @@ template<typename Q> void rvert<Q>::check_symmetries(const std::string identifie
     }
     if (mpi_world_rank() == 0) {
         std::string filename = data_dir + "deviations_from_symmetry" + identifier + "_channel" + channel + ".h5";
+        std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
         H5::H5File file(filename.c_str(), H5F_ACC_TRUNC);
         write_to_hdf(file, "K1", deviations_K1, false);
         write_to_hdf(file, "K1_original", original_K1, false);
@@ -836,7 +849,7 @@ template<typename Q> template<char channel_bubble, bool is_left_vertex> void rve
     K1_symmetry_expanded = buffer_type_K1(0., K1_expanded_config.dims, fRG_config());
     K2_symmetry_expanded = buffer_type_K2(0., K2_expanded_config.dims, fRG_config());
     K2b_symmetry_expanded = buffer_type_K2b (0., K2_expanded_config.dims, fRG_config());
-    K3_symmetry_expanded = buffer_type_K3(0., K3_expanded_config.dims, fRG_config());
+    K3_symmetry_expanded = buffer_type_K3_expanded(0., K3_expanded_config.dims, fRG_config());
     if (spin == 0) {
         K1_symmetry_expanded.set_VertexFreqGrid(rvert_this.K1.get_VertexFreqGrid());
         K2_symmetry_expanded.set_VertexFreqGrid(rvert_this.K2.get_VertexFreqGrid());
@@ -972,6 +985,7 @@ template<typename Q> template<char channel_bubble, bool is_left_vertex> void rve
 
 
 template<typename Q> void rvert<Q>::save_expanded(const std::string& filename) const {
+    std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
     H5::H5File file = H5::H5File(filename, H5F_ACC_TRUNC);
     const std::string ch(1, channel);
     write_to_hdf(file, "K1" + ch, K1_symmetry_expanded .get_vec(), false);
@@ -1908,6 +1922,15 @@ template <typename Q> void rvert<Q>::enforce_freqsymmetriesK3(const rvert<Q>& ve
 }
 
 
+template<typename Q>
+auto rvert<Q>::nonzero_Keldysh_components(const K_class k) const -> std::vector<my_index_t> {
+    std::vector<my_index_t> result;
+    for (my_index_t iK = 0; iK < Components::K_dims[2]; iK++) {
+        if (components.K(k, 0, iK) >= 0 or components.K(k, 1, iK) >= 0) result.push_back(iK);
+    }
+    return result;
+}
+
 template<typename Q>
 double rvert<Q>::max_norm() const {
     double norm = 0.;
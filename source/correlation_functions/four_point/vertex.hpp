@@ -8,6 +8,7 @@
 #include "r_vertex.hpp"           // reducible vertex in channel r
 #include "../../utilities/minimizer.hpp"
 #include "../n_point/data_buffer.hpp"
+#include "../n_point/low_rank_buffer.hpp"
 
 /**************************** CLASSES FOR THE THREE REDUCIBLE AND THE IRREDUCIBLE VERTEX ******************************/
 
@@ -58,42 +59,46 @@ public:
     void set_vec(const buffer_type& bare_in) {bare = bare_in;}
 
     // Various operators for the irreducible vertex
-    auto operator+= (const irreducible<Q>& vertex) -> irreducible<Q> {
+    auto operator+= (const irreducible<Q>& vertex) -> irreducible<Q>& {
         this->bare +=vertex.bare;
         return *this;
     }
     friend irreducible<Q> operator+(irreducible<Q> lhs, const irreducible<Q>& rhs) {
         lhs += rhs; return lhs;
     }
-    auto operator-= (const irreducible<Q>& vertex) -> irreducible<Q> {
+    auto axpy(const double alpha, const irreducible<Q>& vertex) -> irreducible<Q>& {
+        this->bare.axpy(alpha, vertex.bare);
+        return *this;
+    }
+    auto operator-= (const irreducible<Q>& vertex) -> irreducible<Q>& {
         this->bare -=vertex.bare;
         return *this;
     }
     friend irreducible<Q> operator-(irreducible<Q> lhs, const irreducible<Q>& rhs) {
         lhs -= rhs; return lhs;
     }
-    auto operator+= (const double& alpha) -> irreducible<Q> {
+    auto operator+= (const double& alpha) -> irreducible<Q>& {
         this->bare +=alpha;
         return *this;
     }
     friend irreducible<Q> operator+(irreducible<Q> lhs, const double& rhs) {
         lhs += rhs; return lhs;
     }
-    auto operator*= (const double& alpha) -> irreducible<Q> {
+    auto operator*= (const double& alpha) -> irreducible<Q>& {
         this->bare *=alpha;
         return *this;
     }
     friend irreducible<Q> operator*(irreducible<Q> lhs, const double& rhs) {
         lhs *= rhs; return lhs;
     }
-    auto operator*= (const irreducible<Q>& vertex) -> irreducible<Q> {
+    auto operator*= (const irreducible<Q>& vertex) -> irreducible<Q>& {
         this->bare *= vertex.bare;
         return *this;
     }
     friend irreducible<Q> operator*(irreducible<Q> lhs, const irreducible<Q>& rhs) {
         lhs *= rhs; return lhs;
     }
-    auto operator/= (const irreducible<Q>& vertex) -> irreducible<Q> {
+    auto operator/= (const irreducible<Q>& vertex) -> irreducible<Q>& {
         //his->bare /= vertex.bare;
         return *this;
     }
@@ -356,7 +361,7 @@ public:
 
 
     // Various arithmetic operators for the fullvertex class
-    auto operator+= (const fullvert<Q>& vertex1) -> fullvert<Q> {
+    auto operator+= (const fullvert<Q>& vertex1) -> fullvert<Q>& {
         this->irred   += vertex1.irred;
         this->avertex += vertex1.avertex;
         this->pvertex += vertex1.pvertex;
@@ -367,7 +372,15 @@ public:
         lhs += rhs; // reuse compound assignment
         return lhs; // return the result by value (uses move constructor)
     }
-    auto operator+= (const double alpha) -> fullvert<Q> {
+    /// this += alpha * vertex1 without temporaries
+    auto axpy(const double alpha, const fullvert<Q>& vertex1) -> fullvert<Q>& {
+        this->irred  .axpy(alpha, vertex1.irred);
+        this->avertex.axpy(alpha, vertex1.avertex);
+        this->pvertex.axpy(alpha, vertex1.pvertex);
+        this->tvertex.axpy(alpha, vertex1.tvertex);
+        return *this;
+    }
+    auto operator+= (const double alpha) -> fullvert<Q>& {
         this->irred   += alpha;
         this->pvertex += alpha;
         this->tvertex += alpha;
@@ -378,7 +391,7 @@ public:
         lhs += rhs; // reuse compound assignment
         return lhs; // return the result by value (uses move constructor)
     }
-    auto operator*= (const fullvert<Q>& vertex1) -> fullvert<Q> {
+    auto operator*= (const fullvert<Q>& vertex1) -> fullvert<Q>& {
         this->irred   *= vertex1.irred;
         this->pvertex *= vertex1.pvertex;
         this->tvertex *= vertex1.tvertex;
@@ -389,7 +402,7 @@ public:
         lhs *= rhs; // reuse compound assignment
         return lhs; // return the result by value (uses move constructor)
     }
-    auto operator*= (const double& alpha) -> fullvert<Q> {
+    auto operator*= (const double& alpha) -> fullvert<Q>& {
         this->irred   *= alpha;
         this->pvertex *= alpha;
         this->tvertex *= alpha;
@@ -400,7 +413,7 @@ public:
         lhs *= rhs; // reuse compound assignment
         return lhs; // return the result by value (uses move constructor)
     }
-    auto operator-= (const fullvert<Q>& vertex1) -> fullvert<Q> {
+    auto operator-= (const fullvert<Q>& vertex1) -> fullvert<Q>& {
         this->irred   -= vertex1.irred;
         this->pvertex -= vertex1.pvertex;
         this->tvertex -= vertex1.tvertex;
@@ -413,7 +426,7 @@ public:
     }
 
     // Elementwise division (needed for error estimate of adaptive ODE solvers)
-    auto operator/= (const fullvert<Q>& vertex1) -> fullvert<Q> {
+    auto operator/= (const fullvert<Q>& vertex1) -> fullvert<Q>& {
         this->irred   /= vertex1.irred;
         this->avertex /= vertex1.avertex;
         this->pvertex /= vertex1.pvertex;
@@ -433,7 +446,9 @@ public:
     double get_curvature_max_K1(bool verbose) const;
     double get_curvature_max_K2(bool verbose) const;
     double get_curvature_max_K3(bool verbose) const;
+    double analyze_compression_K3(bool verbose) const;
     void check_vertex_resolution() const;
+    void print_page_placement() const;
 
     double analyze_tails_K1(bool verbose) const;
     double analyze_tails_K2w(bool verbose) const;
@@ -1114,7 +1129,7 @@ public:
     }
 
 public:
-    auto operator+= (const GeneralVertex<Q,symmtype,differentiated>& vertex1) -> GeneralVertex<Q,symmtype,differentiated> {
+    auto operator+= (const GeneralVertex<Q,symmtype,differentiated>& vertex1) -> GeneralVertex<Q,symmtype,differentiated>& {
         this->vertex += vertex1.vertex;
         if constexpr(symmtype==non_symmetric_diffleft or symmtype==non_symmetric_diffright) this->vertex_half2 += vertex1.vertex_half2;
         return *this;
@@ -1123,7 +1138,13 @@ public:
         lhs += rhs;
         return lhs;
     }
-    auto operator+= (const double alpha) -> GeneralVertex<Q,symmtype,differentiated> {
+    /// this += alpha * vertex1 without temporaries
+    auto axpy(const double alpha, const GeneralVertex<Q,symmtype,differentiated>& vertex1) -> GeneralVertex<Q,symmtype,differentiated>& {
+        this->vertex.axpy(alpha, vertex1.vertex);
+        if constexpr(symmtype==non_symmetric_diffleft or symmtype==non_symmetric_diffright) this->vertex_half2.axpy(alpha, vertex1.vertex_half2);
+        return *this;
+    }
+    auto operator+= (const double alpha) -> GeneralVertex<Q,symmtype,differentiated>& {
         this->vertex += alpha;
         if constexpr(symmtype==non_symmetric_diffleft or symmtype==non_symmetric_diffright) this->vertex_half2 += alpha;
         return *this;
@@ -1132,7 +1153,7 @@ public:
         lhs += rhs;
         return lhs;
     }
-    auto operator*= (const GeneralVertex<Q,symmtype,differentiated>& vertex1) -> GeneralVertex<Q,symmtype,differentiated> {
+    auto operator*= (const GeneralVertex<Q,symmtype,differentiated>& vertex1) -> GeneralVertex<Q,symmtype,differentiated>& {
         this->vertex *= vertex1.vertex;
         if constexpr(symmtype==non_symmetric_diffleft or symmtype==non_symmetric_diffright) this->vertex_half2 *= vertex1.vertex_half2;
         return *this;
@@ -1141,7 +1162,7 @@ public:
         lhs *= rhs;
         return lhs;
     }
-    auto operator*= (const double& alpha) -> GeneralVertex<Q,symmtype,differentiated> {
+    auto operator*= (const double& alpha) -> GeneralVertex<Q,symmtype,differentiated>& {
         this->vertex *= alpha;
         if constexpr(symmtype==non_symmetric_diffleft or symmtype==non_symmetric_diffright) this->vertex_half2 += alpha;
         return *this;
@@ -1150,7 +1171,7 @@ public:
         lhs *= rhs;
         return lhs;
     }
-    auto operator-= (const GeneralVertex<Q,symmtype,differentiated>& vertex1) -> GeneralVertex<Q,symmtype,differentiated> {
+    auto operator-= (const GeneralVertex<Q,symmtype,differentiated>& vertex1) -> GeneralVertex<Q,symmtype,differentiated>& {
         this->vertex -= vertex1.vertex;
         if constexpr(symmtype==non_symmetric_diffleft or symmtype==non_symmetric_diffright) this->vertex_half2 -= vertex1.vertex_half2;
         return *this;
@@ -1160,7 +1181,7 @@ public:
         return lhs;
     }
 
-    auto operator/= (const GeneralVertex<Q,symmtype,differentiated>& vertex1) -> GeneralVertex<Q,symmtype,differentiated> {
+    auto operator/= (const GeneralVertex<Q,symmtype,differentiated>& vertex1) -> GeneralVertex<Q,symmtype,differentiated>& {
         this->vertex /= vertex1.vertex;
         if constexpr(symmtype==non_symmetric_diffleft or symmtype==non_symmetric_diffright) this->vertex_half2 /= vertex1.vertex_half2;
         return *this;
@@ -1997,6 +2018,37 @@ template<typename Q> auto fullvert<Q>::get_curvature_max_K3(const bool verbose)
     return result;
 }
 
+/**
+ * Compresses K3 by truncated SVDs with the tolerance K3_LOW_RANK_TOLERANCE (see lowRankBuffer).
+ * @return maximal error of an element of K3 due to the compression, relative to the maximum of K3
+ */
+template<typename Q> auto fullvert<Q>::analyze_compression_K3(const bool verbose) const -> double {
+    vec<double> ratio (3);
+    vec<double> error_rel (3);
+    vec<double> max_rank (3);
+
+    int i = 0;
+    for (const rvert<Q>* rvertex : {&avertex, &pvertex, &tvertex}) {
+        const auto K3 = rvertex->K3.get_vec();
+        lowRankContainer<Q, K3_config.rank, K3_config.position_first_freq_index, typename rvert<Q>::freqGrid_type_K3> compressed;
+        compressed.compress(K3, K3_LOW_RANK_TOLERANCE);
+        const double maxmax = K3.max_norm();
+        ratio[i] = compressed.compression_ratio();
+        error_rel[i] = maxmax > 0. ? (compressed.get_vec() - K3).max_norm() / maxmax : 0.;
+        max_rank[i] = (double) compressed.max_rank();
+        i++;
+    }
+
+    if (verbose and mpi_world_rank()==0) {
+        std::cout << "compression of K3 by truncated SVDs in (v,vp) with rel. tolerance " << K3_LOW_RANK_TOLERANCE << " (ratio, rel. error, max. rank)" << std::endl;
+        std::cout << "\t a: \t" << ratio[0] << "\t" << error_rel[0] << "\t" << max_rank[0] << std::endl;
+        std::cout << "\t p: \t" << ratio[1] << "\t" << error_rel[1] << "\t" << max_rank[1] << std::endl;
+        std::cout << "\t t: \t" << ratio[2] << "\t" << error_rel[2] << "\t" << max_rank[2] << std::endl;
+    }
+
+    return error_rel.max_norm();
+}
+
 template <typename Q> void fullvert<Q>:: check_vertex_resolution() const {
     if (mpi_world_rank() == 0) {std::cout << "--> Check vertex resolution: " << std::endl;}
     get_deriv_max_K1(true);
@@ -2005,10 +2057,27 @@ template <typename Q> void fullvert<Q>:: check_vertex_resolution() const {
     get_curvature_max_K1(true);
     if (MAX_DIAG_CLASS>1) get_curvature_max_K2(true);
     if (MAX_DIAG_CLASS>2) get_curvature_max_K3(true);
+    if (MAX_DIAG_CLASS>2) analyze_compression_K3(true);
 
     /// TODO: dump state in file if certain thresholds are exceeded
 }
 
+/// Prints on which NUMA nodes the pages of the vertex data reside (see NUMA_FIRST_TOUCH)
+template <typename Q> void fullvert<Q>::print_page_placement() const {
+    if (mpi_world_rank() == 0) {std::cout << "--> Placement of the vertex data on NUMA nodes: " << std::endl;}
+    const auto print_buffer = [](const std::string& name, const auto& buffer) {
+        utils::print_page_placement(name, buffer.storage_ptr(), buffer.storage_size() * sizeof(*buffer.storage_ptr()));
+    };
+    const char channels[3] = {'a', 'p', 't'};
+    int i = 0;
+    for (const rvert<Q>* rvertex : {&avertex, &pvertex, &tvertex}) {
+        print_buffer(std::string("K1") + channels[i], rvertex->K1);
+        if (MAX_DIAG_CLASS > 1) print_buffer(std::string("K2") + channels[i], rvertex->K2);
+        if (MAX_DIAG_CLASS > 2) print_buffer(std::string("K3") + channels[i], rvertex->K3);
+        i++;
+    }
+}
+
 template<typename Q> auto fullvert<Q>::analyze_tails_K1(bool verbose) const -> double {
     vec<double> Ktails_rel (3);
 
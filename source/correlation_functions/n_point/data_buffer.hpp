@@ -93,79 +93,10 @@ public:
         {
 
 #ifdef DENSEGRID
-            result_type result;
-            if constexpr (std::is_same_v<result_type,Q>)
-            {
-                if constexpr(numberFrequencyDims == 1)
-                {
-                    result = interpolate_nearest1D<result_type>(frequencies[0],
-                                                                base_class::get_VertexFreqGrid().primary_grid,
-                                                                [&](int i) -> result_type {
-                                                                    indices[pos_first_freqpoint] = i;
-                                                                    return base_class::val(indices);
-                                                                });
-                }
-                else if constexpr(numberFrequencyDims == 2)
-                {
-                    result = interpolate_nearest2D<result_type>(frequencies[0], frequencies[1],
-                                                                base_class::get_VertexFreqGrid().primary_grid,
-                                                                base_class::get_VertexFreqGrid().secondary_grid,
-                                                                [&](int i, int j) -> result_type {
-                                                                    indices[pos_first_freqpoint] = i;
-                                                                    indices[pos_first_freqpoint + 1] = j;
-                                                                    return base_class::val(indices);
-                                                                });
-                }
-                else if constexpr(numberFrequencyDims == 3)
-                {
-                    result = interpolate_nearest3D<result_type>(frequencies[0], frequencies[1], frequencies[2],
-                                                                base_class::get_VertexFreqGrid().primary_grid,
-                                                                base_class::get_VertexFreqGrid().secondary_grid,
-                                                                base_class::get_VertexFreqGrid().tertiary_grid,
-                                                                [&](int i, int j, int l) -> result_type {
-                                                                    indices[pos_first_freqpoint] = i;
-                                                                    indices[pos_first_freqpoint + 1] = j;
-                                                                    indices[pos_first_freqpoint + 2] = l;
-                                                                    return base_class::val(indices);
-                                                                });
-                }
-            }
-            else {
-                if constexpr(numberFrequencyDims == 1)
-                {
-                    result << interpolate_nearest1D<Q>(frequencies[0],
-                                                                base_class::get_VertexFreqGrid().primary_grid,
-                                                                [&](int i) -> Q {
-                                                                    indices[pos_first_freqpoint] = i;
-                                                                    return base_class::val(indices);
-                                                                });
-                }
-                else if constexpr(numberFrequencyDims == 2)
-                {
-                    result << interpolate_nearest2D<Q>(frequencies[0], frequencies[1],
-                                                                base_class::get_VertexFreqGrid().primary_grid,
-                                                                base_class::get_VertexFreqGrid().secondary_grid,
-                                                                [&](int i, int j) -> Q {
-                                                                    indices[pos_first_freqpoint] = i;
-                                                                    indices[pos_first_freqpoint + 1] = j;
-                                                                    return base_class::val(indices);
-                                                                });
-                }
-                else if constexpr(numberFrequencyDims == 3)
-                {
-                    result << interpolate_nearest3D<Q>(frequencies[0], frequencies[1], frequencies[2],
-                                                                base_class::get_VertexFreqGrid().primary_grid,
-                                                                base_class::get_VertexFreqGrid().secondary_grid,
-                                                                base_class::get_VertexFreqGrid().tertiary_grid,
-                                                                [&](int i, int j, int l) -> Q {
-                                                                    indices[pos_first_freqpoint] = i;
-                                                                    indices[pos_first_freqpoint + 1] = j;
-                                                                    indices[pos_first_freqpoint + 2] = l;
-                                                                    return base_class::val(indices);
-                                                                });
-                }
-            }
-            return result;
+            if (not base_class::to_storage_index(indices)) return myzero<result_type>(); // element is not stored, i.e. zero
+            const Eigen::Matrix<Q, vecsize, 1> result = interpolate_nearest_strided<numberFrequencyDims, pos_first_freqpoint, vecsize>(base_class::data, indices, frequencies, base_class::get_VertexFreqGrid()).template cast<Q>();
+            if constexpr(std::is_same_v<result_type, Q>) return result[0];
+            else return result;
 #else
             // get weights from frequency Grid
             const weights_type weights = get_weights(frequencies, indices);
@@ -282,14 +213,14 @@ public:
                         const int index = base_class::frequencies.primary_grid.get_grid_index(w);
                         indices[pos_first_freqpoint] = index;
 
-                        Q result = 1.;
+                        double factor = 1.;
                         if (v <= -vmax) {
                             indices[pos_first_freqpoint + 1] = 0;
-                            result *= vmax * vmax / (v * v);
+                            factor *= vmax * vmax / (v * v);
                         }
                         else if (v >= vmax){
                             indices[pos_first_freqpoint + 1] = base_class::frequencies.secondary_grid.number_of_gridpoints - 1 + signFlipCorrection_MF_int(w) ;
-                            result *= vmax * vmax / (v * v);
+                            factor *= vmax * vmax / (v * v);
                         }
                         else {
                             const int index_v = base_class::frequencies.secondary_grid.get_grid_index(v);
@@ -297,11 +228,11 @@ public:
                         }
                         if (vp <= -vmax) {
                             indices[pos_first_freqpoint + 2] = 0;
-                            result *= vmax * vmax / (vp * vp);
+                            factor *= vmax * vmax / (vp * vp);
                         }
                         else if (vp >= vmax){
                             indices[pos_first_freqpoint + 2] = base_class::frequencies.secondary_grid.number_of_gridpoints - 1 + signFlipCorrection_MF_int(w) ;
-                            result *= vmax * vmax / (vp * vp);
+                            factor *= vmax * vmax / (vp * vp);
                         }
                         else {
                             const int index_vp = base_class::frequencies.secondary_grid.get_grid_index(vp);
@@ -309,11 +240,12 @@ public:
                         }
 
                         if constexpr (std::is_same_v<result_type,Q>) {
-                            result *= base_class::val(indices);
+                            const result_type result = factor * base_class::val(indices);
+                            return result;
                         } else {
-                            result *= base_class::template get_values<numberFrequencyDims, pos_first_freqpoint, vecsize, 1>(indices);
+                            const result_type result = factor * base_class::template get_values<numberFrequencyDims, pos_first_freqpoint, vecsize, 1>(indices);
+                            return result;
                         }
-                        return result;
 
                     }
 
@@ -328,8 +260,6 @@ public:
 
     };
 
-
-
 };
 
 template<typename Q, size_t rank, my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, typename dataContainer_type>
@@ -385,8 +315,6 @@ public:
 
     };
 
-
-
 };
 
 
@@ -482,22 +410,46 @@ namespace {
 
 
 
+/// Data type in which a buffer of the K_class k stores its data (see K2_SINGLE_PRECISION and K3_SINGLE_PRECISION).
+/// Buffers with cubic interpolation keep the data in full precision, since the splines are built on it.
+template <typename Q, K_class k, interpolMethod inter>
+using buffer_storage_type = std::conditional_t<inter != cubic and ((K2_SINGLE_PRECISION and (k == k2 or k == k2b)) or (K3_SINGLE_PRECISION and k == k3)), single_precision_t<Q>, Q>;
+
+/// Memory layout of the data of a buffer of the K_class k (see K3_TILED_LAYOUT). The splines assume the row-major layout.
+template <K_class k, my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, interpolMethod inter>
+using buffer_layout = std::conditional_t<K3_TILED_LAYOUT and k == k3 and inter != cubic,
+                                         multidimensional::tiled_layout<pos_first_freqpoint, numberFrequencyDims, K3_TILE_SIZE>,
+                                         multidimensional::row_major_layout>;
+
+/// Position of the index of which a buffer stores only a subset of values: the Keldysh index if symmetry_reduced
+/// (see SYMMETRY_REDUCED_STORAGE), otherwise -1. The splines assume that all values are stored.
+template <my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, interpolMethod inter, bool symmetry_reduced>
+constexpr int buffer_pos_index_subset = symmetry_reduced and inter != cubic ? (int)(pos_first_freqpoint + numberFrequencyDims) : -1;
+
 /**
  * Stores and interpolates data
- * @tparam Q                    type of data
+ * @tparam Q                    type of data (the data is stored as buffer_storage_type<Q,k,inter>, in the layout buffer_layout<...>)
  * @tparam k                    K_class selfenergy / k1 / k2 / k2b / k3
  * @tparam rank                 number of dimensions
  * @tparam numberFrequencyDims  number of frequency indices
  * @tparam pos_first_freqpoint  position of first frequency index
  * @tparam frequencyGrid_type   frequency grid
  * @tparam inter                interpolation method
+ * @tparam symmetry_reduced     if true, only the Keldysh components set by set_stored_values() are stored; the others are zero
  */
-template <typename Q, K_class k, size_t rank, my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, typename frequencyGrid_type, interpolMethod inter,
+template <typename Q, K_class k, size_t rank, my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, typename frequencyGrid_type, interpolMethod inter, bool symmetry_reduced = false,
         typename std::enable_if_t<(pos_first_freqpoint+numberFrequencyDims < rank) and (numberFrequencyDims <= 3), bool> = true>
-class dataBuffer: public Interpolator<Q, rank, numberFrequencyDims, pos_first_freqpoint, DataContainer<Q, rank, numberFrequencyDims, pos_first_freqpoint, frequencyGrid_type>, inter> {
-    using base_class = Interpolator<Q, rank, numberFrequencyDims, pos_first_freqpoint, DataContainer<Q, rank, numberFrequencyDims, pos_first_freqpoint, frequencyGrid_type>, inter>;
-    using this_class = dataBuffer<Q, k, rank, numberFrequencyDims, pos_first_freqpoint, frequencyGrid_type, inter>;
+class dataBuffer: public Interpolator<Q, rank, numberFrequencyDims, pos_first_freqpoint, DataContainer<Q, rank, numberFrequencyDims, pos_first_freqpoint, frequencyGrid_type, buffer_storage_type<Q,k,inter>, buffer_layout<k,numberFrequencyDims,pos_first_freqpoint,inter>, buffer_pos_index_subset<numberFrequencyDims,pos_first_freqpoint,inter,symmetry_reduced>>, inter> {
+    using base_class = Interpolator<Q, rank, numberFrequencyDims, pos_first_freqpoint, DataContainer<Q, rank, numberFrequencyDims, pos_first_freqpoint, frequencyGrid_type, buffer_storage_type<Q,k,inter>, buffer_layout<k,numberFrequencyDims,pos_first_freqpoint,inter>, buffer_pos_index_subset<numberFrequencyDims,pos_first_freqpoint,inter,symmetry_reduced>>, inter>;
+    using this_class = dataBuffer<Q, k, rank, numberFrequencyDims, pos_first_freqpoint, frequencyGrid_type, inter, symmetry_reduced>;
     using frequencies_type = std::array<freqType, numberFrequencyDims>;
+    using storage_type = buffer_storage_type<Q,k,inter>;
+
+    /// converts a real scalar to the precision of the stored data (for arithmetic with the data)
+    static auto to_storage_precision(const double x) {
+        if constexpr(std::is_same_v<storage_type, Q>) return x;
+        else return static_cast<typename Eigen::NumTraits<storage_type>::Real>(x);
+    }
 
 public:
     using index_type = typename base_class::index_type;
@@ -511,6 +463,7 @@ public:
         base_class::frequencies.  primary_grid.set_w_center(shifts[0]);
         base_class::frequencies.secondary_grid.set_w_center(shifts[1]);
         base_class::frequencies. tertiary_grid.set_w_center(shifts[2]);
+        base_class::frequencies.invalidate_iteration_space();
     }
 
     template<typename result_type=Q,
@@ -649,6 +602,7 @@ public:
     }
 
     void check_if_frequencyGrid_identical(const this_class &rhs) const {
+        assert(base_class::subset_slots == rhs.subset_slots); // the same elements have to be stored
 #if not defined(NDEBUG)
         if ((base_class::frequencies.primary_grid.get_all_frequencies() - rhs.frequencies.primary_grid.get_all_frequencies()).max_norm() > 1e-10) {
             throw std::runtime_error("Arithmetic operations involving databuffers with different frequency grids are forbidden.");
@@ -662,10 +616,12 @@ public:
 #endif
     }
 
-    auto operator+= (const this_class& rhs) -> this_class {check_if_frequencyGrid_identical(rhs); base_class::data += rhs.data; return *this;}
-    auto operator-= (const this_class& rhs) -> this_class {check_if_frequencyGrid_identical(rhs); base_class::data -= rhs.data; return *this;}
-    auto operator*= (const this_class& rhs) -> this_class {check_if_frequencyGrid_identical(rhs); base_class::data *= rhs.data; return *this;}
-    auto operator/= (const this_class& rhs) -> this_class {check_if_frequencyGrid_identical(rhs); base_class::data /= rhs.data; return *this;}
+    auto operator+= (const this_class& rhs) -> this_class& {check_if_frequencyGrid_identical(rhs); base_class::data += rhs.data; return *this;}
+    auto operator-= (const this_class& rhs) -> this_class& {check_if_frequencyGrid_identical(rhs); base_class::data -= rhs.data; return *this;}
+    auto operator*= (const this_class& rhs) -> this_class& {check_if_frequencyGrid_identical(rhs); base_class::data *= rhs.data; return *this;}
+    auto operator/= (const this_class& rhs) -> this_class& {check_if_frequencyGrid_identical(rhs); base_class::data /= rhs.data; return *this;}
+    /// this += alpha * rhs without temporaries
+    auto axpy(const double alpha, const this_class& rhs) -> this_class& {check_if_frequencyGrid_identical(rhs); base_class::data.axpy(to_storage_precision(alpha), rhs.data); return *this;}
     friend this_class operator+ (const this_class& lhs, const this_class& rhs) {
         this_class lhs_temp = lhs;
         lhs_temp += rhs;
@@ -688,10 +644,10 @@ public:
     }
 
 
-    auto operator+= (const double rhs) -> this_class {base_class::data += rhs; return *this;}
-    auto operator-= (const double rhs) -> this_class {base_class::data -= rhs; return *this;}
-    auto operator*= (const double rhs) -> this_class {base_class::data *= rhs; return *this;}
-    auto operator/= (const double rhs) -> this_class {base_class::data /= rhs; return *this;}
+    auto operator+= (const double rhs) -> this_class& {base_class::data += to_storage_precision(rhs); return *this;}
+    auto operator-= (const double rhs) -> this_class& {base_class::data -= to_storage_precision(rhs); return *this;}
+    auto operator*= (const double rhs) -> this_class& {base_class::data *= to_storage_precision(rhs); return *this;}
+    auto operator/= (const double rhs) -> this_class& {base_class::data /= to_storage_precision(rhs); return *this;}
     friend this_class operator+ (const this_class& lhs, const double rhs) {
         this_class lhs_temp = lhs;
         lhs_temp += rhs;
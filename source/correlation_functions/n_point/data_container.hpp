@@ -11,6 +11,7 @@
 #include "../../parameters/frequency_parameters.hpp"
 #include "../../grids/frequency_grid.hpp"
 #include "H5Cpp.h"
+#include <limits>
 
 template <typename Q> class rvert; // forward declaration of rvert
 template <typename Q, bool differentiated> class State; // forward declaration of State
@@ -24,10 +25,17 @@ void write_to_hdf(H5object& group, const H5std_string& dataset_name, const std::
 class Buffer;
 /**
  * Offers basic functionality that is identical for all K_classes
- * @tparam Q        data type of vertex data
- * @tparam rank     rank of data tensor
+ * @tparam Q            data type of vertex data
+ * @tparam rank         rank of data tensor
+ * @tparam storage_type data type in which the data is stored, e.g. single_precision_t<Q> to save memory.
+ *                      All accessors convert to and from Q, such that only the storage is affected.
+ * @tparam layout       memory layout of the data, e.g. multidimensional::tiled_layout for K3.
+ *                      Flat indices and get_vec() always refer to the row-major order (as in the HDF5 files).
+ * @tparam pos_index_subset position of an index of which only a subset of values is stored, e.g. the Keldysh index of
+ *                      a symmetry-reduced vertex (see set_stored_values()); -1 if all elements are stored.
+ *                      Indices and get_dims() always refer to the full range of this index.
  */
-    template<typename Q, std::size_t rank>
+    template<typename Q, std::size_t rank, typename storage_type = Q, typename layout = multidimensional::row_major_layout, int pos_index_subset = -1>
     class dataContainerBase {
         friend class State<Q,false>;
         friend class State<Q,true>;
@@ -36,16 +44,108 @@ class Buffer;
 
     protected:
         using buffer_type = multidimensional::multiarray<Q, rank>;
+        using storage_buffer_type = multidimensional::multiarray<storage_type, rank, layout>;
         using index_type = typename buffer_type::index_type;
         using dimensions_type = typename buffer_type::dimensions_type;
 
-        buffer_type data;
+        storage_buffer_type data;
+        /// for every value of the index at pos_index_subset: its position in the storage, or -1 if it is not stored
+        std::vector<int> subset_slots;
 
     public:
+        /// true if the data is stored in a different (lower) precision than Q
+        static constexpr bool reduced_precision = not std::is_same_v<Q, storage_type>;
+        /// true if only a subset of the values of the index at pos_index_subset is stored
+        static constexpr bool has_index_subset = pos_index_subset >= 0;
+        /// true if the data is stored exactly as buffer_type, i.e. in precision Q and row-major layout
+        static constexpr bool native_storage = not reduced_precision and layout::is_row_major and not has_index_subset;
+        /// true if the storage holds all elements in row-major order (possibly in reduced precision), i.e. position
+        /// iflat of storage_ptr() holds the element with the flat index iflat
+        static constexpr bool row_major_storage = layout::is_row_major and not has_index_subset;
+
+    protected:
+        /// position in the storage of elements which are not stored (see storage_index)
+        static constexpr size_t not_stored = std::numeric_limits<size_t>::max();
+
+        /// Stores all values of the index at pos_index_subset
+        void init_subset(const dimensions_type& dims) {
+            if constexpr(has_index_subset) {
+                subset_slots.resize(dims[pos_index_subset]);
+                for (size_t i = 0; i < subset_slots.size(); i++) subset_slots[i] = (int) i;
+            }
+        }
+        /// Dimensions of the storage for data with the dimensions dims
+        dimensions_type storage_dims(dimensions_type dims) const {
+            if constexpr(has_index_subset) {
+                dims[pos_index_subset] = 0;
+                for (const int slot : subset_slots) if (slot >= 0) dims[pos_index_subset]++;
+            }
+            return dims;
+        }
+        /// Translates a multiIndex into the storage; returns false if the element is not stored (and hence zero)
+        bool to_storage_index(index_type& idx) const {
+            if constexpr(has_index_subset) {
+                const int slot = subset_slots[idx[pos_index_subset]];
+                if (slot < 0) return false;
+                idx[pos_index_subset] = slot;
+            }
+            return true;
+        }
+
+        /// Converts values in the precision Q and row-major layout to the storage format
+        storage_buffer_type to_storage(const buffer_type& values) const {
+            if constexpr(layout::is_row_major and not has_index_subset) {
+                return storage_buffer_type(values.length(), typename storage_buffer_type::buffer_type(values.elements.template cast<storage_type>()));
+            }
+            else {
+                storage_buffer_type result(storage_dims(values.length()));
+                index_type idx;
+                for (size_t iflat = 0; iflat < values.size(); iflat++) {
+                    getMultIndex<rank>(idx, iflat, values.length());
+                    if (to_storage_index(idx)) result.at(idx) = static_cast<storage_type>(values.flat_at(iflat));
+                }
+                return result;
+            }
+        }
+        /// Converts the stored data to the precision Q and row-major layout
+        buffer_type from_storage() const {
+            if constexpr(layout::is_row_major and not has_index_subset) {
+                return buffer_type(data.length(), typename buffer_type::buffer_type(data.elements.template cast<Q>()));
+            }
+            else {
+                buffer_type result(get_dims());
+                index_type idx;
+                for (size_t iflat = 0; iflat < result.size(); iflat++) {
+                    getMultIndex<rank>(idx, iflat, result.length());
+                    if (to_storage_index(idx)) result.flat_at(iflat) = static_cast<Q>(data.at(idx));
+                }
+                return result;
+            }
+        }
+        /// Position of the element with the row-major flat index flatIndex in the storage (not_stored if it is not stored)
+        size_t storage_index(const size_t flatIndex) const {
+            if constexpr(layout::is_row_major and not has_index_subset) return flatIndex;
+            else {
+                index_type idx;
+                getMultIndex<rank>(idx, flatIndex, get_dims());
+                if (not to_storage_index(idx)) return not_stored;
+                if constexpr(layout::is_row_major) return getFlatIndex<rank>(idx, data.length());
+                else return layout::flat_index(idx, data.length());
+            }
+        }
+
+        /// Sets the data from values in the precision Q
+        void assign_data(const buffer_type& values) {
+            if constexpr(native_storage) data = values;
+            else data = to_storage(values);
+        }
+
+    public:
+
         /// constructor:
         dataContainerBase() = default;
 
-        explicit dataContainerBase(const dimensions_type dims) : data(dims) {};
+        explicit dataContainerBase(const dimensions_type dims) : data(dims) { init_subset(dims); };
 
         template<typename... Types,
                 typename std::enable_if_t<
@@ -53,61 +153,146 @@ class Buffer;
         explicit
         dataContainerBase(const Types &... dims) : dataContainerBase(index_type({static_cast<size_t>(dims)...})) {};
 
-        explicit dataContainerBase(const buffer_type &data_in) : buffer_type(data_in) {};
+        explicit dataContainerBase(const buffer_type &data_in) { init_subset(data_in.length()); assign_data(data_in); };
 
         /// Access data via flattened index.
         Q acc(const size_t flatIndex) const {
-            assert(flatIndex < data.size());
-            return data.flat_at(flatIndex);
+            const size_t i = storage_index(flatIndex);
+            if (has_index_subset and i == not_stored) return Q();
+            assert(i < data.size());
+            return static_cast<Q>(data.flat_at(i));
         }
 
         void direct_set(const size_t flatIndex, Q value) {
-            assert(flatIndex < data.size());
-            data.flat_at(flatIndex) = value;
+            const size_t i = storage_index(flatIndex);
+            if (has_index_subset and i == not_stored) {
+                assert(value == Q()); // elements which are not stored must be zero
+                return;
+            }
+            assert(i < data.size());
+            data.flat_at(i) = static_cast<storage_type>(value);
         }
 
         /// Returns value for a multiIndex
         template<typename... Types,
                 typename std::enable_if_t<
                         (sizeof...(Types) == rank) and (are_all_integral<size_t, Types...>::value), bool> = true>
-        Q val(const Types &... i) const { return data(i...); }
+        Q val(const Types &... i) const {
+            if constexpr(has_index_subset) return val(index_type({static_cast<my_index_t>(i)...}));
+            else return static_cast<Q>(data(i...));
+        }
 
-        Q val(const index_type &idx) const { return data.at(idx); }
+        Q val(const index_type &idx) const {
+            if constexpr(has_index_subset) {
+                index_type idx_storage = idx;
+                return to_storage_index(idx_storage) ? static_cast<Q>(data.at(idx_storage)) : Q();
+            }
+            else return static_cast<Q>(data.at(idx));
+        }
 
-        /// Returns reference to a value for a multiIndex
+        /// Returns reference to a value for a multiIndex (a copy if the data is stored in reduced precision or only partially)
         template<typename... Types,
                 typename std::enable_if_t<
                         (sizeof...(Types) == rank) and (are_all_integral<size_t, Types...>::value), bool> = true>
-        const Q &at(const Types &... i) const { return data.at(i...); }
+        decltype(auto) at(const Types &... i) const {
+            if constexpr(has_index_subset) return val(i...);
+            else if constexpr(reduced_precision) return static_cast<Q>(data.at(i...));
+            else return data.at(i...);
+        }
 
         template<std::size_t freqrank, std::size_t vecsize, typename... Types,
                 typename std::enable_if_t<(sizeof...(Types) == freqrank + pos_first_freq + 1) and
                                           (are_all_integral<size_t, Types...>::value), bool> = true>
         auto val_vectorized(const Types &... i) const -> Eigen::Matrix<Q, vecsize, 1> {
-            return data.template at_vectorized<vecsize>(i...);
+            if constexpr(has_index_subset) return val_vectorized<freqrank,vecsize>(index_type({static_cast<my_index_t>(i)...}));
+            else return data.template at_vectorized<vecsize>(i...).template cast<Q>();
         }
         template<std::size_t freqrank, std::size_t vecsize>
         auto val_vectorized(const index_type &idx) const -> Eigen::Matrix<Q, vecsize, 1> {
-            return data.template at_vectorized<vecsize>(idx);
+            if constexpr(has_index_subset) {
+                // the vectorized elements must not extend beyond one value of the partially stored index
+                assert(vecsize <= data.length_cumul()[pos_index_subset]);
+                index_type idx_storage = idx;
+                if (not to_storage_index(idx_storage)) return Eigen::Matrix<Q, vecsize, 1>::Zero();
+                return data.template at_vectorized<vecsize>(idx_storage).template cast<Q>();
+            }
+            else return data.template at_vectorized<vecsize>(idx).template cast<Q>();
         }
 
-        /// Sets a value at a multiIndex
+        /// Sets a value at a multiIndex (has no effect on elements which are not stored)
         template<typename... Types, typename std::enable_if_t<
                 (sizeof...(Types) == rank) and (are_all_integral<size_t, Types...>::value), bool> = true
         >
-        void setvert(const Q value, const Types &... i) { data.at(i...) = value; }
+        void setvert(const Q value, const Types &... i) {
+            if constexpr(has_index_subset) setvert(value, index_type({static_cast<my_index_t>(i)...}));
+            else data.at(i...) = static_cast<storage_type>(value);
+        }
 
-        void setvert(const Q value, const index_type &idx) { data.at(idx) = value; }
+        void setvert(const Q value, const index_type &idx) {
+            index_type idx_storage = idx;
+            if (to_storage_index(idx_storage)) data.at(idx_storage) = static_cast<storage_type>(value);
+            else assert(value == Q()); // elements which are not stored must be zero
+        }
 
         template<std::size_t vecsize>
         void setvert_vectorized(const Eigen::Matrix<Q, vecsize, 1>& value, const index_type &idx) {
-            data.template set_vectorized<vecsize>(value, idx);
+            if constexpr(has_index_subset) assert(vecsize <= data.length_cumul()[pos_index_subset]);
+            index_type idx_storage = idx;
+            if (to_storage_index(idx_storage)) data.template set_vectorized<vecsize>(value.template cast<storage_type>(), idx_storage);
+            else assert(value.isZero(0.)); // elements which are not stored must be zero
+        }
+
+        dimensions_type get_dims() const {
+            if constexpr(has_index_subset) {
+                dimensions_type dims = data.length();
+                dims[pos_index_subset] = subset_slots.size();
+                return dims;
+            }
+            else return data.length();
+        }
+
+        /// Number of elements which are actually stored (less than getFlatSize(get_dims()) if has_index_subset)
+        size_t storage_size() const { return data.size(); }
+
+        /**
+         * Stores only the values stored_values of the index at pos_index_subset. All other elements are zero and
+         * setting them has no effect. The data of the stored values is kept.
+         */
+        void set_stored_values(const std::vector<my_index_t>& stored_values) {
+            static_assert(has_index_subset, "Only containers with pos_index_subset >= 0 can store a subset of values.");
+            const buffer_type values = from_storage();
+            std::fill(subset_slots.begin(), subset_slots.end(), -1);
+            for (size_t slot = 0; slot < stored_values.size(); slot++) {
+                assert(stored_values[slot] < subset_slots.size());
+                subset_slots[stored_values[slot]] = (int) slot;
+            }
+            assign_data(values);
+        }
+        /// Returns true if the value i of the index at pos_index_subset is stored
+        bool is_stored_value(const my_index_t i) const {
+            if constexpr(has_index_subset) return subset_slots[i] >= 0;
+            else return true;
         }
 
-        auto get_dims() const { return data.length(); }
+        /// Returns the buffer "data" containing the data (a row-major copy converted to Q if the storage is not native)
+        decltype(auto) get_vec() const {
+            if constexpr(native_storage) return (data);
+            else return from_storage();
+        }
 
-        /// Returns the buffer "data" containing the data
-        const buffer_type &get_vec() const { return data; }
+        /// Returns a pointer to the raw data, e.g. to collect results of MPI processes directly into the buffer.
+        /// Returns nullptr if the data is stored in reduced precision or in a different layout (see storage_ptr).
+        Q* data_ptr() {
+            if constexpr(native_storage) return data.data();
+            else return nullptr;
+        }
+        /// Returns a pointer to the raw data in the storage precision and layout, e.g. to broadcast it via MPI.
+        /// The storage holds storage_size() elements.
+        storage_type* storage_ptr() { return data.data(); }
+        const storage_type* storage_ptr() const { return data.data(); }
+
+        /// Sets all elements of the buffer "data" to zero
+        void set_zero() { data = storage_buffer_type(data.length()); }
 
         /// Sets the the buffer "data"
         template<typename container,
@@ -116,18 +301,18 @@ class Buffer;
         >
 
         void set_vec(const container &data_in) {
-            assert(data.size() == data_in.size());
-            data = buffer_type(data.length(), data_in);
+            assert(getFlatSize(get_dims()) == data_in.size());
+            assign_data(buffer_type(get_dims(), data_in));
         }
 
         void set_vec(const buffer_type &data_in) {
-            assert(data.is_same_length(data_in));
-            data = data_in;
+            assert(get_dims() == data_in.length());
+            assign_data(data_in);
         }
 
         void set_vec(const buffer_type &&data_in) {
-            assert(data.is_same_length(data_in));
-            data = data_in;
+            assert(get_dims() == data_in.length());
+            assign_data(data_in);
         }
 
         /// Adds a vector to the data
@@ -137,33 +322,44 @@ class Buffer;
         >
 
         void add_vec(const container &summand) {
-            assert(data.size() == summand.size()); /// Check that summand has the right length
-            data += buffer_type(data.length(), summand);
+            assert(getFlatSize(get_dims()) == summand.size()); /// Check that summand has the right length
+            add_vec(buffer_type(get_dims(), summand));
         }
 
         void add_vec(const buffer_type &summand) {
-            assert(data.is_same_length(summand)); /// Check that summand has the right length
-            data += summand;
+            assert(get_dims() == summand.length()); /// Check that summand has the right length
+            if constexpr(layout::is_row_major and not has_index_subset) data += summand;
+            else data += to_storage(summand);
         }
 
         constexpr auto eigen_segment(const index_type &start, const index_type &end) {
+            static_assert(not has_index_subset, "Ranges of indices are not contiguous if only a subset of values is stored.");
             return data.eigen_segment(start, end);
         }
 
         constexpr auto eigen_segment(const index_type &start, const index_type &end) const {
+            static_assert(not has_index_subset, "Ranges of indices are not contiguous if only a subset of values is stored.");
             return data.eigen_segment(start, end);
         }
 
         template <my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, my_index_t vecsize, my_index_t sample_size>
         Eigen::Matrix<Q, vecsize, my_integer_pow<numberFrequencyDims>(sample_size)> get_values(const index_type& index) const {
-            return data.template get_values<numberFrequencyDims, pos_first_freqpoint, vecsize, sample_size>(index);
+            if constexpr(has_index_subset) {
+                // the partially stored index is not interpolated, i.e. the same value is read for all points of the stencil
+                static_assert(pos_index_subset >= (int)(pos_first_freqpoint + numberFrequencyDims), "The partially stored index must not be a frequency index.");
+                assert(vecsize <= data.length_cumul()[pos_index_subset]);
+                index_type index_storage = index;
+                if (not to_storage_index(index_storage)) return Eigen::Matrix<Q, vecsize, my_integer_pow<numberFrequencyDims>(sample_size)>::Zero();
+                return data.template get_values<numberFrequencyDims, pos_first_freqpoint, vecsize, sample_size>(index_storage).template cast<Q>();
+            }
+            else return data.template get_values<numberFrequencyDims, pos_first_freqpoint, vecsize, sample_size>(index).template cast<Q>();
         }
 
     };
 
 
-    template<typename Q, size_t rank, my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, typename frequencyGrid_type>
-    class DataContainer : public dataContainerBase<Q, rank> {
+    template<typename Q, size_t rank, my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, typename frequencyGrid_type, typename storage_type = Q, typename layout = multidimensional::row_major_layout, int pos_index_subset = -1>
+    class DataContainer : public dataContainerBase<Q, rank, storage_type, layout, pos_index_subset> {
         friend void test_PT4(double Lambda, bool write_flag);
 
         template<typename T>
@@ -178,7 +374,7 @@ class Buffer;
         friend State<state_datatype,false> read_state_from_hdf(const H5std_string &filename, const int Lambda_it);
 
     protected:
-        using base_class = dataContainerBase<Q, rank>;
+        using base_class = dataContainerBase<Q, rank, storage_type, layout, pos_index_subset>;
     public:
         using index_type = typename base_class::index_type;
         using dimensions_type = typename base_class::dimensions_type;
@@ -200,7 +396,7 @@ class Buffer;
                 >
         double analyze_tails(const int index = 0) const {
             double maxabs_total = base_class::data.max_norm();
-            vec<double> maxabs_along_w = maxabs(base_class::data, base_class::data.length(), pos_first_freqpoint+idim);
+            vec<double> maxabs_along_w = maxabs(base_class::get_vec(), base_class::get_dims(), pos_first_freqpoint+idim);
 
             const size_t number_of_frequency_points_along_w = base_class::get_dims()[pos_first_freqpoint+idim];
             return maxabs_along_w[number_of_frequency_points_along_w - 1 - index] / maxabs_total;
@@ -221,38 +417,38 @@ class Buffer;
         };
 
         buffer_type get_deriv_xx() const {
-            buffer_type inter_result = ::partial_deriv<Q,rank>(base_class::data, pos_first_freqpoint  );
+            buffer_type inter_result = ::partial_deriv<Q,rank>(base_class::get_vec(), pos_first_freqpoint  );
             buffer_type result       = ::partial_deriv<Q,rank>(inter_result    , pos_first_freqpoint  );
             return result;
         }
         buffer_type get_deriv_yy() const {
-            buffer_type inter_result = ::partial_deriv<Q,rank>(base_class::data, pos_first_freqpoint+1);
+            buffer_type inter_result = ::partial_deriv<Q,rank>(base_class::get_vec(), pos_first_freqpoint+1);
             buffer_type result       = ::partial_deriv<Q,rank>(inter_result    , pos_first_freqpoint+1);
             return result;
         }
         buffer_type get_deriv_zz() const {
-            buffer_type inter_result = ::partial_deriv<Q,rank>(base_class::data, pos_first_freqpoint+2);
+            buffer_type inter_result = ::partial_deriv<Q,rank>(base_class::get_vec(), pos_first_freqpoint+2);
             buffer_type result       = ::partial_deriv<Q,rank>(inter_result    , pos_first_freqpoint+2);
             return result;
         }
         buffer_type get_deriv_xy() const {
-            buffer_type inter_result = ::partial_deriv<Q,rank>(base_class::data, pos_first_freqpoint+1);
+            buffer_type inter_result = ::partial_deriv<Q,rank>(base_class::get_vec(), pos_first_freqpoint+1);
             buffer_type result       = ::partial_deriv<Q,rank>(inter_result    , pos_first_freqpoint  );
             return result;
         }
         buffer_type get_deriv_xz() const {
-            buffer_type inter_result = ::partial_deriv<Q,rank>(base_class::data, pos_first_freqpoint+2);
+            buffer_type inter_result = ::partial_deriv<Q,rank>(base_class::get_vec(), pos_first_freqpoint+2);
             buffer_type result       = ::partial_deriv<Q,rank>(inter_result    , pos_first_freqpoint  );
             return result;
         }
         buffer_type get_deriv_yz() const {
-            buffer_type inter_result = ::partial_deriv<Q,rank>(base_class::data, pos_first_freqpoint+1);
+            buffer_type inter_result = ::partial_deriv<Q,rank>(base_class::get_vec(), pos_first_freqpoint+1);
             buffer_type result       = ::partial_deriv<Q,rank>(inter_result    , pos_first_freqpoint+2);
             return result;
         }
 
         buffer_type get_deriv_xyz() const {
-            buffer_type inter_result = ::partial_deriv<Q,rank>(base_class::data, pos_first_freqpoint+2);
+            buffer_type inter_result = ::partial_deriv<Q,rank>(base_class::get_vec(), pos_first_freqpoint+2);
             buffer_type inter_result2= ::partial_deriv<Q,rank>(inter_result    , pos_first_freqpoint+1);
             buffer_type result       = ::partial_deriv<Q,rank>(inter_result2   , pos_first_freqpoint  );
             return result;
@@ -261,7 +457,7 @@ class Buffer;
         auto get_deriv_max() const -> double {
             if constexpr (numberFrequencyDims == 1) {
                 double Kmax = base_class::get_vec().max_norm();
-                const buffer_type deriv = get_deriv_x(base_class::data);
+                const buffer_type deriv = get_deriv_x(base_class::get_vec());
                 const vec<Q> deriv_vec = vec<Q>(deriv.begin(), deriv.end());
                 double max = (::power2(deriv_vec * (1/Kmax))
                 ).max_norm();
@@ -269,16 +465,16 @@ class Buffer;
             }
             else if constexpr (numberFrequencyDims == 2) {
                 double Kmax = base_class::get_vec().max_norm();
-                double max_K2 = (  ::power2(get_deriv_y(base_class::data) * (1/Kmax))
-                                 + ::power2(get_deriv_x(base_class::data) * (1/Kmax))
+                double max_K2 = (  ::power2(get_deriv_y(base_class::get_vec()) * (1/Kmax))
+                                 + ::power2(get_deriv_x(base_class::get_vec()) * (1/Kmax))
                 ).max_norm();
                 return max_K2;
             }
             else if constexpr (numberFrequencyDims == 3) {
                 double Kmax = base_class::get_vec().max_norm();
-                double max_K3 = (  ::power2(get_deriv_z(base_class::data) * (1/Kmax))
-                                 + ::power2(get_deriv_y(base_class::data) * (1/Kmax))
-                                 + ::power2(get_deriv_x(base_class::data) * (1/Kmax))
+                double max_K3 = (  ::power2(get_deriv_z(base_class::get_vec()) * (1/Kmax))
+                                 + ::power2(get_deriv_y(base_class::get_vec()) * (1/Kmax))
+                                 + ::power2(get_deriv_x(base_class::get_vec()) * (1/Kmax))
                 ).max_norm();
                 return max_K3;
             }
@@ -296,7 +492,7 @@ class Buffer;
             else if constexpr (numberFrequencyDims == 2) {
                 const double Kmax = base_class::get_vec().max_norm();
                 const buffer_type curvature_xx = get_deriv_xx();
-                const buffer_type deriv_y = get_deriv_y(base_class::data);
+                const buffer_type deriv_y = get_deriv_y(base_class::get_vec());
                 const buffer_type curvature_yy = get_deriv_y(deriv_y);
                 const buffer_type curvature_xy = get_deriv_x(deriv_y);
 
@@ -309,10 +505,10 @@ class Buffer;
             else if constexpr (numberFrequencyDims == 3) {
                 double Kmax = base_class::get_vec().max_norm();
                 const buffer_type curvature_xx = get_deriv_xx();
-                const buffer_type deriv_y = get_deriv_y(base_class::data);
+                const buffer_type deriv_y = get_deriv_y(base_class::get_vec());
                 const buffer_type curvature_yy = get_deriv_y(deriv_y);
                 const buffer_type curvature_xy = get_deriv_x(deriv_y);
-                const buffer_type deriv_z = get_deriv_z(base_class::data);
+                const buffer_type deriv_z = get_deriv_z(base_class::get_vec());
                 const buffer_type curvature_zz = get_deriv_z(deriv_z);
                 const buffer_type curvature_xz = get_deriv_x(deriv_z);
                 const buffer_type curvature_yz = get_deriv_y(deriv_z);
@@ -372,28 +568,29 @@ class Buffer;
 
 
 
-    template<typename Q, size_t rank, my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, typename frequencyGrid_type>
-    auto DataContainer<Q, rank, numberFrequencyDims, pos_first_freqpoint, frequencyGrid_type>::get_VertexFreqGrid() const -> const frequencyGrid_type& {
+    template<typename Q, size_t rank, my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, typename frequencyGrid_type, typename storage_type, typename layout, int pos_index_subset>
+    auto DataContainer<Q, rank, numberFrequencyDims, pos_first_freqpoint, frequencyGrid_type, storage_type, layout, pos_index_subset>::get_VertexFreqGrid() const -> const frequencyGrid_type& {
         return frequencies;
     }
 
 
-    template<typename Q, size_t rank, my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, typename frequencyGrid_type>
-    void DataContainer<Q, rank, numberFrequencyDims, pos_first_freqpoint, frequencyGrid_type>::set_VertexFreqGrid(const frequencyGrid_type frequencyGrid) {
+    template<typename Q, size_t rank, my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, typename frequencyGrid_type, typename storage_type, typename layout, int pos_index_subset>
+    void DataContainer<Q, rank, numberFrequencyDims, pos_first_freqpoint, frequencyGrid_type, storage_type, layout, pos_index_subset>::set_VertexFreqGrid(const frequencyGrid_type frequencyGrid) {
         frequencies = frequencyGrid;
+        frequencies.invalidate_iteration_space();
     }
 
 
 
 
 
-    template<typename Q, size_t rank, my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, typename frequencyGrid_type>
-    auto DataContainer<Q, rank, numberFrequencyDims, pos_first_freqpoint, frequencyGrid_type>::shrink_freq_box(const double rel_tail_threshold, const bool verbose, const double constant) const -> frequencyGrid_type {
+    template<typename Q, size_t rank, my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, typename frequencyGrid_type, typename storage_type, typename layout, int pos_index_subset>
+    auto DataContainer<Q, rank, numberFrequencyDims, pos_first_freqpoint, frequencyGrid_type, storage_type, layout, pos_index_subset>::shrink_freq_box(const double rel_tail_threshold, const bool verbose, const double constant) const -> frequencyGrid_type {
         if constexpr(numberFrequencyDims == 1) {
             frequencyGrid_type frequencies_new = frequencies;
-            typename base_class::buffer_type data_tmp = base_class::data;
+            typename base_class::buffer_type data_tmp = base_class::get_vec();
             double maxmax = (data_tmp - constant).max_norm();
-            vec<double> maxabs_along_w = maxabs(base_class::data, base_class::data.length(), pos_first_freqpoint) * (1 / maxmax);
+            vec<double> maxabs_along_w = maxabs(base_class::get_vec(), base_class::get_dims(), pos_first_freqpoint) * (1 / maxmax);
 
             const double wmax_old = frequencies_new.  primary_grid.w_upper;
             //frequencies_new.  primary_grid = shrink_freq_box_impl(frequencies.  primary_grid, rel_tail_threshold, maxabs_along_w, verbose);
@@ -406,8 +603,8 @@ class Buffer;
             frequencyGrid_type frequencies_new = frequencies;
 
             double maxmax = base_class::data.max_norm();
-            vec<double> maxabs_along_w = maxabs(base_class::data, base_class::data.length(), pos_first_freqpoint  ) * (1 / maxmax);
-            vec<double> maxabs_along_v = maxabs(base_class::data, base_class::data.length(), pos_first_freqpoint+1) * (1 / maxmax);
+            vec<double> maxabs_along_w = maxabs(base_class::get_vec(), base_class::get_dims(), pos_first_freqpoint  ) * (1 / maxmax);
+            vec<double> maxabs_along_v = maxabs(base_class::get_vec(), base_class::get_dims(), pos_first_freqpoint+1) * (1 / maxmax);
 
             const double wmax_old = frequencies_new.  primary_grid.w_upper;
             const double vmax_old = frequencies_new.secondary_grid.w_upper;
@@ -426,9 +623,9 @@ class Buffer;
             frequencyGrid_type frequencies_new = frequencies;
 
             double maxmax = base_class::data.max_norm();
-            vec<double> maxabs_along_w = maxabs(base_class::data, base_class::data.length(), pos_first_freqpoint  ) * (1 / maxmax);
-            vec<double> maxabs_along_v = maxabs(base_class::data, base_class::data.length(), pos_first_freqpoint+1) * (1 / maxmax);
-            vec<double> maxabs_along_vp= maxabs(base_class::data, base_class::data.length(), pos_first_freqpoint+2) * (1 / maxmax);
+            vec<double> maxabs_along_w = maxabs(base_class::get_vec(), base_class::get_dims(), pos_first_freqpoint  ) * (1 / maxmax);
+            vec<double> maxabs_along_v = maxabs(base_class::get_vec(), base_class::get_dims(), pos_first_freqpoint+1) * (1 / maxmax);
+            vec<double> maxabs_along_vp= maxabs(base_class::get_vec(), base_class::get_dims(), pos_first_freqpoint+2) * (1 / maxmax);
 
             const double wmax_old = frequencies_new.  primary_grid.w_upper;
             const double vmax_old = frequencies_new.secondary_grid.w_upper;
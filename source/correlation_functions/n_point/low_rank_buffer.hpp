@@ -0,0 +1,203 @@
+#ifndef KELDYSH_MFRG_LOW_RANK_BUFFER_H
+#define KELDYSH_MFRG_LOW_RANK_BUFFER_H
+
+// This header contains a compressed (read-only) representation of K3 data by truncated singular value decompositions
+
+#include "../../data_structures.hpp"
+#include "../../parameters/master_parameters.hpp"
+#include "data_buffer.hpp"
+#include <Eigen/SVD>
+
+/**
+ * Stores data with three frequency indices (w, v, vp) in compressed form: every matrix in (v, vp) at fixed other
+ * indices (a "slice") is replaced by its truncated singular value decomposition
+ *      M_{v vp} = sum_r left_{v r} * right_{vp r},
+ * in which all singular values s_r <= tolerance * max|data| are discarded. Hence the error of every element is
+ * bounded by tolerance * max|data| (the spectral norm bounds the magnitude of all elements).
+ * Offers the interface of DataContainer which is needed by Interpolator (val, get_values, frequencies).
+ * @tparam Q                    type of data
+ * @tparam rank                 number of dimensions
+ * @tparam pos_first_freqpoint  position of the first frequency index w; v and vp follow directly
+ * @tparam frequencyGrid_type   frequency grid
+ */
+template<typename Q, size_t rank, my_index_t pos_first_freqpoint, typename frequencyGrid_type>
+class lowRankContainer {
+public:
+    using buffer_type = multidimensional::multiarray<Q, rank>;
+    using index_type = typename buffer_type::index_type;
+    using dimensions_type = typename buffer_type::dimensions_type;
+    using matrix_type = Eigen::Matrix<Q, Eigen::Dynamic, Eigen::Dynamic>;
+
+    frequencyGrid_type frequencies;    // frequency grid
+
+protected:
+    dimensions_type dims{};
+    size_t n_leading = 0;   // number of combinations of the indices before w
+    size_t n_trailing = 0;  // number of combinations of the indices after vp
+    std::vector<matrix_type> left;  // for every slice: left singular vectors times singular values
+    std::vector<matrix_type> right; // for every slice: complex conjugate of the right singular vectors
+    double max_error = 0.;          // maximal absolute error of an element
+
+    size_t slice_index(const index_type& idx) const {
+        size_t i_leading = 0;
+        for (my_index_t i = 0; i < pos_first_freqpoint; i++) i_leading = i_leading * dims[i] + idx[i];
+        size_t i_trailing = 0;
+        for (my_index_t i = pos_first_freqpoint + 3; i < rank; i++) i_trailing = i_trailing * dims[i] + idx[i];
+        return (i_leading * dims[pos_first_freqpoint] + idx[pos_first_freqpoint]) * n_trailing + i_trailing;
+    }
+
+public:
+    lowRankContainer() = default;
+    explicit lowRankContainer(double Lambda, dimensions_type dims_in, const fRG_config& config) : frequencies(Lambda, config) {
+        compress(buffer_type(dims_in), 0.);
+    }
+
+    /// Compresses the data with a relative tolerance (with respect to the maximal magnitude of the data)
+    void compress(const buffer_type& data, const double tolerance) {
+        static_assert(pos_first_freqpoint + 3 <= rank, "lowRankContainer needs three frequency indices.");
+        dims = data.length();
+        n_leading = 1;
+        for (my_index_t i = 0; i < pos_first_freqpoint; i++) n_leading *= dims[i];
+        n_trailing = 1;
+        for (my_index_t i = pos_first_freqpoint + 3; i < rank; i++) n_trailing *= dims[i];
+        const size_t nw = dims[pos_first_freqpoint];
+        const size_t nv = dims[pos_first_freqpoint + 1];
+        const size_t nvp = dims[pos_first_freqpoint + 2];
+        const size_t n_slices = n_leading * nw * n_trailing;
+        left = std::vector<matrix_type>(n_slices);
+        right = std::vector<matrix_type>(n_slices);
+
+        const double threshold = tolerance * data.max_norm();
+        max_error = 0.;
+#pragma omp parallel for schedule(dynamic) reduction(max:max_error)
+        for (size_t i_slice = 0; i_slice < n_slices; i_slice++) {
+            const size_t i_trailing = i_slice % n_trailing;
+            const size_t i_leading_w = i_slice / n_trailing;
+            matrix_type M(nv, nvp);
+            for (size_t iv = 0; iv < nv; iv++) {
+                for (size_t ivp = 0; ivp < nvp; ivp++) {
+                    M(iv, ivp) = data.flat_at((i_leading_w * nv * nvp + iv * nvp + ivp) * n_trailing + i_trailing);
+                }
+            }
+            const Eigen::JacobiSVD<matrix_type> svd(M, Eigen::ComputeThinU | Eigen::ComputeThinV);
+            const auto& s = svd.singularValues();
+            Eigen::Index r = 0;
+            while (r < s.size() and s[r] > threshold) r++;
+            if (r < s.size()) max_error = std::max(max_error, s[r]);
+            left[i_slice] = svd.matrixU().leftCols(r) * s.head(r).template cast<Q>().asDiagonal();
+            right[i_slice] = svd.matrixV().leftCols(r).conjugate();
+        }
+    }
+
+    auto get_VertexFreqGrid() const -> const frequencyGrid_type& { return frequencies; }
+    void set_VertexFreqGrid(const frequencyGrid_type& frequencyGrid) {
+        frequencies = frequencyGrid;
+        frequencies.invalidate_iteration_space();
+    }
+    auto get_dims() const { return dims; }
+
+    /// Returns value for a multiIndex
+    Q val(const index_type& idx) const {
+        const size_t i_slice = slice_index(idx);
+        return (left[i_slice].row(idx[pos_first_freqpoint + 1]).cwiseProduct(right[i_slice].row(idx[pos_first_freqpoint + 2]))).sum();
+    }
+
+    /// Returns the values in the stencil of the (linear) interpolation, see multiarray::get_values()
+    template <my_index_t numberFrequencyDims, my_index_t pos_first_freq, my_index_t vecsize, my_index_t sample_size>
+    Eigen::Matrix<Q, vecsize, my_integer_pow<numberFrequencyDims>(sample_size)> get_values(const index_type& index) const {
+        static_assert(numberFrequencyDims == 3 and pos_first_freq == pos_first_freqpoint, "lowRankContainer holds data with three frequency indices.");
+        Eigen::Matrix<Q, vecsize, my_integer_pow<numberFrequencyDims>(sample_size)> result;
+        // vectorized over the trailing indices
+        size_t i_trailing_first = 0;
+        for (my_index_t i = pos_first_freqpoint + 3; i < rank; i++) i_trailing_first = i_trailing_first * dims[i] + index[i];
+        assert(i_trailing_first + vecsize <= n_trailing);
+        size_t i_leading = 0;
+        for (my_index_t i = 0; i < pos_first_freqpoint; i++) i_leading = i_leading * dims[i] + index[i];
+        for (my_index_t i = 0; i < sample_size; i++) {
+            const size_t i_slice_first = (i_leading * dims[pos_first_freqpoint] + index[pos_first_freqpoint] + i) * n_trailing + i_trailing_first;
+            for (my_index_t j = 0; j < sample_size; j++) {
+                for (my_index_t l = 0; l < sample_size; l++) {
+                    for (my_index_t t = 0; t < vecsize; t++) {
+                        const size_t i_slice = i_slice_first + t;
+                        result(t, (i * sample_size + j) * sample_size + l) = (left[i_slice].row(index[pos_first_freqpoint + 1] + j).cwiseProduct(right[i_slice].row(index[pos_first_freqpoint + 2] + l))).sum();
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    /// Returns the decompressed data
+    buffer_type get_vec() const {
+        buffer_type result(dims);
+        index_type idx;
+        for (size_t iflat = 0; iflat < result.size(); iflat++) {
+            getMultIndex<rank>(idx, iflat, dims);
+            result.flat_at(iflat) = val(idx);
+        }
+        return result;
+    }
+
+    /// Number of stored numbers of type Q
+    size_t storage_size() const {
+        size_t result = 0;
+        for (size_t i = 0; i < left.size(); i++) result += left[i].size() + right[i].size();
+        return result;
+    }
+    /// Ratio of the number of elements of the full data and the number of stored numbers
+    double compression_ratio() const {
+        const size_t n_stored = storage_size();
+        return n_stored == 0 ? 0. : (double) getFlatSize(dims) / (double) n_stored;
+    }
+    /// Maximal rank of the slices
+    Eigen::Index max_rank() const {
+        Eigen::Index result = 0;
+        for (const matrix_type& l : left) result = std::max(result, l.cols());
+        return result;
+    }
+    /// Upper bound of the absolute error of all elements due to the truncation (largest discarded singular value)
+    double get_max_error() const { return max_error; }
+};
+
+/**
+ * Compressed read-only copy of a K3 dataBuffer (see lowRankContainer), e.g. to keep vertices which are only read in
+ * less memory. Offers the same val() and interpolate() as dataBuffer for linear interpolations.
+ * @tparam Q                    type of data
+ * @tparam rank                 number of dimensions
+ * @tparam pos_first_freqpoint  position of first frequency index
+ * @tparam frequencyGrid_type   frequency grid
+ * @tparam inter                interpolation method (linear or linear_on_aux)
+ */
+template <typename Q, size_t rank, my_index_t pos_first_freqpoint, typename frequencyGrid_type, interpolMethod inter>
+class lowRankBuffer: public Interpolator<Q, rank, 3, pos_first_freqpoint, lowRankContainer<Q, rank, pos_first_freqpoint, frequencyGrid_type>, inter> {
+    using base_class = Interpolator<Q, rank, 3, pos_first_freqpoint, lowRankContainer<Q, rank, pos_first_freqpoint, frequencyGrid_type>, inter>;
+    static_assert(inter == linear or inter == linear_on_aux, "lowRankBuffer only supports linear interpolations.");
+
+public:
+    using index_type = typename base_class::index_type;
+    using dimensions_type = typename base_class::dimensions_type;
+
+    lowRankBuffer() : base_class() {};
+    /// Compresses the data of buffer with the relative tolerance (see K3_LOW_RANK_TOLERANCE)
+    template<typename dataBuffer_type>
+    explicit lowRankBuffer(const dataBuffer_type& buffer, const double tolerance = K3_LOW_RANK_TOLERANCE) : base_class() {
+        base_class::frequencies = buffer.get_VertexFreqGrid();
+        base_class::compress(buffer.get_vec(), tolerance);
+        base_class::initInterpolator();
+    }
+
+    using base_class::val;
+    template<typename... Types,
+            typename std::enable_if_t<(sizeof...(Types) == rank) and (are_all_integral<size_t, Types...>::value), bool> = true>
+    Q val(const Types &... i) const { return base_class::val(index_type({static_cast<my_index_t>(i)...})); }
+
+    template<typename result_type=Q>
+    result_type interpolate(const VertexInput& input) const {
+#ifdef DENSEGRID
+        static_assert(not std::is_same_v<result_type, result_type>, "lowRankBuffer does not support the nearest-neighbor lookup on dense grids.");
+#endif
+        return base_class::template interpolate_impl<result_type>(input.template get_freqs<k3>(), input.template get_indices<k3>());
+    }
+};
+
+#endif //KELDYSH_MFRG_LOW_RANK_BUFFER_H
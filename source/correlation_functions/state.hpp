@@ -73,7 +73,7 @@ public:
     void set_frequency_grid(const State<Q,false>& state_in);
 
     // operators containing State objects
-    auto operator+= (const State& state) -> State {
+    auto operator+= (const State& state) -> State& {
         this->vertex += state.vertex;
         this->selfenergy += state.selfenergy;
         return (*this);
@@ -82,7 +82,13 @@ public:
         lhs += rhs;
         return lhs;
     }
-    auto operator+= (const double alpha) -> State {
+    /// this += alpha * state without temporaries (e.g. for the stages of the ODE solver)
+    auto axpy(const double alpha, const State& state) -> State& {
+        this->vertex.axpy(alpha, state.vertex);
+        this->selfenergy.axpy(alpha, state.selfenergy);
+        return (*this);
+    }
+    auto operator+= (const double alpha) -> State& {
         this->vertex += alpha;
         this->selfenergy += alpha;
         return (*this);
@@ -95,7 +101,7 @@ public:
         lhs += rhs;
         return lhs;
     }
-    auto operator*= (const double& alpha) -> State {
+    auto operator*= (const double& alpha) -> State& {
         this->vertex *= alpha;
         this->selfenergy *= alpha;
         return (*this);
@@ -108,7 +114,7 @@ public:
         lhs *= rhs;
         return lhs;
     }
-    auto operator-= (const State& state) -> State {
+    auto operator-= (const State& state) -> State& {
         this->vertex -= state.vertex;
         this->selfenergy -= state.selfenergy;
         return (*this);
@@ -118,7 +124,7 @@ public:
         return lhs;
     }
     // Element-wise division (needed for error estimate in ODE solver)
-    auto operator/= (const State& state) -> State {
+    auto operator/= (const State& state) -> State& {
         this->vertex /= state.vertex;
         this->selfenergy /= state.selfenergy;
         return (*this);
@@ -135,13 +141,14 @@ public:
     auto abs() const -> State<Q,differentiated> {
         State<Q,differentiated> state_abs = (*this);
         state_abs.selfenergy.Sigma.set_vec(selfenergy.Sigma.data.abs());
-        state_abs.vertex.avertex().template apply_unary_op_to_all_vertexBuffers([&](auto buffer) -> void {buffer.data = buffer.data.abs();});
-        state_abs.vertex.pvertex().template apply_unary_op_to_all_vertexBuffers([&](auto buffer) -> void {buffer.data = buffer.data.abs();});
-        state_abs.vertex.tvertex().template apply_unary_op_to_all_vertexBuffers([&](auto buffer) -> void {buffer.data = buffer.data.abs();});
+        state_abs.vertex.avertex().template apply_unary_op_to_all_vertexBuffers([&](auto& buffer) -> void {buffer.data = buffer.data.abs();});
+        state_abs.vertex.pvertex().template apply_unary_op_to_all_vertexBuffers([&](auto& buffer) -> void {buffer.data = buffer.data.abs();});
+        state_abs.vertex.tvertex().template apply_unary_op_to_all_vertexBuffers([&](auto& buffer) -> void {buffer.data = buffer.data.abs();});
         return state_abs;
     }
 
     auto norm() const -> double;
+    auto norm_of_error_scale(const State& other, double a, double b, double rel, double abs_err) const -> double;
 };
 
 
@@ -208,6 +215,32 @@ auto State<Q,differentiated>::norm() const -> double {
 }
 
 
+/**
+ * Fused reduction for the error estimate of the ODE solver: returns the norm (see norm()) of the scale
+ * (|*this| * a + |other| * b) * rel + abs_err, without forming the scale as a State.
+ */
+template<typename Q, bool differentiated>
+auto State<Q,differentiated>::norm_of_error_scale(const State& other, const double a, const double b, const double rel, const double abs_err) const -> double {
+    // all elements of the scale are >= abs_err, hence its maximum is rel * max(a |x| + b |y|) + abs_err
+    const auto max_scale = [&](const auto& x, const auto& y) -> double {return rel * x.data.weighted_max_norm(y.data, a, b) + abs_err;};
+    const auto max_scale_channels = [&](const auto& get_buffer) -> double {
+        const fullvert<Q>& x = vertex.half1();
+        const fullvert<Q>& y = other.vertex.half1();
+        return std::max({max_scale(get_buffer(x.avertex), get_buffer(y.avertex)),
+                         max_scale(get_buffer(x.pvertex), get_buffer(y.pvertex)),
+                         max_scale(get_buffer(x.tvertex), get_buffer(y.tvertex))});
+    };
+
+    // as fullvert::sum_norm(0): sum of the max norms of the diagrammatic classes
+    double max_vert = max_scale_channels([](const rvert<Q>& r) -> const auto& {return r.K1;});
+    if (MAX_DIAG_CLASS >= 2) max_vert += max_scale_channels([](const rvert<Q>& r) -> const auto& {return r.K2;});
+    if (MAX_DIAG_CLASS >= 3) max_vert += max_scale_channels([](const rvert<Q>& r) -> const auto& {return r.K3;});
+    // as SelfEnergy::norm(0)
+    const double max_self = std::max(max_scale(selfenergy.Sigma, other.selfenergy.Sigma),
+                                     rel * (a * std::abs(selfenergy.asymp_val_R) + b * std::abs(other.selfenergy.asymp_val_R)) + abs_err);
+    return std::max(max_self, max_vert);
+}
+
 template<typename Q>
 auto max_rel_err(const State<Q,false>& err, const State<Q,false>& scale_State) -> double {
     return err.norm() / scale_State.norm();
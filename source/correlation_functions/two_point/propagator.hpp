@@ -8,6 +8,7 @@
 #include "selfenergy.hpp"      // self-energy class
 #include "../../parameters/master_parameters.hpp"      // system parameters (lengths of vectors etc.)
 #include "../../utilities/util.hpp"            // sign - function
+#include "../../utilities/checkpoint_writer.hpp" // mutex for accesses to HDF5 files
 
 
 // Fermi--Dirac distribution function
@@ -102,6 +103,7 @@ public:
     void save_propagator_values(const std::string& filename, const rvec& frequencies) const {
         using buffer_type = multidimensional::multiarray<Q, 3>;
         const size_t number_of_frequencies = frequencies.size();
+        std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
         H5::H5File file(filename, H5F_ACC_TRUNC);
 
         if constexpr(KELDYSH_FORMALISM) {
@@ -80,7 +80,7 @@ public:
     double get_curvature_maxSE(bool verbose) const;
 
     // operators for self-energy
-    auto operator+= (const SelfEnergy<Q>& self1) -> SelfEnergy<Q> {//sum operator overloading
+    auto operator+= (const SelfEnergy<Q>& self1) -> SelfEnergy<Q>& {//sum operator overloading
         this->Sigma += self1.Sigma;
         this->asymp_val_R += self1.asymp_val_R;
         return *this;
@@ -89,8 +89,14 @@ public:
         lhs += rhs;
         return lhs;
     }
+    /// this += alpha * self1 without temporaries
+    auto axpy(const double alpha, const SelfEnergy<Q>& self1) -> SelfEnergy<Q>& {
+        this->Sigma.axpy(alpha, self1.Sigma);
+        this->asymp_val_R += alpha * self1.asymp_val_R;
+        return *this;
+    }
     template <typename  Qfac>
-    auto operator+= (Qfac alpha) -> SelfEnergy<Q> {
+    auto operator+= (Qfac alpha) -> SelfEnergy<Q>& {
         this->Sigma += alpha;
         return *this;
     }
@@ -105,7 +111,7 @@ public:
         return lhs;
     }
     template <typename  Qfac>
-    auto operator*= (Qfac alpha) -> SelfEnergy<Q> {
+    auto operator*= (Qfac alpha) -> SelfEnergy<Q>& {
         this->Sigma *= alpha;
         this->asymp_val_R *= alpha;
         return *this;
@@ -121,7 +127,7 @@ public:
         return lhs;
     }
 
-    auto operator-= (const SelfEnergy<Q>& self1) -> SelfEnergy<Q> {//sum operator overloading
+    auto operator-= (const SelfEnergy<Q>& self1) -> SelfEnergy<Q>& {//sum operator overloading
         this->Sigma -= self1.Sigma;
         this->asymp_val_R -= self1.asymp_val_R;
         return *this;
@@ -131,7 +137,7 @@ public:
         return lhs;
     }
     // Elementwise division (needed for error estimate of adaptive ODE solvers)
-    auto operator/= (const SelfEnergy<Q>& self1) -> SelfEnergy<Q> {//sum operator overloading
+    auto operator/= (const SelfEnergy<Q>& self1) -> SelfEnergy<Q>& {//sum operator overloading
         this->Sigma /= self1.Sigma;
         this->asymp_val_R /= self1.asymp_val_R;
         return *this;
@@ -31,6 +31,9 @@ void FrequencyGrid<eliasGrid>::derive_auxiliary_parameters() {
     t_upper = t_from_frequency(w_upper);
     t_lower = t_from_frequency(w_lower);
     spacing_auxiliary_gridpoint = (t_upper - t_lower) / ((double) (number_of_gridpoints-1));
+    recip_spacing_auxiliary_gridpoint = 1. / spacing_auxiliary_gridpoint;
+    recip_W_scale = 1. / W_scale;
+    four_W_scale_squared = 4. * W_scale * W_scale;
 }
 void FrequencyGrid<eliasGrid>::guess_essential_parameters(double Lambda, const fRG_config& config) {
 
@@ -385,6 +388,7 @@ void FrequencyGrid<hybridGrid>::derive_auxiliary_parameters() {
     recip_curvature_quad = aux_pos_section_boundaries[0]*aux_pos_section_boundaries[0] / pos_section_boundaries[0];
 #endif
     spacing_auxiliary_gridpoint = (t_upper - t_lower) / ((double)number_of_gridpoints - 1.);
+    recip_spacing_auxiliary_gridpoint = 1. / spacing_auxiliary_gridpoint;
 }
 
 void FrequencyGrid<hybridGrid>::guess_essential_parameters(const double Lambda, const fRG_config& config) {
@@ -573,6 +577,7 @@ void FrequencyGrid<angularGrid>::derive_auxiliary_parameters() {
     recip_power = 1./power;
     lin_fac_to_power = pow(lin_fac, power);
     spacing_auxiliary_gridpoint = (t_upper - t_lower) / (number_of_gridpoints - 1);
+    recip_spacing_auxiliary_gridpoint = 1. / spacing_auxiliary_gridpoint;
     half_of_interval_length_for_t = (t_upper - t_lower) * 0.5 / number_of_intervals;
     half_of_interval_length_for_w = (w_upper - w_lower) * 0.5 / number_of_intervals;
     half_of_interval_length_for_w_recip = number_of_intervals / ((w_upper - w_lower) * 0.5);
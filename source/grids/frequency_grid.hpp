@@ -29,6 +29,7 @@
 #define KELDYSH_MFRG_FREQUENCY_GRID_HPP
 
 #include <cmath>        // for sqrt, log, exp
+#include <algorithm>    // for min, max
 #include "../data_structures.hpp"
 #include "../utilities/util.hpp"
 #include "../parameters/master_parameters.hpp" // for frequency/Lambda limits and number of frequency/Lambda points
@@ -61,6 +62,19 @@ namespace hdf5_impl {
 
 enum frequencyGridType {eliasGrid, hybridGrid, angularGrid};
 
+/**
+ * Splits a point x = (t - t_lower) / spacing_auxiliary_gridpoint of the rescaled (uniform) auxiliary grid into the index i
+ * of the interval [i, i+1] and the normalized offset x - i in [0, 1]. Points outside of the grid are clamped to the
+ * boundary intervals. Only min/max and a conversion are used, i.e. the function is branch-free and vectorizes.
+ */
+inline int split_rescaled_auxiliary_point(double& dt_normalized, const double x, const int number_of_gridpoints) {
+    assert(isfinite(x));
+    const double x_clamped = std::min(std::max(x, 0.), (double) (number_of_gridpoints - 1));
+    const int index = std::min((int) x_clamped, number_of_gridpoints - 2);
+    dt_normalized = x_clamped - index;
+    return index;
+}
+
 /**
  *
  * @tparam freqGridType
@@ -70,7 +84,7 @@ class FrequencyGrid {};
 
 template <>
 class FrequencyGrid<eliasGrid> {
-    template<typename Q, size_t rank, my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, typename frequencyGrid_type> friend class DataContainer;
+    template<typename Q, size_t rank, my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, typename frequencyGrid_type, typename storage_type, typename layout, int pos_index_subset> friend class DataContainer;
     template<typename gridType> friend void hdf5_impl::init_freqgrid_from_hdf_LambdaLayer(H5::Group& group, gridType& freqgrid, int Lambda_it, double Lambda);
     template<typename gridType> friend void hdf5_impl::write_freqparams_to_hdf_LambdaLayer(H5::Group& group, const gridType& freqgrid, const int Lambda_it, const int numberLambdaLayers, const bool file_exists, const bool verbose);
 
@@ -98,6 +112,9 @@ public:
     freqType t_upper;                     // upper bound of auxiliary grid
     freqType t_lower;                     // lower bound of auxiliary grid
     freqType spacing_auxiliary_gridpoint; // spacing on linear auxiliary grid
+    double recip_spacing_auxiliary_gridpoint;   // 1 / spacing_auxiliary_gridpoint
+    double recip_W_scale;                       // 1 / W_scale              (for get_auxgrid_index)
+    double four_W_scale_squared;                // 4 W_scale^2              (for get_auxgrid_index)
     double U_factor = 0./3.;   // determines scale_factor()
     double Delta_factor = 10.;  // determines scale_factor()
     void derive_auxiliary_parameters();
@@ -185,6 +202,19 @@ public:
     /// core grid functionality (has to be super efficient)
     auto get_grid_index(freqType w_in) const -> int;
     int get_grid_index(freqType &t, freqType w_in) const;
+    /// Branch-free inverse grid map: returns the index of the interval on the auxiliary grid containing t(w_in) and
+    /// stores the normalized offset within that interval in dt_normalized (see split_rescaled_auxiliary_point).
+    int get_auxgrid_index(double& dt_normalized, const freqType w_in) const {
+        double t;
+        if constexpr(KELDYSH) {
+            // grid_transf_v2 with precomputed constants and without sgn()
+            const double w_dev = w_in - w_center;
+            const double w2 = w_dev * w_dev;
+            t = std::copysign(std::sqrt((std::sqrt(w2 * (w2 + four_W_scale_squared)) - w2) * 0.5) * recip_W_scale, w_dev);
+        }
+        else t = t_from_frequency(w_in);
+        return split_rescaled_auxiliary_point(dt_normalized, (t - t_lower) * recip_spacing_auxiliary_gridpoint, number_of_gridpoints);
+    }
 
     /// grid functions:
     auto t_from_frequency(freqType w) const -> freqType ;    // t(w)
@@ -193,7 +223,7 @@ public:
 
 template<>
 class FrequencyGrid<hybridGrid> {
-    template<typename Q, size_t rank, my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, typename frequencyGrid_type>
+    template<typename Q, size_t rank, my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, typename frequencyGrid_type, typename storage_type, typename layout, int pos_index_subset>
     friend class DataContainer;
 
 public:
@@ -219,6 +249,7 @@ public:
     freqType t_lower;                    // smallest point on auxiliary grid
     std::array<double,2> aux_pos_section_boundaries;
     freqType spacing_auxiliary_gridpoint=1.;  // linear spacing on auxiliary grid for t
+    double recip_spacing_auxiliary_gridpoint=1.;  // 1 / spacing_auxiliary_gridpoint
     freqType recip_curvature_quad;            // defines quadratic function f(t) = t^2 / recip_curvature_quad
     freqType recip_slope_lin;                 // defines linear function f(t) = pos_section_boundaries[0] + (t - aux_pos_section_boundaries[0]) / recip_slope_lin
     freqType factor_rat;                      // defines rational function f(t) = factor_rat / (1 - rescale_rat * t)
@@ -273,6 +304,24 @@ public:
     /// core grid functionality (has to be super efficient)
     int get_grid_index(freqType frequency)const;
     int get_grid_index(freqType& t, freqType frequency) const;
+    /// Branch-free inverse grid map: returns the index of the interval on the auxiliary grid containing t(frequency) and
+    /// stores the normalized offset within that interval in dt_normalized (see split_rescaled_auxiliary_point).
+    /// All sections of t_from_frequency() are evaluated and the right one is selected afterwards.
+    int get_auxgrid_index(double& dt_normalized, const freqType frequency) const {
+        const double w_abs = std::abs(frequency);
+        const double t_quad = std::sqrt(w_abs * recip_curvature_quad);
+        const double t_lin = (w_abs - pos_section_boundaries[0]) * recip_slope_lin + aux_pos_section_boundaries[0];
+        const double w_abs_tail = std::max(w_abs, pos_section_boundaries[1]);  // keeps the unused tail finite at w = 0
+#if HYBRID_GRID_OPTION==0
+        const double t_tail = (1. - factor_rat / w_abs_tail) * rescale_rat;
+#else
+        const double t_tail = aux_pos_section_boundaries[1] + log(w_abs_tail / pos_section_boundaries[1]) * pos_section_boundaries[1] * recip_slope_lin;
+#endif
+        double t_abs = w_abs < pos_section_boundaries[0] ? t_quad : t_lin;
+        t_abs = w_abs < pos_section_boundaries[1] ? t_abs : t_tail;
+        const double t = std::copysign(t_abs, frequency);
+        return split_rescaled_auxiliary_point(dt_normalized, (t - t_lower) * recip_spacing_auxiliary_gridpoint, number_of_gridpoints);
+    }
 
 
 };
@@ -280,7 +329,7 @@ public:
 
 template<>
 class FrequencyGrid<angularGrid> {
-    template<typename Q, size_t rank, my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, typename frequencyGrid_type>
+    template<typename Q, size_t rank, my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, typename frequencyGrid_type, typename storage_type, typename layout, int pos_index_subset>
     friend class DataContainer;
 
 public:
@@ -309,6 +358,7 @@ public:
     double t_lower;                    // smallest point on auxiliary grid
 
     double spacing_auxiliary_gridpoint;  // linear spacing on auxiliary grid for t
+    double recip_spacing_auxiliary_gridpoint;  // 1 / spacing_auxiliary_gridpoint
     double half_of_interval_length_for_t;
     double half_of_interval_length_for_w;
     double half_of_interval_length_for_w_recip;
@@ -365,6 +415,14 @@ public:
     /// core grid functionality (has to be super efficient)
     int get_grid_index(double frequency)const;
     int get_grid_index(double& t, double frequency) const;
+    /// Branch-free inverse grid map: returns the index of the interval on the auxiliary grid containing t(frequency) and
+    /// stores the normalized offset within that interval in dt_normalized (see split_rescaled_auxiliary_point).
+    int get_auxgrid_index(double& dt_normalized, const double frequency) const {
+        const double i_interval = std::floor( (frequency + half_of_interval_length_for_w) * interval_length_for_w_recip);
+        const double remainder  = frequency * half_of_interval_length_for_w_recip - i_interval * 2; // remainder in [-1, 1]
+        const double t = ( i_interval + 0.5 * std::copysign(std::pow(std::abs(remainder) * quad_fac_recip + lin_fac_to_power, recip_power) - lin_fac, remainder)) * half_of_interval_length_for_t * 2.;
+        return split_rescaled_auxiliary_point(dt_normalized, (t - t_lower) * recip_spacing_auxiliary_gridpoint, number_of_gridpoints);
+    }
 
     void update_power(double power_in) {
         power = std::max(power_in, 1.); // don't go lower than 1
@@ -394,6 +452,26 @@ public:
     grid_type3  tertiary_grid;
     double T;
 
+    /**
+     * Cache for the iteration space of a bubble computation on this grid: flat indices of all points which are not
+     * related to other points by symmetries (and hence have to be computed), together with an estimate of their
+     * relative computational cost. Built by the BubbleFunctionCalculator, invalidated whenever the grid changes.
+     */
+    struct IterationSpace {
+        bool valid = false;
+        char channel = ' ';                 // channel of the bubble the cache was built for
+        size_t flat_size = 0;               // size of the full iteration space the cache was built for
+        std::vector<int> freq_transformations; // frequency symmetries of the result vertex the cache was built for
+        std::vector<size_t> points;         // flat indices of all symmetry-independent points, most expensive first
+        std::vector<double> cost;           // estimated relative cost of each point
+    };
+    mutable IterationSpace iteration_space;
+    void invalidate_iteration_space() const {iteration_space = IterationSpace();}
+    bool has_iteration_space(const char channel, const size_t flat_size, const std::vector<int>& freq_transformations) const {
+        return iteration_space.valid and iteration_space.channel == channel and iteration_space.flat_size == flat_size
+               and iteration_space.freq_transformations == freq_transformations;
+    }
+
     int get_diagclass() {
         if constexpr(k == selfenergy or k == k1) return 1;
         else if constexpr(k == k2 or k == k2b) return 2;
@@ -407,6 +485,7 @@ public:
     {};
 
     void guess_essential_parameters(double Lambda, const fRG_config& config) {
+        invalidate_iteration_space();
           primary_grid.guess_essential_parameters(Lambda, config);
         if constexpr(k != k1 and k != selfenergy) {
             secondary_grid.guess_essential_parameters(Lambda, config);
@@ -509,15 +588,10 @@ public:
         else assert(false); // "Inconsistent number of frequency arguments.");
     }
     /// determine the grid indices for the frequencies + determine normalized distance to next smaller grid point on auxiliary grid
+    /// (uses the branch-free inverse grid maps FrequencyGrid::get_auxgrid_index)
     void get_auxgrid_index(std::array<my_index_t,1>& idx, std::array<double,1>& dt_normalized, const std::array<freqType,1>& freqs) const {
         if constexpr(k == k1 or k == selfenergy)  {
-            //double w = freqs[0];
-            freqType tw;
-            int iw =   primary_grid.get_grid_index(tw, freqs[0]);
-            idx[0] = iw;
-            double tw_low =   primary_grid.get_auxiliary_gridpoint(iw);
-            double tw_high=   primary_grid.get_auxiliary_gridpoint(iw+1);
-            dt_normalized[0] = (tw - tw_low) / (tw_high - tw_low);
+            idx[0] =   primary_grid.get_auxgrid_index(dt_normalized[0], freqs[0]);
         }
         else assert(false); // "Inconsistent number of frequency arguments.");
     }
@@ -527,17 +601,8 @@ public:
             freqType v  = freqs[1];
             K2_convert2internalFreqs(w, v);
 
-            freqType tw, tv;
-            int iw =   primary_grid.get_grid_index(tw, w);
-            int iv = secondary_grid.get_grid_index(tv, v);
-            idx[0] = iw;
-            idx[1] = iv;
-            double tw_low =   primary_grid.get_auxiliary_gridpoint(iw);
-            double tw_high=   primary_grid.get_auxiliary_gridpoint(iw+1);
-            double tv_low = secondary_grid.get_auxiliary_gridpoint(iv);
-            double tv_high= secondary_grid.get_auxiliary_gridpoint(iv+1);
-            dt_normalized[0] = (tw - tw_low) / (tw_high - tw_low);
-            dt_normalized[1] = (tv - tv_low) / (tv_high - tv_low);
+            idx[0] =   primary_grid.get_auxgrid_index(dt_normalized[0], w);
+            idx[1] = secondary_grid.get_auxgrid_index(dt_normalized[1], v);
         }
         else assert(false); // "Inconsistent number of frequency arguments.");
     }
@@ -548,22 +613,9 @@ public:
             freqType vp = freqs[2];
             K3_convert2internalFreqs(w, v, vp);
 
-            freqType tw, tv, tvp;
-            int iw =   primary_grid.get_grid_index(tw, w);
-            int iv = secondary_grid.get_grid_index(tv, v);
-            int ivp=  tertiary_grid.get_grid_index(tvp,vp);
-            idx[0] = iw;
-            idx[1] = iv;
-            idx[2] = ivp;
-            double tw_low =   primary_grid.get_auxiliary_gridpoint(iw);
-            double tw_high=   primary_grid.get_auxiliary_gridpoint(iw+1);
-            double tv_low = secondary_grid.get_auxiliary_gridpoint(iv);
-            double tv_high= secondary_grid.get_auxiliary_gridpoint(iv+1);
-            double tvp_low =tertiary_grid.get_auxiliary_gridpoint(ivp);
-            double tvp_high=tertiary_grid.get_auxiliary_gridpoint(ivp+1);
-            dt_normalized[0] = (tw - tw_low) / (tw_high - tw_low);
-            dt_normalized[1] = (tv - tv_low) / (tv_high - tv_low);
-            dt_normalized[2] = (tvp-tvp_low) / (tvp_high-tvp_low);
+            idx[0] =   primary_grid.get_auxgrid_index(dt_normalized[0], w);
+            idx[1] = secondary_grid.get_auxgrid_index(dt_normalized[1], v);
+            idx[2] =  tertiary_grid.get_auxgrid_index(dt_normalized[2], vp);
         }
         else assert(false); // "Inconsistent number of frequency arguments.");
     }
@@ -705,6 +757,10 @@ double grid_transf_inv_v2(double t, double W_scale, double w_center);
 double grid_transf_inv_v3(double t, double W_scale, double w_center);
 double grid_transf_inv_v4(double t, double W_scale, double w_center);
 double grid_transf_inv_log(double t, double W_scale);
+double integration_measure_v1(double t, double W_scale);
+double integration_measure_v2(double t, double W_scale);
+double integration_measure_v3(double t, double W_scale);
+double integration_measure_v4(double t, double W_scale);
 freqType wscale_from_wmax_v1(freqType & Wscale, freqType w1, freqType wmax, int N);
 freqType wscale_from_wmax_v2(freqType & Wscale, freqType w1, freqType wmax, int N);
 freqType wscale_from_wmax_v3(freqType & Wscale, freqType w1, freqType wmax, int N);
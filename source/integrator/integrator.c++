@@ -77,3 +77,28 @@ auto integrator_gsl_qagil_helper(gsl_function& F, double a, int Nmax) -> double
     return result;
     /// If needed: more information can be extracted, e.g. error, number of interval subdivisions
 }
+
+void gauss_legendre_rule(const int n, vec<double>& nodes, vec<double>& weights) {
+    nodes = vec<double>(n);
+    weights = vec<double>(n);
+    for (int i = 0; i < (n + 1) / 2; i++) {
+        // Newton iteration for the i-th root of the Legendre polynomial P_n, starting from the Chebyshev estimate
+        double x = cos(M_PI * (i + 0.75) / (n + 0.5));
+        double dp = 1.;
+        for (int iteration = 0; iteration < 100; iteration++) {
+            double p0 = 1., p1 = 0.;
+            for (int j = 1; j <= n; j++) { // recursion (j) P_j = (2j-1) x P_{j-1} - (j-1) P_{j-2}
+                const double p2 = p1;
+                p1 = p0;
+                p0 = ((2. * j - 1.) * x * p1 - (j - 1.) * p2) / j;
+            }
+            dp = n * (x * p0 - p1) / (x * x - 1.);
+            const double dx = p0 / dp;
+            x -= dx;
+            if (std::abs(dx) < 1e-15) break;
+        }
+        nodes[i] = -x;
+        nodes[n - 1 - i] = x;
+        weights[i] = weights[n - 1 - i] = 2. / ((1. - x * x) * dp * dp);
+    }
+}
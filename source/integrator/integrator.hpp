@@ -3,29 +3,63 @@
 
 #include <numeric>
 #include <type_traits>
+#include <array>
+#include <limits>
 #include "../data_structures.hpp"                 // real and complex vectors
 #include "../parameters/master_parameters.hpp"                      // system parameters
 #include <gsl/gsl_integration.h>                // for GSL integrator
 #include <gsl/gsl_errno.h>                      // for GSL integrator
 #include "old_integrators.hpp"                    // Riemann, Simpson, PAID integrator (should not needed)
 #include "integrator_NR.hpp"                      // adaptive Gauss-Lobatto integrator with Kronrod extension
+#include "integrator_global_adaptive.hpp"         // globally adaptive Gauss-Kronrod integrator
 #include "../utilities/util.hpp"                  // for rounding functions
 
+/**
+ * Wrapper of an integrand for the GSL routines, which integrate real and imaginary parts in separate passes.
+ * Holds a reference to the integrand (no copy per evaluation) and, for complex integrands, remembers the values
+ * computed for the real part in a fixed-size direct-mapped cache, such that the imaginary part can reuse them at the
+ * abscissae visited by both passes. A value is overwritten by a later abscissa mapped to the same slot, hence the
+ * memory needed is fixed and nothing is allocated during the integration.
+ */
+template <typename Integrand>
+class gsl_integrand {
+    using Q = std::result_of_t<Integrand(double)>;
+    static constexpr size_t cache_size = std::is_same_v<Q, comp> ? 256 : 0;
+    const Integrand& integrand;
+    std::array<double, cache_size> abscissae;   // abscissa of the value in each slot (NaN if empty)
+    std::array<Q, cache_size> values;           // complex values at the abscissae
+public:
+    explicit gsl_integrand(const Integrand& integrand_in) : integrand(integrand_in) {
+        abscissae.fill(std::numeric_limits<double>::quiet_NaN());
+    }
+
+    auto operator() (const double x) -> Q {
+        if constexpr (std::is_same_v<Q, comp>) {
+            const size_t slot = std::hash<double>{}(x) % cache_size;
+            if (abscissae[slot] != x) {
+                values[slot] = integrand(x);
+                abscissae[slot] = x;
+            }
+            return values[slot];
+        }
+        else {
+            return integrand(x);
+        }
+    }
+};
+
 /* compute real part of integrand (for GSL/PAID) */
 template <typename Integrand>
 auto f_real(double x, void* params) -> double {
-    Integrand integrand = *(Integrand*) params;
-    double f_real = myreal(integrand(x));
-
-    return f_real;
+    gsl_integrand<Integrand>& integrand = *(gsl_integrand<Integrand>*) params;
+    return myreal(integrand(x));
 }
 
 /* compute imaginary part of integrand (for GSL/PAID) */
 template <typename Integrand>
 auto f_imag(double x, void* params) -> double {
-    Integrand integrand = *(Integrand*) params;
-    double f = myimag(integrand(x));
-    return f;
+    gsl_integrand<Integrand>& integrand = *(gsl_integrand<Integrand>*) params;
+    return myimag(integrand(x));
 }
 
 /* error handler for GSL integrator */
@@ -43,19 +77,23 @@ auto integrator_gsl_qagiu_helper(gsl_function& F, double a, int Nmax) -> double;
 
 auto integrator_gsl_qagil_helper(gsl_function& F, double a, int Nmax) -> double;
 
+/// Nodes and weights of the n-point Gauss-Legendre rule on [-1, 1]
+void gauss_legendre_rule(int n, vec<double>& nodes, vec<double>& weights);
+
 
 
 /* Integration using routines from the GSL library (many different routines available, would need more testing) */
 template <typename Q, typename Integrand> auto integrator_gsl_qag_tails(Integrand& integrand, double a, double b, int Nmax) -> Q {
+    gsl_integrand<Integrand> integrand_gsl(integrand);
     if constexpr (std::is_same<Q,comp>::value){
 
         gsl_function F_real;
         gsl_function F_imag;
 
         F_real.function = &f_real<Integrand>;
-        F_real.params = &integrand;
+        F_real.params = &integrand_gsl;
         F_imag.function = &f_imag<Integrand>;
-        F_imag.params = &integrand;
+        F_imag.params = &integrand_gsl;
 
         double result_real = 0.;
         double result_imag = 0.;
@@ -73,7 +111,7 @@ template <typename Q, typename Integrand> auto integrator_gsl_qag_tails(Integran
         gsl_function F_real;
 
         F_real.function = &f_real<Integrand>;
-        F_real.params = &integrand;
+        F_real.params = &integrand_gsl;
 
         double result_real = 0.;
 
@@ -87,15 +125,16 @@ template <typename Q, typename Integrand> auto integrator_gsl_qag_tails(Integran
 
 /* Integration using routines from the GSL library (many different routines available, would need more testing) */
 template <typename Q, typename Integrand> auto integrator_gsl_qag_v2(Integrand& integrand, double a, double b, int Nmax, const bool isinf) -> Q {
+    gsl_integrand<Integrand> integrand_gsl(integrand);
     if constexpr (std::is_same<Q,comp>::value){
 
         gsl_function F_real;
         gsl_function F_imag;
 
         F_real.function = &f_real<Integrand>;
-        F_real.params = &integrand;
+        F_real.params = &integrand_gsl;
         F_imag.function = &f_imag<Integrand>;
-        F_imag.params = &integrand;
+        F_imag.params = &integrand_gsl;
 
         double result_real = integrator_gsl_qag_helper(F_real, a, b, Nmax);
         double result_imag = integrator_gsl_qag_helper(F_imag, a, b, Nmax);
@@ -113,7 +152,7 @@ template <typename Q, typename Integrand> auto integrator_gsl_qag_v2(Integrand&
         gsl_function F_real;
 
         F_real.function = &f_real<Integrand>;
-        F_real.params = &integrand;
+        F_real.params = &integrand_gsl;
 
         double result_real = integrator_gsl_qag_helper(F_real, a, b, Nmax);
 
@@ -128,15 +167,16 @@ template <typename Q, typename Integrand> auto integrator_gsl_qag_v2(Integrand&
 
 /* Integration using routines from the GSL library (many different routines available, would need more testing) */
 template <typename Q, typename Integrand> auto integrator_gsl_qagp_v2(Integrand& integrand, double* pts, int npts, int Nmax, const bool isinf) -> Q {
+    gsl_integrand<Integrand> integrand_gsl(integrand);
     if constexpr (std::is_same<Q,comp>::value){
 
         gsl_function F_real;
         gsl_function F_imag;
 
         F_real.function = &f_real<Integrand>;
-        F_real.params = &integrand;
+        F_real.params = &integrand_gsl;
         F_imag.function = &f_imag<Integrand>;
-        F_imag.params = &integrand;
+        F_imag.params = &integrand_gsl;
 
         double result_real = integrator_gsl_qagp_helper(F_real, pts, npts, Nmax);
         double result_imag = integrator_gsl_qagp_helper(F_imag, pts, npts, Nmax);
@@ -155,7 +195,7 @@ template <typename Q, typename Integrand> auto integrator_gsl_qagp_v2(Integrand&
         gsl_function F_real;
 
         F_real.function = &f_real<Integrand>;
-        F_real.params = &integrand;
+        F_real.params = &integrand_gsl;
 
         double result_real = integrator_gsl_qagp_helper(F_real, pts, npts, Nmax);
 
@@ -172,6 +212,7 @@ template <typename Q, typename Integrand> auto integrator_gsl_qagp_v2(Integrand&
 
 /* Integration using routines from the GSL library (many different routines available, would need more testing) */
 template <typename Q, typename Integrand> auto integrator_gsl(Integrand& integrand, double a, double b, double w1_in, double w2_in, int Nmax) -> Q {
+    gsl_integrand<Integrand> integrand_gsl(integrand);
     if constexpr (std::is_same<Q, std::complex<double>>::value){
         gsl_integration_workspace* W_real = gsl_integration_workspace_alloc(Nmax);
         gsl_integration_workspace* W_imag = gsl_integration_workspace_alloc(Nmax);
@@ -180,9 +221,9 @@ template <typename Q, typename Integrand> auto integrator_gsl(Integrand& integra
         gsl_function F_imag;
 
         F_real.function = &f_real<Integrand>;
-        F_real.params = &integrand;
+        F_real.params = &integrand_gsl;
         F_imag.function = &f_imag<Integrand>;
-        F_imag.params = &integrand;
+        F_imag.params = &integrand_gsl;
 
         double result_real, error_real;
         double result_imag, error_imag;
@@ -203,7 +244,7 @@ template <typename Q, typename Integrand> auto integrator_gsl(Integrand& integra
         gsl_function F_real;
 
         F_real.function = &f_real<Integrand>;
-        F_real.params = &integrand;
+        F_real.params = &integrand_gsl;
 
         double result_real, error_real;
 
@@ -220,12 +261,13 @@ template <typename Q, typename Integrand> auto integrator_gsl(Integrand& integra
 /* Integration using routines from the GSL library (many different routines available, would need more testing) */
 //
 template <typename Q, typename Integrand> auto integrator_gsl(Integrand& integrand, const vec<vec<double>>& intervals, const size_t num_intervals, const int Nmax, const bool isinf=false) -> Q {
+    gsl_integrand<Integrand> integrand_gsl(integrand);
 
     if constexpr (std::is_same<Q, std::complex<double>>::value) {
         gsl_integration_workspace *W_real = gsl_integration_workspace_alloc(Nmax);
         gsl_function F_real;
         F_real.function = &f_real<Integrand>;
-        F_real.params = &integrand;
+        F_real.params = &integrand_gsl;
         double result_real{}, error_real{};
 
         gsl_set_error_handler(handler);
@@ -253,7 +295,7 @@ template <typename Q, typename Integrand> auto integrator_gsl(Integrand& integra
         gsl_integration_workspace *W_imag = gsl_integration_workspace_alloc(Nmax);
         gsl_function F_imag;
         F_imag.function = &f_imag<Integrand>;
-        F_imag.params = &integrand;
+        F_imag.params = &integrand_gsl;
         double result_imag{}, error_imag{};
         double result_imag_temp{}, error_imag_temp{};
         if (isinf) {
@@ -280,7 +322,7 @@ template <typename Q, typename Integrand> auto integrator_gsl(Integrand& integra
         gsl_integration_workspace *W_real = gsl_integration_workspace_alloc(Nmax);
         gsl_function F_real;
         F_real.function = &f_real<Integrand>;
-        F_real.params = &integrand;
+        F_real.params = &integrand_gsl;
         double result_real = 0., error_real = 0.;
 
         gsl_set_error_handler(handler);
@@ -314,15 +356,23 @@ template <typename Q, typename Integrand> auto integrator_gsl(Integrand& integra
 
 /// --- WRAPPER FUNCTIONS: INTERFACE FOR ACCESSING THE INTEGRATOR IN BUBBLES/LOOP --- ///
 
+/// adaptive integrators used by the wrapper functions, selected by INTEGRATOR_TYPE
+template <typename Integrand> using adaptive_integrator = std::conditional_t<INTEGRATOR_TYPE == global_Gauss_Kronrod,
+        Adapt_global<Integrand>, Adapt<Integrand>>;
+template <typename Integrand> using adaptive_integrator_semiInfinitLower = std::conditional_t<INTEGRATOR_TYPE == global_Gauss_Kronrod,
+        Adapt_global_semiInfinitLower<Integrand>, Adapt_semiInfinitLower<Integrand>>;
+template <typename Integrand> using adaptive_integrator_semiInfinitUpper = std::conditional_t<INTEGRATOR_TYPE == global_Gauss_Kronrod,
+        Adapt_global_semiInfinitUpper<Integrand>, Adapt_semiInfinitUpper<Integrand>>;
+
 // old wrapper function
 template <typename Q, typename Integrand> auto integrator(Integrand& integrand, double a, double b) -> Q {
-    Adapt<Integrand> adaptor(integrator_tol, integrand);
+    adaptive_integrator<Integrand> adaptor(integrator_tol, integrand);
     return adaptor.integrate(a, b);
 }
 
 // wrapper function, used for loop
 template <typename Q, typename Integrand> auto integrator(Integrand& integrand, double a, double b, double w) -> Q {
-    Adapt<Integrand> adaptor(integrator_tol, integrand);
+    adaptive_integrator<Integrand> adaptor(integrator_tol, integrand);
     return adaptor.integrate(a, b);
 }
 
@@ -335,7 +385,7 @@ template <typename Q, typename Integrand> auto integrator(Integrand& integrand,
  * @param w2        :   unused
  */
 template <typename Q, typename Integrand> auto integrator(Integrand& integrand, double a, double b, double w1, double w2) -> Q {
-    Adapt<Integrand> adaptor(integrator_tol, integrand);
+    adaptive_integrator<Integrand> adaptor(integrator_tol, integrand);
     return adaptor.integrate(a, b);
 }
 
@@ -356,18 +406,18 @@ template <typename Integrand> auto integrator(Integrand& integrand, double a, do
 
     return_type result = myzero<return_type>(); // initialize results
     // integrate intervals of with 2*Delta around the features at w1, w2
-    Adapt<Integrand> adaptor_peaks(integrator_tol, integrand);
+    adaptive_integrator<Integrand> adaptor_peaks(integrator_tol, integrand);
     result += adaptor_peaks.integrate(intersections[3], intersections[4]);
     result += adaptor_peaks.integrate(intersections[1], intersections[2]);
 
     // integrate the tails and the interval between the features, with increased tolerance
-    Adapt<Integrand> adaptor_tails(integrator_tol * 10, integrand);
+    adaptive_integrator<Integrand> adaptor_tails(integrator_tol * 10, integrand);
     result += adaptor_tails.integrate(intersections[0], intersections[1]);
     result += adaptor_tails.integrate(intersections[2], intersections[3]);
     result += adaptor_tails.integrate(intersections[4], intersections[5]);
     if (isinf) {
-        Adapt_semiInfinitLower<Integrand> adapt_il(integrator_tol, integrand, intersections[0]);
-        Adapt_semiInfinitUpper<Integrand> adapt_iu(integrator_tol, integrand, intersections[5]);
+        adaptive_integrator_semiInfinitLower<Integrand> adapt_il(integrator_tol, integrand, intersections[0]);
+        adaptive_integrator_semiInfinitUpper<Integrand> adapt_iu(integrator_tol, integrand, intersections[5]);
         result += adapt_il.integrate();
         result += adapt_iu.integrate();
     }
@@ -382,15 +432,15 @@ template <typename Integrand> auto integrator(Integrand& integrand, double a, do
  */
 template <typename Integrand> auto integrator(Integrand& integrand, vec<vec<double>>& intervals, const my_index_t num_intervals, const bool isinf=false) -> std::result_of_t<Integrand(double)> {
     using return_type = std::result_of_t<Integrand(double)>;
-    Adapt<Integrand> adaptor(integrator_tol, integrand);
+    adaptive_integrator<Integrand> adaptor(integrator_tol, integrand);
     vec<return_type> result = vec<return_type>(num_intervals);
     assert(result.size() == num_intervals);
     for (my_index_t i = 0; i < num_intervals; i++){
         if (intervals[i][0] < intervals[i][1]) result[i] = adaptor.integrate(intervals[i][0], intervals[i][1]);
     }
     if (isinf) {
-        Adapt_semiInfinitLower<Integrand> adapt_il(integrator_tol, integrand, intervals[0][0]);
-        Adapt_semiInfinitUpper<Integrand> adapt_iu(integrator_tol, integrand, intervals[num_intervals-1][1]);
+        adaptive_integrator_semiInfinitLower<Integrand> adapt_il(integrator_tol, integrand, intervals[0][0]);
+        adaptive_integrator_semiInfinitUpper<Integrand> adapt_iu(integrator_tol, integrand, intervals[num_intervals-1][1]);
         result[0] += adapt_il.integrate();
         result[0] += adapt_iu.integrate();
     }
@@ -407,8 +457,8 @@ template <typename Integrand> auto integrator(Integrand& integrand, vec<vec<doub
  */
 template <typename Integrand> auto integrator_onlyTails(Integrand& integrand, const double vmin, const double vmax) -> std::result_of_t<Integrand(double)> {
     using return_type = std::result_of_t<Integrand(double)>;
-    Adapt_semiInfinitLower<Integrand> adapt_il(integrator_tol, integrand, vmin);
-    Adapt_semiInfinitUpper<Integrand> adapt_iu(integrator_tol, integrand, vmax);
+    adaptive_integrator_semiInfinitLower<Integrand> adapt_il(integrator_tol, integrand, vmin);
+    adaptive_integrator_semiInfinitUpper<Integrand> adapt_iu(integrator_tol, integrand, vmax);
     const return_type val = adapt_il.integrate() + adapt_iu.integrate();
 
     return val;
@@ -7,8 +7,35 @@
 #define KELDYSH_MFRG_INTEGRATOR_NR_HPP
 
 #include <limits>
+#include <array>
+#include <type_traits>
 #include "../data_structures.hpp"
 
+namespace adaptive_integrator_detail{
+
+    /// Detects whether the integrand offers a batched evaluation evaluate_batch(const double* x, int n, Q* out).
+    template <typename Integrand, typename Q, typename = void>
+    struct has_evaluate_batch : std::false_type {};
+
+    template <typename Integrand, typename Q>
+    struct has_evaluate_batch<Integrand, Q, std::void_t<decltype(std::declval<const Integrand&>().evaluate_batch(
+            std::declval<const double*>(), std::declval<int>(), std::declval<Q*>()))>> : std::true_type {};
+
+    /**
+     * Evaluate the integrand at n points x and write the values into f. Uses the batched evaluation of the integrand
+     * if available, otherwise calls the integrand point by point.
+     */
+    template <typename Integrand, typename Q>
+    void evaluate(const Integrand& integrand, const double* x, const int n, Q* f) {
+        if constexpr (has_evaluate_batch<Integrand, Q>::value) {
+            integrand.evaluate_batch(x, n, f);
+        }
+        else {
+            for (int i = 0; i < n; i++) f[i] = integrand(x[i]);
+        }
+    }
+}
+
 template <typename Integrand, typename Q = std::result_of_t<Integrand(double)>>
 struct Adapt {
 public:
@@ -65,13 +92,10 @@ auto Adapt<Integrand,Q>::integrate(const double a, const double b) -> Q {
 
     x[0]  = a;  // left boundary
     x[12] = b;  // right boundary
-    f[0]  = integrand(x[0]);  // value at the left boundary
-    f[12] = integrand(x[12]);  // value at the right boundary
-
     for (int i=1; i<12; i++) {
         x[i] = m + nodes[i] * h;  // positions of the 13 Gauss-Kronrod nodes
-        f[i] = integrand(x[i]);   // integrand values at the 13 Gauss-Kronrod nodes
     }
+    adaptive_integrator_detail::evaluate(integrand, x, 13, f);  // integrand values at the 13 Gauss-Kronrod nodes
 
     // use 4-point Gauss-Lobatto rule as a first estimate
     i1 = Gauss_Lobatto_4(h, f[0], f[4], f[8], f[12]);
@@ -129,8 +153,7 @@ auto Adapt<Integrand,Q>::integrate(const double a, const double b, const Q fa, c
     x[3] = m + beta * h;
     x[4] = m + alpha * h;
 
-    for (int i=0; i<5; ++i)
-        f[i] = integrand(x[i]);  // integrand values at the Gauss-Kronrod nodes
+    adaptive_integrator_detail::evaluate(integrand, x, 5, f);  // integrand values at the Gauss-Kronrod nodes
 
     // first and second estimate using 4-point Gauss-Lobatto and 7-point Gauss-Kronrod
     i1 = Gauss_Lobatto_4(h, fa, f[1], f[3], fb);
@@ -177,6 +200,16 @@ namespace adaptive_integrator_detail{
         auto operator() (const double x) const -> Q {
             return integrand_original(b + (1 - x) / x) / (x*x);
         }
+        void evaluate_batch(const double* x, const int n, Q* out) const {
+            constexpr int chunk_size = 16;
+            std::array<double, chunk_size> y;
+            for (int first = 0; first < n; first += chunk_size) {
+                const int m = std::min(chunk_size, n - first);
+                for (int i = 0; i < m; i++) y[i] = b + (1 - x[first + i]) / x[first + i];
+                evaluate(integrand_original, y.data(), m, out + first);
+                for (int i = 0; i < m; i++) out[first + i] /= (x[first + i] * x[first + i]);
+            }
+        }
     };
 
     template <typename Integrand>
@@ -189,6 +222,16 @@ namespace adaptive_integrator_detail{
         auto operator() (const double x) const -> Q {
             return integrand_original(b - (1 - x) / x) / (x*x);
         }
+        void evaluate_batch(const double* x, const int n, Q* out) const {
+            constexpr int chunk_size = 16;
+            std::array<double, chunk_size> y;
+            for (int first = 0; first < n; first += chunk_size) {
+                const int m = std::min(chunk_size, n - first);
+                for (int i = 0; i < m; i++) y[i] = b - (1 - x[first + i]) / x[first + i];
+                evaluate(integrand_original, y.data(), m, out + first);
+                for (int i = 0; i < m; i++) out[first + i] /= (x[first + i] * x[first + i]);
+            }
+        }
     };
 }
 template <typename Integrand>
@@ -0,0 +1,296 @@
+/**
+ * Globally adaptive integration using the 7-point Gauss rule with 15-point Kronrod extension.
+ * In contrast to the recursive integrator in integrator_NR.hpp, the subintervals are kept in a priority queue ordered
+ * by their error estimates, and always the interval with the largest error is bisected next, until the total error
+ * satisfies the requested tolerance. For vector- or matrix-valued integrands, the error can be controlled
+ * component-wise or in a weighted norm (see integratorErrorNorm).
+ */
+
+#ifndef KELDYSH_MFRG_INTEGRATOR_GLOBAL_ADAPTIVE_HPP
+#define KELDYSH_MFRG_INTEGRATOR_GLOBAL_ADAPTIVE_HPP
+
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include "../data_structures.hpp"
+#include "../parameters/master_parameters.hpp"
+#include "integrator_NR.hpp"        // batched evaluation of integrands, reparametrization of semi-infinite intervals
+
+namespace global_adaptive_integrator_detail{
+
+    /// Absolute values of all components of x: a double for scalars, an Eigen array for Eigen matrices.
+    template <typename Q>
+    auto component_abs(const Q& x) {
+        if constexpr (std::is_same_v<Q, comp> or std::is_same_v<Q, double>) {
+            return std::abs(x);
+        }
+        else if constexpr (std::is_base_of_v<Eigen::MatrixBase<Q>, Q>) {
+            return Eigen::Array<double, Q::RowsAtCompileTime, Q::ColsAtCompileTime>(x.cwiseAbs().array());
+        }
+        else {
+            return myabs(x);
+        }
+    }
+
+    /**
+     * Error estimate of the 15-point Gauss-Kronrod rule as in QUADPACK: the difference err to the 7-point Gauss rule
+     * is rescaled by the variation of the integrand over the interval, resasc, as resasc * min(1, (200 err/resasc)^1.5).
+     */
+    template <typename T> T rescale_error(const T& err, const T& resasc) {
+        if constexpr (std::is_same_v<T, double>) {
+            return resasc > 0. ? resasc * std::min(1., std::pow(200. * err / resasc, 1.5)) : err;
+        }
+        else {
+            return (resasc > 0.).select(resasc * (200. * err / resasc).pow(1.5).min(1.), err);
+        }
+    }
+
+    template <typename T> double max_component(const T& x) {
+        if constexpr (std::is_same_v<T, double>) return x;
+        else return x.maxCoeff();
+    }
+}
+
+template <typename Integrand, typename Q = std::result_of_t<Integrand(double)>>
+class Adapt_global {
+    using error_type = decltype(global_adaptive_integrator_detail::component_abs(std::declval<Q>()));
+
+    struct interval {
+        double a, b;            // interval boundaries
+        Q result;               // 15-point Gauss-Kronrod estimate of the integral
+        error_type error;       // error estimate from the difference to the 7-point Gauss estimate
+        double priority;        // scalar error measure used to order the intervals
+    };
+
+    static const double xgk[8], wgk[8], wg[4];  // Gauss-Kronrod nodes and weights, Gauss weights
+    static constexpr double relative_floor = 1e-12; // components below this fraction of the largest one count as zero
+
+    double TOL;                                 // relative tolerance
+    const double tolerance_abs = std::numeric_limits<double>::epsilon();  // machine precision, used as absolute tolerance
+    const Integrand& integrand;                 // integrand, needs call operator returning a Q
+    const integratorErrorNorm error_norm;
+    const size_t max_intervals;
+    error_type error_weights;                   // weights for error_norm = weighted_norm
+    error_type inverse_scale;                   // inverse error scale of all components for error_norm = componentwise
+
+    std::vector<interval> pool;                 // all subintervals, preallocated in the constructor
+    std::vector<size_t> heap;                   // indices of the subintervals in pool, ordered by priority
+
+    void apply_rule(double a, double b, const Q* f, interval& I) const;
+    auto priority(const error_type& error) const -> double;
+    auto converged(const Q& result, const error_type& error) const -> bool;
+    auto floor(const error_type& result_abs) const -> double;
+
+public:
+    size_t n_evaluations = 0;                   // number of integrand evaluations since construction
+
+    Adapt_global(double tol_in, const Integrand& integrand_in, integratorErrorNorm error_norm_in = INTEGRATOR_ERROR_NORM,
+                 size_t max_intervals_in = 1000)
+            : TOL(tol_in), integrand(integrand_in), error_norm(error_norm_in), max_intervals(max_intervals_in) {
+        if (TOL < 10.*tolerance_abs)  // if tolerance is smaller than 10 * machine precision,
+            TOL = 10.*tolerance_abs;  // set it to 10 * machine precision
+        pool.reserve(max_intervals);
+        heap.reserve(max_intervals);
+    }
+
+    /** Set the weights of the components for error_norm = weighted_norm. By default, all weights are one. */
+    void set_error_weights(const error_type& weights) { error_weights = weights; }
+
+    /** Integrate integrand from a to b. */
+    auto integrate(double a, double b) -> Q;
+};
+
+template <typename Integrand, typename Q>
+void Adapt_global<Integrand,Q>::apply_rule(const double a, const double b, const Q* f, interval& I) const {
+    const double h = 0.5*(b-a);  // half width of the interval
+    // f[0] is the value at the center, f[1+2j] and f[2+2j] the values at the j-th pair of nodes
+    Q result_k = wgk[7] * f[0];
+    Q result_g = wg[3] * f[0];
+    for (int j = 0; j < 7; j++) {
+        const Q f_sum = f[1 + 2*j] + f[2 + 2*j];
+        result_k += wgk[j] * f_sum;
+        if (j % 2 == 1) result_g += wg[j/2] * f_sum;
+    }
+    const Q mean = 0.5 * result_k;
+    error_type resasc = wgk[7] * global_adaptive_integrator_detail::component_abs(Q(f[0] - mean));
+    for (int j = 0; j < 7; j++) {
+        resasc += wgk[j] * (global_adaptive_integrator_detail::component_abs(Q(f[1 + 2*j] - mean))
+                          + global_adaptive_integrator_detail::component_abs(Q(f[2 + 2*j] - mean)));
+    }
+    I.a = a;
+    I.b = b;
+    I.result = h * result_k;
+    I.error = global_adaptive_integrator_detail::rescale_error(
+            error_type(global_adaptive_integrator_detail::component_abs(Q(h * (result_k - result_g)))), error_type(h * resasc));
+    I.priority = priority(I.error);
+}
+
+template <typename Integrand, typename Q>
+auto Adapt_global<Integrand,Q>::floor(const error_type& result_abs) const -> double {
+    return std::max(tolerance_abs, relative_floor * global_adaptive_integrator_detail::max_component(result_abs));
+}
+
+template <typename Integrand, typename Q>
+auto Adapt_global<Integrand,Q>::priority(const error_type& error) const -> double {
+    if constexpr (std::is_same_v<error_type, double>) {
+        return error;
+    }
+    else {
+        switch (error_norm) {
+            case componentwise:
+                return (error * inverse_scale).maxCoeff();
+            case weighted_norm:
+                return (error * error_weights).sum();
+            default:
+                return error.maxCoeff();
+        }
+    }
+}
+
+template <typename Integrand, typename Q>
+auto Adapt_global<Integrand,Q>::converged(const Q& result, const error_type& error) const -> bool {
+    const error_type result_abs = global_adaptive_integrator_detail::component_abs(result);
+    if constexpr (std::is_same_v<error_type, double>) {
+        return error <= std::max(tolerance_abs, TOL * result_abs);
+    }
+    else {
+        switch (error_norm) {
+            case componentwise:
+                return (error <= (TOL * result_abs).max(floor(result_abs))).all();
+            case weighted_norm:
+                return (error * error_weights).sum() <= std::max(tolerance_abs, TOL * (result_abs * error_weights).sum());
+            default:
+                return error.maxCoeff() <= std::max(tolerance_abs, TOL * result_abs.maxCoeff());
+        }
+    }
+}
+
+template <typename Integrand, typename Q>
+auto Adapt_global<Integrand,Q>::integrate(const double a, const double b) -> Q {
+    if (b <= a) return myzero<Q>();
+
+    double x[30];
+    Q f[30];
+
+    // nodes of the 15-point rule on [a, b], starting at index offset, in the order expected by apply_rule
+    auto set_nodes = [&](const double a_i, const double b_i, const int offset) {
+        const double m = 0.5*(b_i+a_i), h = 0.5*(b_i-a_i);
+        x[offset] = m;
+        for (int j = 0; j < 7; j++) {
+            x[offset + 1 + 2*j] = m - xgk[j] * h;
+            x[offset + 2 + 2*j] = m + xgk[j] * h;
+        }
+    };
+    auto compare = [this](const size_t i, const size_t j) { return pool[i].priority < pool[j].priority; };
+
+    pool.clear();
+    heap.clear();
+
+    // first estimate on the whole interval
+    set_nodes(a, b, 0);
+    adaptive_integrator_detail::evaluate(integrand, x, 15, f);
+    n_evaluations += 15;
+    pool.emplace_back();
+    if constexpr (not std::is_same_v<error_type, double>) {
+        const error_type shape = global_adaptive_integrator_detail::component_abs(f[0]);
+        if (error_weights.size() != shape.size()) error_weights = error_type::Ones(shape.rows(), shape.cols());
+        inverse_scale = error_type::Ones(shape.rows(), shape.cols());
+    }
+    apply_rule(a, b, f, pool[0]);
+    if constexpr (not std::is_same_v<error_type, double>) {
+        // the error scale of every component is fixed by the first estimate of the integral
+        const error_type result_abs = global_adaptive_integrator_detail::component_abs(pool[0].result);
+        inverse_scale = 1. / (TOL * result_abs).max(floor(result_abs));
+        pool[0].priority = priority(pool[0].error);
+    }
+    heap.push_back(0);
+
+    Q result = pool[0].result;
+    error_type error = pool[0].error;
+
+    // bisect the interval with the largest error until the total error is small enough
+    while (not converged(result, error) and pool.size() < max_intervals and not heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), compare);
+        const size_t i_left = heap.back();
+        heap.pop_back();
+        const interval parent = pool[i_left];
+        const double m = 0.5*(parent.a + parent.b);
+        if (m - parent.a < tolerance_abs * std::max(1., std::abs(m))) continue;  // do not split if the interval is very small
+
+        set_nodes(parent.a, m, 0);
+        set_nodes(m, parent.b, 15);
+        adaptive_integrator_detail::evaluate(integrand, x, 30, f);
+        n_evaluations += 30;
+
+        const size_t i_right = pool.size();
+        pool.emplace_back();
+        apply_rule(parent.a, m, f, pool[i_left]);
+        apply_rule(m, parent.b, f + 15, pool[i_right]);
+
+        result += pool[i_left].result + pool[i_right].result - parent.result;
+        error += pool[i_left].error + pool[i_right].error - parent.error;
+
+        heap.push_back(i_left);
+        std::push_heap(heap.begin(), heap.end(), compare);
+        heap.push_back(i_right);
+        std::push_heap(heap.begin(), heap.end(), compare);
+    }
+
+    // sum up the contributions of all intervals, to avoid accumulation of rounding errors in the running sum
+    result = myzero<Q>();
+    for (const interval& I : pool) result += I.result;
+    return result;
+}
+
+// nodes of the 15-point Gauss-Kronrod rule (xgk[1], xgk[3], xgk[5], xgk[7] are the nodes of the 7-point Gauss rule)
+template <typename Integrand, typename Q>
+const double Adapt_global<Integrand,Q>::xgk[8] = {0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+                                                  0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+                                                  0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+                                                  0.207784955007898467600689403773245, 0.000000000000000000000000000000000};
+// weights of the 15-point Gauss-Kronrod rule
+template <typename Integrand, typename Q>
+const double Adapt_global<Integrand,Q>::wgk[8] = {0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+                                                  0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+                                                  0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+                                                  0.204432940075298892414161999234649, 0.209482141084727828012999174891714};
+// weights of the 7-point Gauss rule
+template <typename Integrand, typename Q>
+const double Adapt_global<Integrand,Q>::wg[4] = {0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+                                                 0.381830050505118944950369775488975, 0.417959183673469387755102040816327};
+
+
+template <typename Integrand>
+class Adapt_global_semiInfinitUpper {
+    using Q = std::result_of_t<Integrand(double)>;
+
+    const adaptive_integrator_detail::integrand_reparametrized_Upper<Integrand> integrand;
+    Adapt_global<adaptive_integrator_detail::integrand_reparametrized_Upper<Integrand>> adaptor;
+
+public:
+    Adapt_global_semiInfinitUpper(const double integrator_tol_rel, const Integrand& integrand1, const double b)
+            : integrand(integrand1, b), adaptor(integrator_tol_rel, integrand) {}
+
+    auto integrate() -> Q {
+        return adaptor.integrate(1e-14, 1.);
+    }
+};
+
+template <typename Integrand>
+class Adapt_global_semiInfinitLower {
+    using Q = std::result_of_t<Integrand(double)>;
+
+    const adaptive_integrator_detail::integrand_reparametrized_Lower<Integrand> integrand;
+    Adapt_global<adaptive_integrator_detail::integrand_reparametrized_Lower<Integrand>> adaptor;
+
+public:
+    Adapt_global_semiInfinitLower(const double integrator_tol_rel, const Integrand& integrand1, const double b)
+            : integrand(integrand1, b), adaptor(integrator_tol_rel, integrand) {}
+
+    auto integrate() -> Q {
+        return adaptor.integrate(1e-14, 1.);
+    }
+};
+
+#endif //KELDYSH_MFRG_INTEGRATOR_GLOBAL_ADAPTIVE_HPP
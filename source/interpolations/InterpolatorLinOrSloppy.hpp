@@ -2,18 +2,19 @@
 #define FPP_MFRG_INTERPOLATORLINORSLOPPY_H
 
 #include <cmath>
-#include <functional>
 #include "../grids/frequency_grid.hpp"
+#include "../multidimensional/multiarray.hpp"
 #include "../symmetries/symmetry_transformations.hpp"
 
-/// TODO: improve performance, allow more inlining
-
 /**
  * Interpolation functions:
  *  --> linear interpolation
  *  --> linear interpolation on auxiliary (linear) frequency grid
  *  --> sloppy cubic interpolation (constructs Lagrange polynomial with points at positions i-1, i, i+1 and i+2 for the
  *      interval between i and i+1)
+ *
+ * The values are fetched via the callable val, which is a template parameter (typically a lambda) such that the
+ * nested calls for 2D and 3D can be inlined. No std::function is involved.
  */
 
 
@@ -27,8 +28,8 @@
  * @param val           any function that takes one integer and returns a value of type Q
  * @return
  */
-template <typename Q, typename Grid>
-static auto interpolate_nearest1D(const double& x, const Grid& frequencies, const std::function<Q(const int&)> val) -> Q {
+template <typename Q, typename Grid, typename Fun>
+static auto interpolate_nearest1D(const double& x, const Grid& frequencies, const Fun& val) -> Q {
 
     int index = frequencies.get_grid_index(x);
 
@@ -49,10 +50,10 @@ static auto interpolate_nearest1D(const double& x, const Grid& frequencies, cons
  *                        and integer j belongs to y
  * @return
  */
-template <typename Q, typename Grid>
+template <typename Q, typename Grid, typename Fun>
 static auto interpolate_nearest2D(const double& x, const double& y,
                               const Grid& xfrequencies, const Grid& yfrequencies,
-                              const std::function<Q(const int&, const int&)> val) -> Q {
+                              const Fun& val) -> Q {
 
     int index = xfrequencies.get_grid_index(x);
 
@@ -77,10 +78,10 @@ static auto interpolate_nearest2D(const double& x, const double& y,
  *                        and integer k belongs to z
  * @return
  */
-template <typename Q, typename Grid>
+template <typename Q, typename Grid, typename Fun>
 static auto interpolate_nearest3D(const double& x, const double& y, const double& z,
                               const Grid& xfrequencies, const Grid& yfrequencies, const Grid& zfrequencies,
-                              const std::function<Q(const int&, const int&, const int&)> val) -> Q {
+                              const Fun& val) -> Q {
 
     int index = xfrequencies.get_grid_index(x);
 
@@ -90,6 +91,32 @@ static auto interpolate_nearest3D(const double& x, const double& y, const double
     return result;
 }
 
+/**
+ * Interpolates in 0th order directly on the strided memory of a multiarray, without callbacks
+ * @tparam numberFrequencyDims  number of frequency arguments (1, 2 or 3)
+ * @tparam pos_first_freqpoint  position of the first frequency index in the multiarray
+ * @tparam vecsize              number of consecutive values returned (along the innermost dimension)
+ * @param data          multiarray with the values on the frequency grid
+ * @param indices       multi-index of the requested value; the frequency indices are overwritten
+ * @param frequencies   frequency arguments
+ * @param grids         container of the frequency grids primary_grid, secondary_grid and tertiary_grid
+ * @return
+ */
+template <my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, my_index_t vecsize, typename Q, size_t rank, typename layout, typename GridContainer>
+inline auto interpolate_nearest_strided(const multidimensional::multiarray<Q,rank,layout>& data,
+                                        typename multidimensional::multiarray<Q,rank,layout>::index_type indices,
+                                        const std::array<freqType,numberFrequencyDims>& frequencies,
+                                        const GridContainer& grids) -> Eigen::Matrix<Q,vecsize,1> {
+    // look up every frequency on its own grid, like interpolate_nearest1D/2D/3D (no conversion to internal frequencies)
+    indices[pos_first_freqpoint] = grids.primary_grid.get_grid_index(frequencies[0]);
+    if constexpr(numberFrequencyDims > 1) indices[pos_first_freqpoint + 1] = grids.secondary_grid.get_grid_index(frequencies[1]);
+    if constexpr(numberFrequencyDims > 2) indices[pos_first_freqpoint + 2] = grids.tertiary_grid.get_grid_index(frequencies[2]);
+
+    const Eigen::Matrix<Q,vecsize,1> result = data.template get_values<numberFrequencyDims, pos_first_freqpoint, vecsize, 1>(indices);
+    assert(result.allFinite());
+    return result;
+}
+
 
 
 /**
@@ -101,8 +128,8 @@ static auto interpolate_nearest3D(const double& x, const double& y, const double
  * @param val           any function that takes one integer and returns a value of type Q
  * @return
  */
-template <typename Q, typename Grid>
-static auto interpolate_lin1D(const double& x, const Grid& frequencies, const std::function<Q(const int&)> val) -> Q {
+template <typename Q, typename Grid, typename Fun>
+static auto interpolate_lin1D(const double& x, const Grid& frequencies, const Fun& val) -> Q {
 
     int index = frequencies.get_grid_index(x);
 
@@ -130,10 +157,10 @@ static auto interpolate_lin1D(const double& x, const Grid& frequencies, const st
  *                        and integer j belongs to y
  * @return
  */
-template <typename Q, typename Grid>
+template <typename Q, typename Grid, typename Fun>
 static auto interpolate_lin2D(const double& x, const double& y,
                                      const Grid& xfrequencies, const Grid& yfrequencies,
-                                     const std::function<Q(const int&, const int&)> val) -> Q {
+                                     const Fun& val) -> Q {
 
     int index = xfrequencies.get_grid_index(x);
 
@@ -164,10 +191,10 @@ static auto interpolate_lin2D(const double& x, const double& y,
  *                        and integer k belongs to z
  * @return
  */
-template <typename Q, typename Grid>
+template <typename Q, typename Grid, typename Fun>
 static auto interpolate_lin3D(const double& x, const double& y, const double& z,
                                      const Grid& xfrequencies, const Grid& yfrequencies, const Grid& zfrequencies,
-                                     const std::function<Q(const int&, const int&, const int&)> val) -> Q {
+                                     const Fun& val) -> Q {
 
     int index = xfrequencies.get_grid_index(x);
 
@@ -194,8 +221,8 @@ static auto interpolate_lin3D(const double& x, const double& y, const double& z,
  * @param val           any function that takes one integer and returns a value of type Q
  * @return
  */
-template <typename Q, typename Grid>
-inline auto interpolate_lin_on_aux1D(const double& x, const Grid& frequencies, const std::function<Q(const int&)>& val) -> Q {
+template <typename Q, typename Grid, typename Fun>
+inline auto interpolate_lin_on_aux1D(const double& x, const Grid& frequencies, const Fun& val) -> Q {
 
     double t;
     const int index = frequencies.get_grid_index(t, x);
@@ -224,10 +251,10 @@ inline auto interpolate_lin_on_aux1D(const double& x, const Grid& frequencies, c
  *                        and integer j belongs to y
  * @return
  */
-template <typename Q, typename Grid>
+template <typename Q, typename Grid, typename Fun>
 inline auto interpolate_lin_on_aux2D(const double& x, const double& y,
                           const Grid& xfrequencies, const Grid& yfrequencies,
-                          const std::function<Q(const int&, const int&)>& val) -> Q {
+                          const Fun& val) -> Q {
 
     double t;
     int index = xfrequencies.get_grid_index(t, x);
@@ -259,10 +286,10 @@ inline auto interpolate_lin_on_aux2D(const double& x, const double& y,
  *                        and integer k belongs to z
  * @return
  */
-template <typename Q, typename Grid>
+template <typename Q, typename Grid, typename Fun>
 inline auto interpolate_lin_on_aux3D(const double& x, const double& y, const double& z,
                           const Grid& xfrequencies, const Grid& yfrequencies, const Grid& zfrequencies,
-                          const std::function<Q(const int&, const int&, const int&)>& val) -> Q {
+                          const Fun& val) -> Q {
 
     double t;
     int index = xfrequencies.get_grid_index(t, x);
@@ -289,8 +316,8 @@ inline auto interpolate_lin_on_aux3D(const double& x, const double& y, const dou
  * @param val           any function that takes one integer and returns a value of type Q
  * @return
  */
-template <typename Q, typename Grid>
-inline auto interpolate_sloppycubic1D(const double& x, const Grid& xfrequencies, const std::function<Q(const int&)>& val) -> Q {
+template <typename Q, typename Grid, typename Fun>
+inline auto interpolate_sloppycubic1D(const double& x, const Grid& xfrequencies, const Fun& val) -> Q {
 
     double t;
     int index = xfrequencies.get_grid_index(t, x);
@@ -326,9 +353,9 @@ inline auto interpolate_sloppycubic1D(const double& x, const Grid& xfrequencies,
  * @param val           any function that takes one integer and returns a value of type Q
  * @return
  */
-template <typename Q, typename Grid>
+template <typename Q, typename Grid, typename Fun>
 inline auto interpolate_sloppycubic2D(const double x, const double y, const Grid& xfrequencies,
-                                      const Grid& yfrequencies, const std::function<Q(const int&, const int&)>& val) -> Q {
+                                      const Grid& yfrequencies, const Fun& val) -> Q {
 
     double t;
     int index = xfrequencies.get_grid_index(t, x);
@@ -362,10 +389,10 @@ inline auto interpolate_sloppycubic2D(const double x, const double y, const Grid
  * @param val           any function that takes one integer and returns a value of type Q
  * @return
  */
-template <typename Q, typename Grid>
+template <typename Q, typename Grid, typename Fun>
 inline auto interpolate_sloppycubic3D(const double& x, const double& y, const double& z,
                                       const Grid& xfrequencies, const Grid& yfrequencies, const Grid& zfrequencies,
-                                      const std::function<Q(const int&, const int&, const int&)>& val) -> Q {
+                                      const Fun& val) -> Q {
 
     double t;
     int index = xfrequencies.get_grid_index(t, x);
@@ -73,8 +73,8 @@ public:
     using frequencies_type = std::array<double, 1>;
 
     Spline() : initialized(false) {};
-    explicit Spline(double Lambda, index_type dims)
-            :   DataContainer(Lambda, dims), n(getFlatSize(DataContainer::get_dims()))//, i_x(1)
+    explicit Spline(double Lambda, index_type dims, const fRG_config& config)
+            :   DataContainer(Lambda, dims, config), n(getFlatSize(DataContainer::get_dims()))//, i_x(1)
     {
         //this->initializeK1();
         //print("Size of all_coeffs:", all_coefficients.size(), "\n");
@@ -144,7 +144,7 @@ void Spline<Q,rank,1,pos_first_freq_index,DataContainer>::initInterpolator() con
 {
     m_b = vec<Q>(n);
 
-    multidimensional::multiarray<Q,rank> temp = DataContainer::get_deriv_x();
+    multidimensional::multiarray<Q,rank> temp = DataContainer::get_deriv_x(DataContainer::data);
     m_b = vec<Q>(temp.begin(), temp.end());
 
 
@@ -187,7 +187,7 @@ result_type Spline<Q,rank,1,pos_first_freq_index,DataContainer>::interpolate_spl
         Eigen::Matrix<Q, 1, 4> values = all_coefficients.row(i_row);
         result = (values * weights).eval()[0];
 
-        assert(isfinite(result));
+        assert(my_isfinite(result));
         return result;
     }
     else if constexpr(std::is_same_v<result_type,Eigen::Matrix<Q,result_type::RowsAtCompileTime,1>>){
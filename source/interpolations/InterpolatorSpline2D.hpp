@@ -53,8 +53,8 @@ protected:
     void get_coeffs_from_derivs() const; //const index_type& indices, double dw, double dv) const;  // calculate c_i, d_i from b_i
 public:
     Spline() : initialized(false) {};
-    explicit Spline(double Lambda, index_type dims)
-            :   DataContainer(Lambda, dims), n(getFlatSize(DataContainer::get_dims()))
+    explicit Spline(double Lambda, index_type dims, const fRG_config& config)
+            :   DataContainer(Lambda, dims, config), n(getFlatSize(DataContainer::get_dims()))
     {
         //this->initializeK2();
     }
@@ -132,9 +132,9 @@ void Spline<Q,rank,2,pos_first_freq_index,DataContainer>::initInterpolator() con
 {
 
 
-    multidimensional::multiarray<Q,rank> temp = DataContainer::get_deriv_x();
+    multidimensional::multiarray<Q,rank> temp = DataContainer::get_deriv_x(DataContainer::data);
     m_deriv_x = vec<Q>(temp.begin(), temp.end());
-    temp = DataContainer::get_deriv_y();
+    temp = DataContainer::get_deriv_y(DataContainer::data);
     m_deriv_y = vec<Q>(temp.begin(), temp.end());
     temp = DataContainer::get_deriv_xy();
     m_deriv_xy = vec<Q>(temp.begin(), temp.end());
@@ -194,7 +194,7 @@ result_type Spline<Q,rank,2,pos_first_freq_index,DataContainer>::interpolate_spl
         Eigen::Matrix<Q, 1, 16> values = all_coefficients.row(i_row);
         result = (values * weights).eval()[0];
 
-        assert(isfinite(result));
+        assert(my_isfinite(result));
         return result;
     }
     else if constexpr(std::is_same_v<result_type,Eigen::Matrix<Q,result_type::RowsAtCompileTime,1>>){
@@ -31,20 +31,40 @@ private:
 protected:
     size_t n=0;
     mutable vec<Q> m_deriv_x = vec<Q>(n),m_deriv_y= vec<Q>(n),m_deriv_z= vec<Q>(n),m_deriv_xy= vec<Q>(n),m_deriv_xz= vec<Q>(n),m_deriv_yz= vec<Q>(n),m_deriv_xyz= vec<Q>(n);        // SplineK3 coefficients
+    mutable splineStorage storage = K3_SPLINE_STORAGE;
     //Q m_c0;                            // for left extrapolation
     bd_type m_left = third_deriv, m_right = third_deriv;    /// set const?
     Q  m_left_value = 0.0, m_right_value = 0.0;   /// known values of first or second derivative (corresponding to bd_type)
     //bool m_made_monotonic = false;
     void get_coeffs_from_derivs() const;  // calculate c_i, d_i from b_i
+
+    /**
+     * Weights of the grid points i-1, ..., i+2 for the cubic Hermite interpolation at the normalized position s in [0,1]
+     * between the grid points i and i+1. The derivatives at i and i+1 are the finite differences of ::partial_deriv(),
+     * such that the result coincides with the one obtained from the stored coefficients.
+     * Weights of points outside of [0, n-1] are zero.
+     */
+    static std::array<double,4> get_hermite_weights(int i, int n, double s);
+
+    template <typename result_type>
+    result_type interpolate_on_the_fly (const std::array<my_index_t,3>& freq_idx, const std::array<double,3>& dt_unnormalized, int i_row) const;
 public:
 
     mutable bool initialized = false;
     Spline() : initialized(false) {};
-    explicit Spline(double Lambda, index_type dims) :   DataContainer(Lambda, dims), n(getFlatSize(DataContainer::get_dims())) {}
+    explicit Spline(double Lambda, index_type dims, const fRG_config& config) :   DataContainer(Lambda, dims, config), n(getFlatSize(DataContainer::get_dims())) {}
 
 
     void initInterpolator() const;
     void set_initializedInterpol(bool is_init) const {initialized = is_init;}
+    /// choose whether the coefficients are stored or the Hermite form is evaluated on the fly (requires re-initialization)
+    void set_spline_storage(splineStorage storage_new) const {storage = storage_new; initialized = false;}
+    splineStorage get_spline_storage() const {return storage;}
+    /// number of elements stored by the interpolator in addition to the data
+    size_t get_interpolator_size() const {
+        return all_coefficients.size() + m_deriv_x.size() + m_deriv_y.size() + m_deriv_z.size()
+               + m_deriv_xy.size() + m_deriv_xz.size() + m_deriv_yz.size() + m_deriv_xyz.size();
+    }
 
     Eigen::Matrix<Q,64,1> get_weights (const std::array<my_index_t,3>& freq_idx, const std::array<double,3>& dw_normalized) const;
 
@@ -171,13 +191,13 @@ void Spline<Q,rank,3,pos_first_freq_index,DataContainer>::get_coeffs_from_derivs
 
                     Eigen::Matrix<Q,64,1> _fs;
                     _fs << DataContainer::data[idx_base_base_base],   DataContainer::data[idx_plus_base_base],   DataContainer::data[idx_base_plus_base],   DataContainer::data[idx_plus_plus_base],   DataContainer::data[idx_base_base_plus],   DataContainer::data[idx_plus_base_plus],   DataContainer::data[idx_base_plus_plus],   DataContainer::data[idx_plus_plus_plus],
-                                dw * m_deriv_x[idx_base_base_base],        dw * m_deriv_x[idx_plus_base_base],        dw * m_deriv_x[idx_base_plus_base],        dw * m_deriv_x[idx_plus_plus_base],        dw * m_deriv_x[idx_base_base_plus],        dw * m_deriv_x[idx_plus_base_plus],        dw * m_deriv_x[idx_base_plus_plus],        dw * m_deriv_x[idx_plus_plus_plus],
-                                dv * m_deriv_y[idx_base_base_base],        dv * m_deriv_y[idx_plus_base_base],        dv * m_deriv_y[idx_base_plus_base],        dv * m_deriv_y[idx_plus_plus_base],        dv * m_deriv_y[idx_base_base_plus],        dv * m_deriv_y[idx_plus_base_plus],        dv * m_deriv_y[idx_base_plus_plus],        dv * m_deriv_y[idx_plus_plus_plus],
-                                dvp* m_deriv_z[idx_base_base_base],        dvp* m_deriv_z[idx_plus_base_base],        dvp* m_deriv_z[idx_base_plus_base],        dvp* m_deriv_z[idx_plus_plus_base],        dvp* m_deriv_z[idx_base_base_plus],        dvp* m_deriv_z[idx_plus_base_plus],        dvp* m_deriv_z[idx_base_plus_plus],        dvp* m_deriv_z[idx_plus_plus_plus],
-                            dw*dv * m_deriv_xy[idx_base_base_base],    dw*dv * m_deriv_xy[idx_plus_base_base],    dw*dv * m_deriv_xy[idx_base_plus_base],    dw*dv * m_deriv_xy[idx_plus_plus_base],    dw*dv * m_deriv_xy[idx_base_base_plus],    dw*dv * m_deriv_xy[idx_plus_base_plus],    dw*dv * m_deriv_xy[idx_base_plus_plus],    dw*dv * m_deriv_xy[idx_plus_plus_plus],
-                            dw*dvp* m_deriv_xz[idx_base_base_base],    dw*dvp* m_deriv_xz[idx_plus_base_base],    dw*dvp* m_deriv_xz[idx_base_plus_base],    dw*dvp* m_deriv_xz[idx_plus_plus_base],    dw*dvp* m_deriv_xz[idx_base_base_plus],    dw*dvp* m_deriv_xz[idx_plus_base_plus],    dw*dvp* m_deriv_xz[idx_base_plus_plus],    dw*dvp* m_deriv_xz[idx_plus_plus_plus],
-                            dv*dvp* m_deriv_yz[idx_base_base_base],    dv*dvp* m_deriv_yz[idx_plus_base_base],    dv*dvp* m_deriv_yz[idx_base_plus_base],    dv*dvp* m_deriv_yz[idx_plus_plus_base],    dv*dvp* m_deriv_yz[idx_base_base_plus],    dv*dvp* m_deriv_yz[idx_plus_base_plus],    dv*dvp* m_deriv_yz[idx_base_plus_plus],    dv*dvp* m_deriv_yz[idx_plus_plus_plus],
-                        dw*dv*dvp* m_deriv_xyz[idx_base_base_base],dw*dv*dvp* m_deriv_xyz[idx_plus_base_base],dw*dv*dvp* m_deriv_xyz[idx_base_plus_base],dw*dv*dvp* m_deriv_xyz[idx_plus_plus_base],dw*dv*dvp* m_deriv_xyz[idx_base_base_plus],dw*dv*dvp* m_deriv_xyz[idx_plus_base_plus],dw*dv*dvp* m_deriv_xyz[idx_base_plus_plus],dw*dv*dvp* m_deriv_xyz[idx_plus_plus_plus];
+                                m_deriv_x[idx_base_base_base],        m_deriv_x[idx_plus_base_base],        m_deriv_x[idx_base_plus_base],        m_deriv_x[idx_plus_plus_base],        m_deriv_x[idx_base_base_plus],        m_deriv_x[idx_plus_base_plus],        m_deriv_x[idx_base_plus_plus],        m_deriv_x[idx_plus_plus_plus],
+                                m_deriv_y[idx_base_base_base],        m_deriv_y[idx_plus_base_base],        m_deriv_y[idx_base_plus_base],        m_deriv_y[idx_plus_plus_base],        m_deriv_y[idx_base_base_plus],        m_deriv_y[idx_plus_base_plus],        m_deriv_y[idx_base_plus_plus],        m_deriv_y[idx_plus_plus_plus],
+                                m_deriv_z[idx_base_base_base],        m_deriv_z[idx_plus_base_base],        m_deriv_z[idx_base_plus_base],        m_deriv_z[idx_plus_plus_base],        m_deriv_z[idx_base_base_plus],        m_deriv_z[idx_plus_base_plus],        m_deriv_z[idx_base_plus_plus],        m_deriv_z[idx_plus_plus_plus],
+                            m_deriv_xy[idx_base_base_base],    m_deriv_xy[idx_plus_base_base],    m_deriv_xy[idx_base_plus_base],    m_deriv_xy[idx_plus_plus_base],    m_deriv_xy[idx_base_base_plus],    m_deriv_xy[idx_plus_base_plus],    m_deriv_xy[idx_base_plus_plus],    m_deriv_xy[idx_plus_plus_plus],
+                            m_deriv_xz[idx_base_base_base],    m_deriv_xz[idx_plus_base_base],    m_deriv_xz[idx_base_plus_base],    m_deriv_xz[idx_plus_plus_base],    m_deriv_xz[idx_base_base_plus],    m_deriv_xz[idx_plus_base_plus],    m_deriv_xz[idx_base_plus_plus],    m_deriv_xz[idx_plus_plus_plus],
+                            m_deriv_yz[idx_base_base_base],    m_deriv_yz[idx_plus_base_base],    m_deriv_yz[idx_base_plus_base],    m_deriv_yz[idx_plus_plus_base],    m_deriv_yz[idx_base_base_plus],    m_deriv_yz[idx_plus_base_plus],    m_deriv_yz[idx_base_plus_plus],    m_deriv_yz[idx_plus_plus_plus],
+                        m_deriv_xyz[idx_base_base_base],m_deriv_xyz[idx_plus_base_base],m_deriv_xyz[idx_base_plus_base],m_deriv_xyz[idx_plus_plus_base],m_deriv_xyz[idx_base_base_plus],m_deriv_xyz[idx_plus_base_plus],m_deriv_xyz[idx_base_plus_plus],m_deriv_xyz[idx_plus_plus_plus];
                     all_coefficients.row(idx_base_base_base) = (A * _fs).transpose();
 
                     for (int i1 = 0; i1 < 4; i1++) {
@@ -196,11 +216,18 @@ void Spline<Q,rank,3,pos_first_freq_index,DataContainer>::get_coeffs_from_derivs
 template <typename Q, size_t rank, my_index_t pos_first_freq_index, class DataContainer>
 void Spline<Q,rank,3,pos_first_freq_index,DataContainer>::initInterpolator() const
 {
-    multidimensional::multiarray<Q,rank> temp = DataContainer::get_deriv_x();
+    if (storage == spline_on_the_fly) {
+        // nothing to precompute; release the memory of a previous initialization with stored coefficients
+        all_coefficients = coeffs_type(0,64);
+        initialized = true;
+        return;
+    }
+
+    multidimensional::multiarray<Q,rank> temp = DataContainer::get_deriv_x(DataContainer::data);
     m_deriv_x =  vec<Q>(temp.begin(), temp.end());
-    temp =  DataContainer::get_deriv_y();
+    temp =  DataContainer::get_deriv_y(DataContainer::data);
     m_deriv_y =  vec<Q>(temp.begin(), temp.end());
-    temp =  DataContainer::get_deriv_z();
+    temp =  DataContainer::get_deriv_z(DataContainer::data);
     m_deriv_z =  vec<Q>(temp.begin(), temp.end());
     temp = DataContainer::get_deriv_xy();
     m_deriv_xy = vec<Q>(temp.begin(), temp.end());
@@ -214,6 +241,9 @@ void Spline<Q,rank,3,pos_first_freq_index,DataContainer>::initInterpolator() con
     all_coefficients = coeffs_type(n,64);
     get_coeffs_from_derivs();
 
+    // the derivatives are only needed to compute the coefficients
+    m_deriv_x = vec<Q>(); m_deriv_y = vec<Q>(); m_deriv_z = vec<Q>();
+    m_deriv_xy = vec<Q>(); m_deriv_xz = vec<Q>(); m_deriv_yz = vec<Q>(); m_deriv_xyz = vec<Q>();
 
     initialized = true;
 }
@@ -256,6 +286,8 @@ result_type Spline<Q,rank,3,pos_first_freq_index,DataContainer>::interpolate_spl
     index_temp[pos_first_freq_index+2] = freq_idx[2];
     const int i_row = getFlatIndex<rank>(index_temp, DataContainer::get_dims());
 
+    if (storage == spline_on_the_fly) return interpolate_on_the_fly<result_type>(freq_idx, dt_unnormalized, i_row);
+
     Eigen::Matrix<Q,64,1> weights = get_weights(freq_idx, dt_unnormalized);
 
     if constexpr(std::is_same_v<result_type,Q>) {
@@ -264,7 +296,7 @@ result_type Spline<Q,rank,3,pos_first_freq_index,DataContainer>::interpolate_spl
         Eigen::Matrix<Q, 1, 64> values = all_coefficients.row(i_row);
         result = (values * weights).eval()[0];
 
-        assert(isfinite(result));
+        assert(my_isfinite(result));
         return result;
     }
     else if constexpr(std::is_same_v<result_type,Eigen::Matrix<Q,result_type::RowsAtCompileTime,1>>){
@@ -284,6 +316,76 @@ result_type Spline<Q,rank,3,pos_first_freq_index,DataContainer>::interpolate_spl
 
 
 
+template <typename Q, size_t rank, my_index_t pos_first_freq_index, class DataContainer>
+std::array<double,4> Spline<Q,rank,3,pos_first_freq_index,DataContainer>::get_hermite_weights(const int i, const int n, const double s) {
+    assert(n > 2);
+    const double h00 = (1. + 2.*s) * (1. - s) * (1. - s);
+    const double h10 = s * (1. - s) * (1. - s);
+    const double h01 = s * s * (3. - 2.*s);
+    const double h11 = s * s * (s - 1.);
+
+    std::array<double,4> weights = {0., h00, h01, 0.};  // grid points i-1, i, i+1, i+2
+    // adds the finite-difference stencil of the derivative at grid point m (cf. ::partial_deriv()), multiplied by h
+    auto add_derivative = [&](const int m, const double h) {
+        const int offset = 1 - i;
+        if (m == 0) {
+            weights[m   + offset] += -1.5 * h;
+            weights[m+1 + offset] +=  2.  * h;
+            weights[m+2 + offset] += -0.5 * h;
+        }
+        else if (m == n-1) {
+            weights[m-2 + offset] +=  0.5 * h;
+            weights[m-1 + offset] += -2.  * h;
+            weights[m   + offset] +=  1.5 * h;
+        }
+        else {
+            weights[m-1 + offset] += -0.5 * h;
+            weights[m+1 + offset] +=  0.5 * h;
+        }
+    };
+    add_derivative(i  , h10);
+    add_derivative(i+1, h11);
+    return weights;
+}
+
+template <typename Q, size_t rank, my_index_t pos_first_freq_index, class DataContainer>
+template <typename result_type>
+result_type Spline<Q,rank,3,pos_first_freq_index,DataContainer>::interpolate_on_the_fly(const std::array<my_index_t,3>& freq_idx, const std::array<double,3>& dt_unnormalized, const int i_row) const {
+    const index_type& dims = DataContainer::get_dims();
+    std::array<std::array<double,4>,3> weights;
+    std::array<int,3> strides;
+    for (int d = 0; d < 3; d++) {
+        const auto& grid = d == 0 ? DataContainer::frequencies.primary_grid : (d == 1 ? DataContainer::frequencies.secondary_grid : DataContainer::frequencies.tertiary_grid);
+        const int i = freq_idx[d];
+        const double h = grid.get_auxiliary_gridpoint(i+1) - grid.get_auxiliary_gridpoint(i);
+        weights[d] = get_hermite_weights(i, dims[pos_first_freq_index+d], dt_unnormalized[d] / h);
+        strides[d] = 1;
+        for (size_t r = pos_first_freq_index+d+1; r < rank; r++) strides[d] *= dims[r];
+    }
+    const Q* data = DataContainer::data.data();
+
+    constexpr int n_values = [] {
+        if constexpr(std::is_same_v<result_type,Q>) return 1;
+        else return result_type::RowsAtCompileTime;
+    }();
+    Eigen::Matrix<Q,n_values,1> result = Eigen::Matrix<Q,n_values,1>::Zero();
+    for (int a = 0; a < 4; a++) {
+        if (weights[0][a] == 0.) continue;
+        for (int b = 0; b < 4; b++) {
+            const double w_ab = weights[0][a] * weights[1][b];
+            if (w_ab == 0.) continue;
+            for (int c = 0; c < 4; c++) {
+                if (weights[2][c] == 0.) continue;
+                const int i_point = i_row + (a-1)*strides[0] + (b-1)*strides[1] + (c-1)*strides[2];
+                result += (w_ab * weights[2][c]) * Eigen::Map<const Eigen::Matrix<Q,n_values,1>>(data + i_point);
+            }
+        }
+    }
+
+    assert(result.allFinite());
+    if constexpr(std::is_same_v<result_type,Q>) return result[0];
+    else return result;
+}
 
 
 
@@ -61,6 +61,8 @@ class IntegrandSE {
 
     return_type Keldysh_value(double vp) const;
     Q Matsubara_value(double vp) const;
+    return_type contract_Keldysh(const buffertype_propagator& G1, const buffertype_propagator& G2,
+                                 const buffertype_vertex& V1, const buffertype_vertex& V2) const;
 
     void evaluate_propagator(Q& Gi, const int iK, const double vp) const;
     void evaluate_propagator(Q& GM, const double vp) const; // Matsubara version
@@ -111,6 +113,16 @@ public:
      */
     auto operator()(double vp) const -> return_type;
 
+    /**
+     * Batched call operator, used by the adaptive integrator (see Adapt):
+     * The propagators and the vertex are interpolated for all frequencies of the batch in separate loops before the
+     * results are contracted.
+     * @param vp  : frequencies at which to evaluate the integrand
+     * @param n   : number of frequencies
+     * @param out : values of the integrand at the frequencies vp
+     */
+    void evaluate_batch(const double* vp, int n, return_type* out) const;
+
     void save_integrand() const;
     void save_integrand(const rvec& freqs, const std::string& filename_prefix) const;
     void get_integrand_vals(const rvec& freqs, Eigen::Matrix<Q,Eigen::Dynamic,Eigen::Dynamic>& integrand_vals, Eigen::Matrix<Q,Eigen::Dynamic,Eigen::Dynamic>& vertex_vals)  const;
@@ -227,6 +239,33 @@ auto IntegrandSE<Q,vertType,all_spins,return_type,version>::operator()(const dou
     else{return Matsubara_value(vp);}
 }
 
+template<typename Q, typename vertType, bool all_spins, typename return_type, bool version>
+void IntegrandSE<Q,vertType,all_spins,return_type,version>::evaluate_batch(const double* vp, const int n, return_type* out) const {
+#if SWITCH_SUM_N_INTEGRAL
+    if constexpr(KELDYSH) {
+        constexpr int chunk_size = 16; // fixed-size buffers, the adaptive integrator uses at most 13 frequencies at once
+        std::array<buffertype_propagator, chunk_size> G1, G2;
+        std::array<buffertype_vertex, chunk_size> V1, V2;
+        for (int first = 0; first < n; first += chunk_size) {
+            const int m = std::min(chunk_size, n - first);
+            for (int i = 0; i < m; i++) {
+                G1[i] = evaluate_propagator_vectorized( vp[first + i]);
+                G2[i] = evaluate_propagator_vectorized(-vp[first + i]);
+            }
+            for (int i = 0; i < m; i++) {
+                V1[i] = evaluate_vertex_vectorized( vp[first + i]);
+                V2[i] = evaluate_vertex_vectorized(-vp[first + i]);
+            }
+            for (int i = 0; i < m; i++) {
+                out[first + i] = contract_Keldysh(G1[i], G2[i], V1[i], V2[i]);
+            }
+        }
+        return;
+    }
+#endif
+    for (int i = 0; i < n; i++) out[i] = (*this)(vp[i]);
+}
+
 template<typename Q, typename vertType, bool all_spins, typename return_type, bool version>
 void IntegrandSE<Q,vertType,all_spins,return_type,version>::get_integrand_vals(const rvec& freqs, Eigen::Matrix<Q,Eigen::Dynamic,Eigen::Dynamic>& integrand_vals, Eigen::Matrix<Q,Eigen::Dynamic,Eigen::Dynamic>& vertex_vals) const {
     int npoints = freqs.size();
@@ -290,6 +329,7 @@ void IntegrandSE<Q,vertType,all_spins,return_type,version>::save_integrand(const
 
     utils::print("saving integrand to file ", filename, "\n");
     if (mpi_world_rank() == 0) {
+        std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
         H5::H5File file = H5::H5File(filename, H5F_ACC_TRUNC);
         write_to_hdf(file, "v", freqs, false);
         write_to_hdf(file, "integrand", integrand_vals, false);
@@ -307,6 +347,24 @@ auto IntegrandSE<Q,vertType,all_spins,return_type,version>::Keldysh_value(const
     buffertype_vertex V1 = evaluate_vertex_vectorized( vp);
     buffertype_vertex V2 = evaluate_vertex_vectorized(-vp);
 
+    return contract_Keldysh(G1, G2, V1, V2);
+
+#else
+    Q Gi, Gi2;
+    evaluate_propagator(Gi , iK, vp);
+    evaluate_propagator(Gi2, iK,-vp);
+
+    Q factorClosedAbove, factorClosedAbove2;
+    evaluate_vertex(factorClosedAbove,  iK, vp);
+    evaluate_vertex(factorClosedAbove2, iK,-vp);
+    return (Gi * factorClosedAbove +  Gi2 * factorClosedAbove2) * 0.5;
+#endif  // SWITCH_SUM_N_INTEGRAL
+
+}
+
+template<typename Q, typename vertType, bool all_spins, typename return_type, bool version>
+auto IntegrandSE<Q,vertType,all_spins,return_type,version>::contract_Keldysh(const buffertype_propagator& G1, const buffertype_propagator& G2,
+                                                                             const buffertype_vertex& V1, const buffertype_vertex& V2) const -> return_type {
 if constexpr(std::is_same_v<return_type,double> or std::is_same_v<return_type,comp>) {
     const return_type result = (G1*V1 + G2*V2).eval()[0] * 0.5;
     return result;
@@ -322,18 +380,6 @@ else {
         return result;
     }
 }
-
-#else
-    Q Gi, Gi2;
-    evaluate_propagator(Gi , iK, vp);
-    evaluate_propagator(Gi2, iK,-vp);
-
-    Q factorClosedAbove, factorClosedAbove2;
-    evaluate_vertex(factorClosedAbove,  iK, vp);
-    evaluate_vertex(factorClosedAbove2, iK,-vp);
-    return (Gi * factorClosedAbove +  Gi2 * factorClosedAbove2) * 0.5;
-#endif  // SWITCH_SUM_N_INTEGRAL
-
 }
 
 template<typename Q, typename vertType, bool all_spins, typename return_type, bool version>
@@ -24,7 +24,7 @@
 auto main(int argc, char * argv[]) -> int {
 #ifdef USE_MPI
     if (MPI_FLAG) {
-        MPI_Init(nullptr, nullptr);
+        mpi_init_funneled(); // only the master thread communicates via MPI
     }
 #endif
     double t_start = utils::get_time();
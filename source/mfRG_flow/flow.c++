@@ -21,6 +21,11 @@ State<state_datatype> n_loop_flow(const std::string& outputFileName, const fRG_c
         state_ini.config.nODE_ = frgConfig.nODE_;
         state_ini.config.epsODE_abs_ = frgConfig.epsODE_abs_;
         state_ini.config.epsODE_rel_ = frgConfig.epsODE_rel_;
+#ifndef ADAPTIVE_GRID
+        // rescale the grids as after the step in the interrupted flow (the state is stored before, see postRKstep_stuff),
+        // such that the side files of the interrupted step belong to the restarted state
+        if (MIDSTEP_CHECKPOINTS and Lambda_it > 0) state_ini.update_grid(Lambda_now);
+#endif
     }
     else {
         // start new run
@@ -69,10 +74,12 @@ State<state_datatype> n_loop_flow(const std::string& outputFileName, const fRG_c
 #endif
 
     if constexpr (REG != 5) compare_with_FDTs(state_ini.vertex, Lambda_ini, 0, outputFileName, frgConfig, false, frgConfig.nODE_ + U_NRG.size() + 1);
+    if (VERBOSE or NUMA_FIRST_TOUCH) state_ini.vertex.half1().print_page_placement();
 
     std::vector<double> Lambda_checkpoints = flowgrid::get_Lambda_checkpoints(U_NRG, frgConfig);
 
     rhs_n_loop_flow_t<state_datatype> rhs_mfrg(frgConfig);
+    if constexpr (MIDSTEP_CHECKPOINTS) rhs_mfrg.checkpoint_config.filename = outputFileName + "_RHS_checkpoint";
     ODE_solver_config config;// = ODE_solver_config_standard;
     config.lambda_checkpoints = Lambda_checkpoints;
     config.filename = outputFileName;
@@ -92,6 +99,7 @@ State<state_datatype> n_loop_flow(const std::string& outputFileName, const fRG_c
 
     double t_start = utils::get_time();
     ode_solver<State<state_datatype>, param>(state_fin, state_ini, rhs_mfrg, config, true);
+    rhs_mfrg.remove_checkpoints();
     utils::print("CPU hours for fRG run: \t ");
     utils::get_cpu_hours(t_start);
 
@@ -122,11 +130,17 @@ State<state_datatype> n_loop_flow(const std::string& inputFileName, const fRG_co
         write_state_to_hdf(inputFileName, Lambda_ini,  frgConfig.nODE_ + U_NRG.size() + 1, state_ini);  // save the initial state to hdf5 file
 
         double Lambda_now = state_ini.Lambda;
+#ifndef ADAPTIVE_GRID
+        // rescale the grids as after the step in the interrupted flow (the state is stored before, see postRKstep_stuff),
+        // such that the side files of the interrupted step belong to the restarted state
+        if (MIDSTEP_CHECKPOINTS and it_start > 0) state_ini.update_grid(Lambda_now);
+#endif
         State<state_datatype> state_fin (Lambda_fin, frgConfig);
 
         std::vector<double> Lambda_checkpoints = flowgrid::get_Lambda_checkpoints(U_NRG, frgConfig);
 
         rhs_n_loop_flow_t<state_datatype> rhs_mfrg(frgConfig);
+        if constexpr (MIDSTEP_CHECKPOINTS) rhs_mfrg.checkpoint_config.filename = inputFileName + "_RHS_checkpoint";
         ODE_solver_config config;
         config.iter_start = it_start;
         config.lambda_checkpoints = Lambda_checkpoints;
@@ -143,6 +157,7 @@ State<state_datatype> n_loop_flow(const std::string& inputFileName, const fRG_co
 #endif
              // compute the flow using an ODE solver
         ode_solver<State<state_datatype>, param>(state_fin, state_ini, rhs_mfrg, config, true);
+        rhs_mfrg.remove_checkpoints();
 
         std::string filename_result = inputFileName + "_final";
         write_state_to_hdf(filename_result, Lambda_ini,   1, state_fin);  // save the initial state to hdf5 file
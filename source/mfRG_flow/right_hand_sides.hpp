@@ -134,9 +134,11 @@ struct mfRG_stats {
     int number_of_SE_iterations = 0;
     double time = 0.;
     int RKattempts = 0;
+    int RHS_evaluations = 0;
 
     void write_to_hdf(const std::string& filename, const fRG_config& config, const int Lambda_it) const {
         if (mpi_world_rank() == 0) {
+            std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
             const std::size_t numberLambda_layers = config.nODE_ + U_NRG.size() + 1;
             H5::H5File file = open_hdf_file_readWrite(filename);
 
@@ -150,7 +152,8 @@ struct mfRG_stats {
 
             write_to_hdf_LambdaLayer(group_stats, "SE_iterations", vec<int>({number_of_SE_iterations}), Lambda_it, numberLambda_layers, data_set_exists);
             write_to_hdf_LambdaLayer(group_stats, "time_for_mfRG_Eqs", vec<double>({time}), Lambda_it, numberLambda_layers, data_set_exists);
-            write_to_hdf_LambdaLayer(group_stats, "RK_attempts", vec<double>({time}), Lambda_it, numberLambda_layers, data_set_exists);
+            write_to_hdf_LambdaLayer(group_stats, "RK_attempts", vec<int>({RKattempts}), Lambda_it, numberLambda_layers, data_set_exists);
+            write_to_hdf_LambdaLayer(group_stats, "RHS_evaluations", vec<int>({RHS_evaluations}), Lambda_it, numberLambda_layers, data_set_exists);
 
             file.close();
         }
@@ -158,6 +161,66 @@ struct mfRG_stats {
 };
 
 
+/// Side files of the multiloop right-hand side and the evaluation they belong to (see rhs_checkpoint)
+struct rhs_checkpoint_config {
+    std::string filename;   // prefix of the side files; none are used if empty
+    int stage = 0;          // stage of the Runge-Kutta step (set by the ODE solver)
+    int method = 0;         // Runge-Kutta method, see ODE_solverType (set by the ODE solver)
+};
+
+/**
+ * Side files of the multiloop right-hand side (see MIDSTEP_CHECKPOINTS). After every completed loop order, the
+ * contributions of this loop order are stored in a separate file, such that an interrupted evaluation can be resumed
+ * after the last completed loop order, with the same mfRG_record as an uninterrupted evaluation. A file belongs to the
+ * evaluation at Lambda with the argument Psi (identified by its norm), at the given stage of the given Runge-Kutta
+ * method, and to its loop order. Only the first self-energy iteration is stored, since the later ones depend on the
+ * history of the Anderson acceleration.
+ * Lambda layers of the file of loop order 1: 0: dPsi_1loop; of loop order 2: 0: dGammaL, 1: dGammaR; of loop order
+ * i >= 3: 0: dGammaL, 1: dGammaR, 2: dGammaC_l, 3: dGammaC_r (as in the mfRG_record), 4: dGammaC.
+ */
+template <typename Q>
+class rhs_checkpoint {
+    std::string filename;
+    std::vector<double> id; // Lambda, norm of Psi, stage, method
+public:
+    int loops_completed = 0;        // number of consecutive loop orders found in the side files
+
+    rhs_checkpoint(const rhs_checkpoint_config& config, const State<Q>& Psi, const double Lambda, const int nloops_max) : filename(config.filename) {
+        if (filename == "") return;
+        id = {Lambda, Psi.norm(), (double) config.stage, (double) config.method};
+        const auto agrees = [](const double a, const double b) { return std::abs(a - b) <= 1e-10 * (std::abs(a) + std::abs(b)); };
+        std::vector<double> info;
+        while (loops_completed < nloops_max and read_checkpoint_info_from_hdf(file_name(filename, loops_completed + 1), info)) {
+            if (info.size() != 5 or not agrees(info[0], id[0]) or not agrees(info[1], id[1])) break;
+            if (info[2] != id[2] or info[3] != id[3] or info[4] != (double) (loops_completed + 1)) break;
+            loops_completed++;
+        }
+        if (loops_completed > 0) utils::print("Resuming the right-hand side at Lambda = ", Lambda, " after ", loops_completed, " loops.\n");
+#ifdef USE_MPI
+        MPI_Barrier(MPI_COMM_WORLD); // all processes have taken the decision before the side files are overwritten
+#endif
+    }
+
+    /// Name of the side file of the given loop order
+    static std::string file_name(const std::string& filename, const int loop) {
+        return filename + "_loop" + std::to_string(loop);
+    }
+
+    /// Vertex stored in the given Lambda layer of the file of the given loop order, completed by the non-differentiated vertex
+    template <typename Vertex_t>
+    Vertex_t read_vertex(const int loop, const int layer, const Vertex<Q,false>& vertex_nondiff) const {
+        return Vertex_t(read_state_from_hdf(file_name(filename, loop), layer).vertex.half1(), vertex_nondiff);
+    }
+
+    /// Stores the contributions of the given loop order, in the Lambda layers described above
+    template <typename... States>
+    void save(const int loop, States&&... states) const {
+        if (filename == "") return;
+        write_checkpoint_to_hdf_async(file_name(filename, loop), {id[0], id[1], id[2], id[3], (double) loop}, std::forward<States>(states)...);
+    }
+};
+
+
 /**
  * Function which implements the rhs of an n-loop flow.
  * @tparam Q Type of the data
@@ -167,10 +230,11 @@ struct mfRG_stats {
  * @param opt Options specifying the iteration number and the Runge-Kutta step of that specific iteration.
  * @param config Set of parameters
  * @param stats Struct to hold some statistics from the flow, such as the number of self-energy iterations required for convergence.
+ * @param checkpoint_config Side files for the completed loop orders (see rhs_checkpoint). No side files are used if the filename is empty.
  * @return A new state from the evaluation of the RHS of the flow equation.
  */
 template <typename Q>
-auto rhs_n_loop_flow(const State<Q>& Psi, const double Lambda, const int nloops_max, const vec<size_t> opt, const fRG_config& config, mfRG_stats& stats) -> State<Q>{  //, const bool save_intermediate=false
+auto rhs_n_loop_flow(const State<Q>& Psi, const double Lambda, const int nloops_max, const vec<size_t> opt, const fRG_config& config, mfRG_stats& stats, const rhs_checkpoint_config& checkpoint_config = {}) -> State<Q>{  //, const bool save_intermediate=false
 
     Psi.vertex.check_symmetries("Psi");
     assert(nloops_max>=1);
@@ -217,9 +281,16 @@ auto rhs_n_loop_flow(const State<Q>& Psi, const double Lambda, const int nloops_
     /// for Anderson acceleration:
     std::deque<State<Q,true>> rhs_evals;             // dSigma according to evaluation of mfRG equations
     std::deque<State<Q,true>> iteration_steps;       // accepted dPsi.selfenergy's
+    /// completed loop orders of an interrupted evaluation:
+    const rhs_checkpoint<Q> checkpoint(checkpoint_config, Psi, Lambda, nloops_max);
 #if SELF_ENERGY_FLOW_CORRECTIONS != 0
     do {
 #endif
+    const bool use_checkpoint = counter_Selfenergy_iterations == 0;
+    const int loops_restored = use_checkpoint ? checkpoint.loops_completed : 0;
+    const auto as_state = [&](const auto& vertex) {
+        return State<Q,true>(Vertex<Q,true>(vertex.half1(), Psi.vertex), dPsi.selfenergy, Psi.config, Lambda);
+    };
 
 #if not defined BARE_SE_FEEDBACK and not defined PT2_FLOW
 #ifdef KATANIN
@@ -239,6 +310,8 @@ auto rhs_n_loop_flow(const State<Q>& Psi, const double Lambda, const int nloops_
 
 
     if (VERBOSE) utils::print("Compute 1-loop contribution: ", true);
+    if (loops_restored >= 1) dPsi.vertex = checkpoint.template read_vertex<Vertex<Q,true>>(1, 0, Psi.vertex);
+    else {
 #ifdef PT2_FLOW
     State<Q> bareState = State<Q> (Psi.Lambda, Psi.config); // shall and forever will be a bare state.
     bareState.initialize(false);  // a state with a bare vertex and a self-energy initialized at the Hartree value
@@ -246,6 +319,8 @@ auto rhs_n_loop_flow(const State<Q>& Psi, const double Lambda, const int nloops_
 #else
     vertexOneLoopFlow(dPsi.vertex, Psi.vertex, dPi, config);
 #endif
+    if (use_checkpoint) checkpoint.save(1, dPsi);
+    }
     mfRG_record<Q> record_of_intermediate_results{.dPsi_1loop = dPsi};
     record_of_intermediate_results.dPsi_1loop = dPsi;
 #if DEBUG_SYMMETRIES
@@ -283,14 +358,14 @@ auto rhs_n_loop_flow(const State<Q>& Psi, const double Lambda, const int nloops_
         dGamma_1loop.save_expanded(data_dir + "dPsi_irr_symmetry_expanded_for_t_left_");
 #endif
         if (VERBOSE) utils::print("Compute dGammaL (2-loop): ", true);
-        Vertex<Q,true> dGammaL_half1 = calculate_dGammaL(dGamma_1loop, Psi.vertex, Pi, config);
+        Vertex<Q,true> dGammaL_half1 = loops_restored >= 2 ? checkpoint.template read_vertex<Vertex<Q,true>>(2, 0, Psi.vertex) : calculate_dGammaL(dGamma_1loop, Psi.vertex, Pi, config);
         if(VERBOSE) {
             dGammaL_half1.half1().check_vertex_resolution();
             compare_with_FDTs(dGammaL_half1, Lambda, iteration, "dGammaL_RKstep"+std::to_string(rkStep)+"_forLoop"+std::to_string(2), Psi.config, false, config.nODE_ + U_NRG.size() + 1);
         }
 
         if (VERBOSE) utils::print("Compute dGammaR (2-loop):", true);
-        Vertex<Q,true> dGammaR_half1 = calculate_dGammaR(dGamma_1loop, Psi.vertex, Pi, config);
+        Vertex<Q,true> dGammaR_half1 = loops_restored >= 2 ? checkpoint.template read_vertex<Vertex<Q,true>>(2, 1, Psi.vertex) : calculate_dGammaR(dGamma_1loop, Psi.vertex, Pi, config);
         if(VERBOSE) {
             dGammaR_half1.half1().check_vertex_resolution();
         }
@@ -307,6 +382,9 @@ auto rhs_n_loop_flow(const State<Q>& Psi, const double Lambda, const int nloops_
         // acc. to symmetry relations (enforce_symmetry() assumes full symmetry)
         dGammaL_half1.half1().reorder_due2antisymmetry(dGammaR_half1.half1());
     }
+        if (use_checkpoint and loops_restored < 2) {
+            checkpoint.save(2, as_state(record_of_intermediate_results.dGamma_L_nloop.back()), as_state(record_of_intermediate_results.dGamma_R_nloop.back()));
+        }
 
 
 
@@ -324,6 +402,28 @@ auto rhs_n_loop_flow(const State<Q>& Psi, const double Lambda, const int nloops_
             double rel_loop = 1;
             for (int i = 3; i <= nloops_max; i++) {
 
+                if (i <= loops_restored) {
+                    // contributions of a loop order completed in an interrupted evaluation, summed up as below
+                    record_of_intermediate_results.dGamma_Cr_nloop.push_back(checkpoint.template read_vertex<Vertex<Q,true>>(i, 3, Psi.vertex));
+                    record_of_intermediate_results.dGamma_Cl_nloop.push_back(checkpoint.template read_vertex<Vertex<Q,true>>(i, 2, Psi.vertex));
+                    const Vertex<Q,true> dGammaC = checkpoint.template read_vertex<Vertex<Q,true>>(i, 4, Psi.vertex);
+                    dGammaL_half1 = checkpoint.template read_vertex<Vertex<Q,true>>(i, 0, Psi.vertex);
+                    dGammaR_half1 = checkpoint.template read_vertex<Vertex<Q,true>>(i, 1, Psi.vertex);
+                    record_of_intermediate_results.dGamma_L_nloop.push_back(dGammaL_half1);
+                    record_of_intermediate_results.dGamma_R_nloop.push_back(dGammaR_half1);
+
+                    dGammaT = dGammaL_half1 + dGammaC + dGammaR_half1;
+                    dPsi.vertex += dGammaT;
+                    if constexpr (not DEBUG_SYMMETRIES) dGammaL_half1.half1().reorder_due2antisymmetry(dGammaR_half1.half1());
+#if SELF_ENERGY_FLOW_CORRECTIONS != 0
+                    dGammaC_tbar += GeneralVertex<Q, symmetric_r_irred,true>(dGammaC.half1(), Psi.vertex);
+#endif
+                    abs_loop = dGammaT.norm();
+                    rel_loop = dGammaT.norm() / dPsi.vertex.norm();
+                    if (abs_loop < loop_tol_abs or rel_loop < loop_tol_rel) break;
+                    continue;
+                }
+
 
                 // create non-symmetric_full vertex with differentiated vertex on the left (full dGammaL, containing half 1 and 2)
                 // assign half 1 to dGammaL
@@ -432,6 +532,10 @@ auto rhs_n_loop_flow(const State<Q>& Psi, const double Lambda, const int nloops_
 
                 utils::print("Rel. contribution from loop ", i, ": ", rel_loop*100, " %\n");
                 utils::print("Abs. contribution from loop ", i, ": ", abs_loop, "\n");
+                if (use_checkpoint) {
+                    checkpoint.save(i, as_state(record_of_intermediate_results.dGamma_L_nloop.back()), as_state(record_of_intermediate_results.dGamma_R_nloop.back()),
+                                    as_state(record_of_intermediate_results.dGamma_Cl_nloop.back()), as_state(record_of_intermediate_results.dGamma_Cr_nloop.back()), as_state(dGammaC));
+                }
                 if (abs_loop < loop_tol_abs or rel_loop < loop_tol_rel) break;
 
             }
@@ -562,12 +666,21 @@ public:
     mutable mfRG_stats stats;
     const fRG_config& frgConfig;
     const int nloops = frgConfig.nloops;
+    mutable rhs_checkpoint_config checkpoint_config;    // side files for the completed loop orders (see MIDSTEP_CHECKPOINTS); none if the filename is empty
 
     rhs_n_loop_flow_t(const fRG_config& config) : frgConfig(config) {};
 
+    /// Removes the side files of the completed loop orders (after the flow has been completed)
+    void remove_checkpoints() const {
+        if (checkpoint_config.filename == "" or mpi_world_rank() != 0) return;
+        if constexpr (ASYNC_CHECKPOINTS) async_checkpoints().wait(); // a pending write would recreate a side file
+        for (int loop = 1; loop <= nloops; loop++) std::remove(rhs_checkpoint<Q>::file_name(checkpoint_config.filename, loop).c_str());
+    }
+
     void operator() (const State<Q>& Psi, State<Q>& dState_dLambda,  const double Lambda) const {
-        dState_dLambda = rhs_n_loop_flow(Psi, Lambda, nloops, vec<size_t>({iteration, rk_step}), frgConfig, stats);
+        dState_dLambda = rhs_n_loop_flow(Psi, Lambda, nloops, vec<size_t>({iteration, rk_step}), frgConfig, stats, checkpoint_config);
         rk_step++;
+        stats.RHS_evaluations++;
     }
 };
 
@@ -628,9 +741,7 @@ void vertexOneLoopFlow(Vertex<Q,true>& dPsiVertex, const Vertex<Q,false>& PsiVer
         }
     }
     else {
-        for (char r: "apt") {
-            bubble_function(dPsiVertex, PsiVertex, PsiVertex, dPi, r, config);  // Differentiated bubble in channel r \in {a, p, t}
-        }
+        bubble_function_all_channels(dPsiVertex, PsiVertex, PsiVertex, dPi, config);  // Differentiated bubble in channel r \in {a, p, t}
     }
 }
 
@@ -654,9 +765,7 @@ auto calculate_dGammaL(const GeneralVertex<Q, symmetric_r_irred,true>& dPsiVerte
         }
     }
     else {
-        for (char r: "apt") {
-            bubble_function(dGammaL, dPsiVertex, PsiVertex, Pi, r, config);
-        }
+        bubble_function_all_channels(dGammaL, dPsiVertex, PsiVertex, Pi, config);
     }
 
     return dGammaL;
@@ -679,9 +788,7 @@ auto calculate_dGammaR(const GeneralVertex<Q, symmetric_r_irred,true>& dPsiVerte
         }
     }
     else {
-        for (char r: "apt") {
-            bubble_function(dGammaR, PsiVertex, dPsiVertex, Pi, r, config);
-        }
+        bubble_function_all_channels(dGammaR, PsiVertex, dPsiVertex, Pi, config);
     }
 
     return dGammaR;
@@ -788,9 +895,7 @@ auto calculate_dGammaC_right_insertion(const Vertex<Q,false>& PsiVertex, const G
         }
     }
     else {
-        for (char r: "apt") {
-            bubble_function(dGammaC, PsiVertex, nonsymVertex, Pi, r, config);
-        }
+        bubble_function_all_channels(dGammaC, PsiVertex, nonsymVertex, Pi, config);
     }
 
     return dGammaC;
@@ -818,9 +923,7 @@ auto calculate_dGammaC_left_insertion(const GeneralVertex<Q, non_symmetric_diffr
         }
     }
     else {
-        for (char r: "apt") {
-            bubble_function(dGammaC, nonsymVertex, PsiVertex, Pi, r, config);
-        }
+        bubble_function_all_channels(dGammaC, nonsymVertex, PsiVertex, Pi, config);
     }
 
     return dGammaC;
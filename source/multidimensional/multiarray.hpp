@@ -13,6 +13,7 @@
 #include "Eigen/Dense"
 
 #include "../utilities/template_utils.hpp"
+#include "../parameters/technical_parameters.hpp"
 
 #ifndef NDEBUG
 #define MULTIARRAY_CHECK_BOUNDS
@@ -26,17 +27,90 @@ namespace multidimensional
         return (std::abs(lhs) < std::abs(rhs));
     }
 
+    /// Default memory layout of a multiarray: row-major order of the indices
+    struct row_major_layout {
+        static constexpr bool is_row_major = true;
+    };
+
+    /**
+     * Memory layout in which the freqrank consecutive indices starting at pos_first (e.g. the frequency indices of K3)
+     * are split into tiles of tile_size^freqrank points. Each tile is stored contiguously, together with all indices
+     * behind the tiled ones; tiles and the indices in front of pos_first are ordered row-major.
+     * Points which are neighbours along any of the tiled indices are thus close in memory, e.g. the corners of a
+     * (multi-)linear interpolation stencil. Tiles at the upper end of an index are truncated, i.e., no padding is needed.
+     */
+    template <size_t pos_first, size_t freqrank, size_t tile_size>
+    struct tiled_layout {
+        static constexpr bool is_row_major = false;
+        static_assert(freqrank > 0 and tile_size > 1, "A tiled layout needs at least one tiled index and tiles with more than one point.");
+
+        template <size_t depth>
+        static size_t flat_index(const std::array<my_index_t,depth>& index, const std::array<size_t,depth>& length) {
+            static_assert(pos_first + freqrank <= depth, "Tiled indices out of range.");
+            size_t outer = 0;
+            for (size_t i = 0; i < pos_first; i++) outer = outer * length[i] + index[i];
+            size_t inner = 0, inner_size = 1;
+            for (size_t i = pos_first + freqrank; i < depth; i++) {
+                inner = inner * length[i] + index[i];
+                inner_size *= length[i];
+            }
+            size_t tiled_size = 1;
+            for (size_t d = 0; d < freqrank; d++) tiled_size *= length[pos_first + d];
+
+            // all preceding tiles are summed up dimension by dimension: the tiles with a smaller tile index along d
+            // span the full extent of all later dimensions and the (possibly truncated) extent of the current tile in all earlier ones
+            size_t tile_offset = 0, within_tile = 0, extent_of_earlier = 1, extent_of_later = tiled_size;
+            for (size_t d = 0; d < freqrank; d++) {
+                const size_t n = length[pos_first + d];
+                const size_t tile = index[pos_first + d] / tile_size;
+                const size_t extent = std::min(tile_size, n - tile * tile_size);
+                extent_of_later /= n;
+                tile_offset += extent_of_earlier * tile * tile_size * extent_of_later;
+                extent_of_earlier *= extent;
+                within_tile = within_tile * extent + index[pos_first + d] % tile_size;
+            }
+            return ((outer * tiled_size) + tile_offset + within_tile) * inner_size + inner;
+        }
+
+        /**
+         * Computes the strides along the tiled indices inside the tile containing index.
+         * @return true if the stencil of sample_size points along each tiled index, starting at index, lies within this tile
+         */
+        template <size_t sample_size, size_t depth>
+        static bool strides_within_tile(std::array<size_t,freqrank>& strides, const std::array<my_index_t,depth>& index, const std::array<size_t,depth>& length) {
+            size_t stride = 1;
+            for (size_t i = pos_first + freqrank; i < depth; i++) stride *= length[i];
+            bool inside = true;
+            for (int d = (int)freqrank - 1; d >= 0; d--) {
+                const size_t n = length[pos_first + d];
+                const size_t tile = index[pos_first + d] / tile_size;
+                const size_t extent = std::min(tile_size, n - tile * tile_size);
+                inside = inside and (index[pos_first + d] % tile_size + sample_size <= extent);
+                strides[d] = stride;
+                stride *= extent;
+            }
+            return inside;
+        }
+    };
+
     // Forward declarations for templates
-    template <typename T, size_t depth>
+    template <typename T, size_t depth, typename layout = row_major_layout>
     class multiarray;
 
-    template <typename T, size_t depth>
-    bool operator==(const multiarray<T, depth> &lhs, const multiarray<T, depth> &rhs);
+    template <typename T, size_t depth, typename layout>
+    bool operator==(const multiarray<T, depth, layout> &lhs, const multiarray<T, depth, layout> &rhs);
 
     // template <typename Q, typename L, typename R, size_t depth>
     // auto elementwise(const Q &op, const multiarray<L, depth> &lhs, const multiarray<R, depth> &rhs);
 
-    template <typename T, size_t depth>
+    /**
+     * Multi-dimensional array with contiguous storage
+     * @tparam T        type of the elements
+     * @tparam depth    number of indices
+     * @tparam layout   memory layout of the elements: row_major_layout (default) or tiled_layout.
+     *                  Flat access (flat_at, data(), iterators) refers to the order in memory.
+     */
+    template <typename T, size_t depth, typename layout>
     class multiarray
     {
     public:
@@ -76,8 +150,8 @@ namespace multidimensional
 
         // === swap for copy-and-swap ===
         friend void swap(
-                multiarray<value_type, depth> &lhs,
-                multiarray<value_type, depth> &rhs) noexcept
+                multiarray<value_type, depth, layout> &lhs,
+                multiarray<value_type, depth, layout> &rhs) noexcept
         {
             using std::swap;
             swap(lhs.m_length, rhs.m_length);
@@ -93,7 +167,7 @@ namespace multidimensional
         explicit multiarray(dimensions_type length, const T &value = T())
                 : m_length(std::move(length)), elements(_flat_size())
         {
-            elements.setConstant(value);
+            first_touch_fill(value);
         }
 
         multiarray(dimensions_type length, const buffer_type &elements)
@@ -127,11 +201,26 @@ namespace multidimensional
         }
 
         /// Move & copy constructors and assignment operators
-        multiarray(const multiarray<T, depth> &) = default;
-        multiarray(multiarray<T, depth> &&) = default;
+        /// Copies are written in parallel if NUMA_FIRST_TOUCH (see first_touch_fill)
+        multiarray(const multiarray<T, depth, layout> &other)
+                : m_length(other.m_length), elements(other.elements.size())
+        {
+            first_touch_copy(other.elements);
+        }
+        multiarray(multiarray<T, depth, layout> &&) = default;
 
-        multiarray<T, depth> &operator=(const multiarray<T, depth> &) = default;
-        multiarray<T, depth> &operator=(multiarray<T, depth> &&) = default;
+        multiarray<T, depth, layout> &operator=(const multiarray<T, depth, layout> &other)
+        {
+            if (this != &other)
+            {
+                m_length = other.m_length;
+                m_length_cumulative = other.m_length_cumulative;
+                if (elements.size() != other.elements.size()) elements.resize(other.elements.size()); // new (untouched) memory
+                first_touch_copy(other.elements);
+            }
+            return *this;
+        }
+        multiarray<T, depth, layout> &operator=(multiarray<T, depth, layout> &&) = default;
 
         /// === iterators ===
         using iterator = pointer;
@@ -166,6 +255,7 @@ namespace multidimensional
 
         constexpr auto range(const index_type &start, const index_type &end)
         {
+            static_assert(layout::is_row_major, "Ranges of indices are only contiguous in the row-major layout.");
             if (check_bounds(start) && check_bounds_end(end))
             {
                 return make_range(*this, flat_index(start), flat_index(end));
@@ -178,6 +268,7 @@ namespace multidimensional
 
         constexpr auto range(const index_type &start, const index_type &end) const
         {
+            static_assert(layout::is_row_major, "Ranges of indices are only contiguous in the row-major layout.");
             if (check_bounds(start) && check_bounds_end(end))
             {
                 return make_const_range(*this, flat_index(start), flat_index(end));
@@ -191,6 +282,7 @@ namespace multidimensional
         /// return segment including start and end
         constexpr auto eigen_segment(const index_type &start, const index_type &end)
         {
+            static_assert(layout::is_row_major, "Ranges of indices are only contiguous in the row-major layout.");
             if (check_bounds(start) && check_bounds_end(end))
             {
                 const auto flat_start = flat_index(start);
@@ -205,6 +297,7 @@ namespace multidimensional
 
         constexpr auto eigen_segment(const index_type &start, const index_type &end) const
         {
+            static_assert(layout::is_row_major, "Ranges of indices are only contiguous in the row-major layout.");
             if (check_bounds(start) && check_bounds_end(end))
             {
                 const auto flat_start = flat_index(start);
@@ -218,7 +311,7 @@ namespace multidimensional
         }
 
 
-        bool is_same_length(const multiarray<value_type,depth>& other) const {
+        bool is_same_length(const multiarray<value_type,depth,layout>& other) const {
             return (m_length == other.m_length);
         }
 
@@ -275,6 +368,10 @@ namespace multidimensional
             assert(check_bounds(index));
 #endif
             Eigen::Matrix<T, vecsize, numberFrequencyDims == 1 ? sample_size : (numberFrequencyDims == 2 ? sample_size*sample_size : sample_size*sample_size*sample_size)> result;
+            if constexpr(!layout::is_row_major) {
+                get_values_tiled<numberFrequencyDims, pos_first_freqpoint, vecsize, sample_size>(result, index);
+                return result;
+            }
             const size_t flat_ini = get_flatindex_ini<pos_first_freqpoint+numberFrequencyDims>(index);
 
             if constexpr (numberFrequencyDims == 1) {
@@ -306,6 +403,28 @@ namespace multidimensional
             return result;
         }
 
+        /// get_values for the tiled layout: if the stencil lies within one tile, its points are found with the strides of this tile
+        template <my_index_t numberFrequencyDims, my_index_t pos_first_freqpoint, my_index_t vecsize, my_index_t sample_size, typename result_type>
+        void get_values_tiled(result_type& result, const index_type& index) const {
+            std::array<size_t,numberFrequencyDims> strides;
+            const bool inside = layout::template strides_within_tile<sample_size>(strides, index, m_length);
+            const size_t flat_ini = flat_index(index);
+            for (my_index_t icol = 0; icol < (my_index_t)result_type::ColsAtCompileTime; icol++) {
+                // icol enumerates the points of the stencil in row-major order
+                size_t flat = flat_ini;
+                index_type index_point = index;
+                my_index_t rest = icol;
+                for (int d = (int)numberFrequencyDims - 1; d >= 0; d--) {
+                    const my_index_t shift = rest % sample_size;
+                    rest /= sample_size;
+                    flat += shift * strides[d];
+                    index_point[pos_first_freqpoint + d] += shift;
+                }
+                if (!inside) flat = flat_index(index_point);  // the stencil crosses the boundary of a tile
+                result.col(icol) = at_vectorized<vecsize>(flat);
+            }
+        }
+
         /// === public member functions ===
 
         /// random element access
@@ -378,9 +497,9 @@ namespace multidimensional
 
         /// elementwise arithmetics-assignment op's
         template <typename Q, typename R>
-        multiarray<T, depth> &elementwise_map_assign(
+        multiarray<T, depth, layout> &elementwise_map_assign(
                 Q op,
-                const multiarray<R, depth> &rhs)
+                const multiarray<R, depth, layout> &rhs)
         {
             if (rhs.length() != length())
             {
@@ -393,32 +512,32 @@ namespace multidimensional
             return *this;
         }
 
-        multiarray<T, depth> &operator+=(
-                const multiarray<T, depth> &rhs)
+        multiarray<T, depth, layout> &operator+=(
+                const multiarray<T, depth, layout> &rhs)
         {
             assert(is_same_length(rhs));
             elements += rhs.elements;
             return *this;
         }
 
-        multiarray<T, depth> &operator-=(
-                const multiarray<T, depth> &rhs)
+        multiarray<T, depth, layout> &operator-=(
+                const multiarray<T, depth, layout> &rhs)
         {
             assert(is_same_length(rhs));
             elements -= rhs.elements;
             return *this;
         }
 
-        multiarray<T, depth> &operator*=(
-                const multiarray<T, depth> &rhs)
+        multiarray<T, depth, layout> &operator*=(
+                const multiarray<T, depth, layout> &rhs)
         {
             assert(is_same_length(rhs));
             elements *= rhs.elements;
             return *this;
         }
 
-        multiarray<T, depth> &operator/=(
-                const multiarray<T, depth> &rhs)
+        multiarray<T, depth, layout> &operator/=(
+                const multiarray<T, depth, layout> &rhs)
         {
             assert(is_same_length(rhs));
             elements /= rhs.elements;
@@ -426,8 +545,8 @@ namespace multidimensional
         }
 
         template <typename R>
-        multiarray<T, depth> &operator+=(
-                const multiarray<R, depth> &rhs)
+        multiarray<T, depth, layout> &operator+=(
+                const multiarray<R, depth, layout> &rhs)
         {
             assert(is_same_length(rhs));
             elements += rhs.elements.template cast<T>();
@@ -435,8 +554,8 @@ namespace multidimensional
         }
 
         template <typename R>
-        multiarray<T, depth> &operator-=(
-                const multiarray<R, depth> &rhs)
+        multiarray<T, depth, layout> &operator-=(
+                const multiarray<R, depth, layout> &rhs)
         {
             assert(is_same_length(rhs));
             elements -= rhs.elements.template cast<T>();
@@ -444,8 +563,8 @@ namespace multidimensional
         }
 
         template <typename R>
-        multiarray<T, depth> &operator*=(
-                const multiarray<R, depth> &rhs)
+        multiarray<T, depth, layout> &operator*=(
+                const multiarray<R, depth, layout> &rhs)
         {
             assert(is_same_length(rhs));
             elements *= rhs.elements.template cast<T>();
@@ -453,8 +572,8 @@ namespace multidimensional
         }
 
         template <typename R>
-        multiarray<T, depth> &operator/=(
-                const multiarray<R, depth> &rhs)
+        multiarray<T, depth, layout> &operator/=(
+                const multiarray<R, depth, layout> &rhs)
         {
             assert(is_same_length(rhs));
             elements /= rhs.elements.template cast<T>();
@@ -463,7 +582,7 @@ namespace multidimensional
 
         /// scalar arithmetic assignment
         template <typename Q, typename R>
-        multiarray<T, depth> &scalar_map_assign(Q op, const R &rhs) noexcept(noexcept(op(T(), R())))
+        multiarray<T, depth, layout> &scalar_map_assign(Q op, const R &rhs) noexcept(noexcept(op(T(), R())))
         {
             for (auto &e : elements)
             {
@@ -473,14 +592,14 @@ namespace multidimensional
         }
 
         template <typename R>
-        multiarray<T, depth> &operator+=(const R &rhs) noexcept(noexcept(T() + R()))
+        multiarray<T, depth, layout> &operator+=(const R &rhs) noexcept(noexcept(T() + R()))
         {
             elements += rhs;
             return *this;
         }
 
         template <typename R>
-        multiarray<T, depth> &operator-=(const R &rhs) noexcept(noexcept(T() - R()))
+        multiarray<T, depth, layout> &operator-=(const R &rhs) noexcept(noexcept(T() - R()))
         {
             elements -= rhs;
             return *this;
@@ -488,22 +607,31 @@ namespace multidimensional
         }
 
         template <typename R>
-        multiarray<T, depth> &operator*=(const R &rhs) noexcept(noexcept(T() * R()))
+        multiarray<T, depth, layout> &operator*=(const R &rhs) noexcept(noexcept(T() * R()))
         {
             elements *= rhs;
             return *this;
         }
 
         template <typename R>
-        multiarray<T, depth> &operator/=(const R &rhs) noexcept(noexcept(T() - R()))
+        multiarray<T, depth, layout> &operator/=(const R &rhs) noexcept(noexcept(T() - R()))
         {
             elements /= rhs;
             return *this;
         }
 
+        /// this += alpha * rhs, evaluated in a single pass without temporaries
+        template <typename R>
+        multiarray<T, depth, layout> &axpy(const R &alpha, const multiarray<T, depth, layout> &rhs)
+        {
+            assert(is_same_length(rhs));
+            elements += static_cast<T>(alpha) * rhs.elements;
+            return *this;
+        }
+
         /// other function related to arithmetic
 
-        multiarray<T,depth> abs() const {
+        multiarray<T,depth,layout> abs() const {
             return transform([] (const T& x) {return static_cast<T>(std::abs(x));}, *this);
         }
 
@@ -531,6 +659,14 @@ namespace multidimensional
                 return std::abs(maxabs());
             };
 
+        /// max_i (a |this_i| + b |rhs_i|), evaluated in a single pass without temporaries
+        double weighted_max_norm(const multiarray<T, depth, layout> &rhs, const double a, const double b) const
+        {
+            assert(is_same_length(rhs));
+            if (elements.size() == 0) return 0.;
+            return (a * elements.abs().template cast<double>() + b * rhs.elements.abs().template cast<double>()).maxCoeff();
+        }
+
         template<int p> double lpNorm() const {
             return elements.template lpNorm<p>();
         }
@@ -549,7 +685,7 @@ namespace multidimensional
         }
 
         /// non-member op's
-        friend bool operator==<>(const multiarray<T, depth> &, const multiarray<T, depth> &);
+        friend bool operator==<>(const multiarray<T, depth, layout> &, const multiarray<T, depth, layout> &);
 
         size_type size() const noexcept
         {
@@ -597,6 +733,39 @@ namespace multidimensional
 #endif
         }
 
+        /// Parallel first touch (see NUMA_FIRST_TOUCH): memory is only mapped to a NUMA node when it is written first.
+        /// Large arrays are therefore initialized in contiguous blocks by all OpenMP threads (static schedule, as the
+        /// loops over flat indices), such that every thread finds its part of the data on its own node.
+        bool first_touch_in_parallel() const noexcept
+        {
+            return NUMA_FIRST_TOUCH and (size_type)elements.size() >= NUMA_FIRST_TOUCH_MIN_SIZE;
+        }
+
+        void first_touch_fill(const T &value)
+        {
+            if (first_touch_in_parallel())
+            {
+                const std::ptrdiff_t n = elements.size();
+                T *const ptr = elements.data();
+#pragma omp parallel for schedule(static)
+                for (std::ptrdiff_t i = 0; i < n; i++) ptr[i] = value;
+            }
+            else elements.setConstant(value);
+        }
+
+        void first_touch_copy(const buffer_type &source)
+        {
+            if (first_touch_in_parallel())
+            {
+                const std::ptrdiff_t n = elements.size();
+                T *const ptr = elements.data();
+                const T *const ptr_source = source.data();
+#pragma omp parallel for schedule(static)
+                for (std::ptrdiff_t i = 0; i < n; i++) ptr[i] = ptr_source[i];
+            }
+            else elements = source;
+        }
+
         size_type flat_index(const index_type &index) const noexcept;
         bool check_bounds(const index_type &index) const noexcept;
         bool check_bounds_end(const index_type &index) const noexcept;
@@ -604,10 +773,11 @@ namespace multidimensional
 
     // === template definitions ===
 
-    template <typename T, size_t depth>
-    typename multiarray<T, depth>::size_type // <- This should be size_t. Compiler is too stupid to figure that out himself.
-    multiarray<T, depth>::flat_index(const index_type &index) const noexcept
+    template <typename T, size_t depth, typename layout>
+    typename multiarray<T, depth, layout>::size_type // <- This should be size_t. Compiler is too stupid to figure that out himself.
+    multiarray<T, depth, layout>::flat_index(const index_type &index) const noexcept
     {
+        if constexpr(!layout::is_row_major) return layout::flat_index(index, m_length);
         size_type res = index[0];
         for (size_t i = 1; i < depth; i++)
         {
@@ -618,8 +788,8 @@ namespace multidimensional
         return res;
     }
 
-    template <typename T, size_t depth>
-    bool multiarray<T, depth>::check_bounds(const index_type &index) const noexcept
+    template <typename T, size_t depth, typename layout>
+    bool multiarray<T, depth, layout>::check_bounds(const index_type &index) const noexcept
     {
 #ifdef MULTIARRAY_CHECK_BOUNDS
         for (size_t i = 0; i < depth; i++)
@@ -633,8 +803,8 @@ namespace multidimensional
         return true;
     }
 
-    template <typename T, size_t depth>
-    bool multiarray<T, depth>::check_bounds_end(const index_type &index) const noexcept
+    template <typename T, size_t depth, typename layout>
+    bool multiarray<T, depth, layout>::check_bounds_end(const index_type &index) const noexcept
     {
 #ifdef MULTIARRAY_CHECK_BOUNDS
         for (size_t i = 0; i < depth; i++)
@@ -648,8 +818,8 @@ namespace multidimensional
         return true;
     }
 
-    template <typename T, size_t depth>
-    T &multiarray<T, depth>::at(const index_type &index)
+    template <typename T, size_t depth, typename layout>
+    T &multiarray<T, depth, layout>::at(const index_type &index)
     {
         if (check_bounds(index))
         {
@@ -662,8 +832,8 @@ namespace multidimensional
         }
     }
 
-    template <typename T, size_t depth>
-    const T &multiarray<T, depth>::at(const index_type &index) const
+    template <typename T, size_t depth, typename layout>
+    const T &multiarray<T, depth, layout>::at(const index_type &index) const
     {
         if (check_bounds(index))
         {
@@ -677,14 +847,14 @@ namespace multidimensional
     }
 
     // === operator implementation ===
-    template <typename T, size_t depth>
-    bool operator==(const multiarray<T, depth> &lhs, const multiarray<T, depth> &rhs)
+    template <typename T, size_t depth, typename layout>
+    bool operator==(const multiarray<T, depth, layout> &lhs, const multiarray<T, depth, layout> &rhs)
     {
         return (lhs.m_length == rhs.m_length) && (lhs.elements == rhs.elements).all();
     }
 
-    template <typename T, size_t depth>
-    bool operator!=(const multiarray<T, depth> &lhs, const multiarray<T, depth> &rhs)
+    template <typename T, size_t depth, typename layout>
+    bool operator!=(const multiarray<T, depth, layout> &lhs, const multiarray<T, depth, layout> &rhs)
     {
         return !(lhs == rhs);
     }
@@ -693,9 +863,9 @@ namespace multidimensional
 
     // unary op
     template <
-            typename Q, typename L, size_t depth,
+            typename Q, typename L, size_t depth, typename layout,
             std::enable_if_t<std::is_same_v<std::result_of_t<Q && (L &&)>, L>, bool> = true>
-    auto transform(Q op, multiarray<L, depth> lhs) noexcept(noexcept(op(std::declval<L>())))
+    auto transform(Q op, multiarray<L, depth, layout> lhs) noexcept(noexcept(op(std::declval<L>())))
     {
     for (size_t i = 0; i < lhs.size(); i++)
     {
@@ -11,17 +11,47 @@ constexpr bool MPI_FLAG = true;
 #else
 constexpr bool MPI_FLAG = false;
 #endif
+constexpr bool MPI_DYNAMIC_SCHEDULING = true; ///< If true, the points of a bubble are handed out to the MPI processes in chunks on demand (load balancing). If false, they are distributed statically in contiguous blocks.
+constexpr bool BUBBLE_CHANNELS_CONCURRENTLY = false; ///< If true, the bubbles in the channels a, p and t may be computed concurrently by three groups of MPI processes (if a single channel has too few points, see min_bubble_points_per_thread).
+constexpr int min_bubble_points_per_thread = 16;     ///< If a single channel has fewer points per thread (of all MPI processes), the channels are computed concurrently (with BUBBLE_CHANNELS_CONCURRENTLY).
 
 constexpr double inter_tol = 1e-5;  ///< Tolerance for closeness to grid points when interpolating.
 
 
 enum interpolMethod {linear=0, linear_on_aux=1, cubic=4};
 constexpr interpolMethod INTERPOLATION = linear_on_aux;     ///< Interpolation method to me used. linear: linear interpolation on the frequency grid. linear_on_aux: linear interpolation on the grid for the auxiliary frequency \Omega. cubic: Interpolation with cubic splines (warning: expensive!).
+constexpr bool K2_SINGLE_PRECISION = false;    ///< If true, the data of K2 (and K2b) is stored in single precision. Interpolation and bubbles are still computed in double precision.
+constexpr bool K3_SINGLE_PRECISION = false;    ///< If true, the data of K3 is stored in single precision. Interpolation and bubbles are still computed in double precision.
+constexpr bool K3_TILED_LAYOUT = false;       ///< If true, the data of K3 is stored in tiles of K3_TILE_SIZE^3 frequency points (with all Keldysh and internal indices), such that the stencil of a linear interpolation is close in memory. Ignored for INTERPOLATION == cubic.
+constexpr size_t K3_TILE_SIZE = 4;            ///< Number of frequency points per tile and frequency index for K3_TILED_LAYOUT.
+constexpr bool SYMMETRY_REDUCED_STORAGE = false; ///< If true, K3 stores only the Keldysh components which are not zero according to the symmetry table (see Components); the others read as zero. Requires DEBUG_SYMMETRIES == 0, ignored for INTERPOLATION == cubic.
+constexpr double K3_LOW_RANK_TOLERANCE = 1e-4;   ///< Relative tolerance of the compressed K3 (lowRankBuffer): singular values below K3_LOW_RANK_TOLERANCE * max|K3| are discarded. Also used for the compression diagnostics in check_vertex_resolution().
+enum splineStorage {spline_coefficients=0, spline_on_the_fly=1};
+inline splineStorage K3_SPLINE_STORAGE = spline_coefficients; ///< Only used for INTERPOLATION == cubic. spline_coefficients: store 64 polynomial coefficients per K3 data point. spline_on_the_fly: store nothing and evaluate the Hermite form from a local finite-difference stencil of the data at every query.
 
 
 constexpr double converged_tol = 1e-7;  ///< Tolerance for loop convergence in mfRG.
 
 inline double integrator_tol = 1e-5;    ///< Integrator tolerance.
 
+enum integratorType {adaptive_Gauss_Lobatto=0, global_Gauss_Kronrod=1};
+constexpr integratorType INTEGRATOR_TYPE = adaptive_Gauss_Lobatto;    ///< Adaptive integrator used in bubbles and loops. adaptive_Gauss_Lobatto: recursive Gauss-Lobatto-Kronrod integrator. global_Gauss_Kronrod: globally adaptive 15-point Gauss-Kronrod integrator, bisecting the interval with the largest error first.
+enum integratorErrorNorm {max_norm=0, componentwise=1, weighted_norm=2};
+constexpr integratorErrorNorm INTEGRATOR_ERROR_NORM = max_norm;     ///< Error control of global_Gauss_Kronrod for vector-valued integrands. max_norm: largest error of all components relative to the largest component. componentwise: every component relative to itself. weighted_norm: weighted sum of the errors relative to the weighted sum of the components.
+constexpr bool K3_FIXED_NODE_QUADRATURE = false;  ///< If true, K3 bubbles in the Keldysh formalism are integrated on a fixed mesh of internal frequencies, using matrix products for all K3 entries at the same bosonic frequency.
+inline int K3_quadrature_nodes_per_panel = 8;     ///< Number of Gauss-Legendre nodes per panel of the fixed mesh for K3 (panels are given by the auxiliary frequency grid). Controls the accuracy of K3_FIXED_NODE_QUADRATURE.
+
+enum ODE_solverType {cash_karp_5_4=0, low_storage_4_3=1, dormand_prince_5_4=2};
+constexpr ODE_solverType ODE_SOLVER_TYPE = cash_karp_5_4;   ///< Default Runge-Kutta method of ode_solver() (see ODE_solver_config::solver_type). cash_karp_5_4: Cash-Karp 5(4) with six stages, keeps all derivatives in memory. low_storage_4_3: Carpenter-Kennedy 4(3) with five stages in 2N-storage form, keeps only two States besides the solution (for memory-limited runs). dormand_prince_5_4: Dormand-Prince 5(4) with seven stages, reuses the last stage as dydx of the next step (six evaluations of the right-hand side per accepted step).
+constexpr bool ASYNC_CHECKPOINTS = false;   ///< If true, the States of the ODE solver are written to the HDF5 file by a background thread on rank 0 (see checkpoint_writer), overlapping with the next Runge-Kutta step. Needs memory for one more State on rank 0.
+constexpr bool MIDSTEP_CHECKPOINTS = false;  ///< If true, every completed stage of a Runge-Kutta step (Butcher tableaus only) and every completed loop order of the multiloop right-hand side is written into side files next to the output file, such that a restart resumes in the middle of an interrupted step.
+
+constexpr bool NUMA_FIRST_TOUCH = false;             ///< If true, multiarrays with at least NUMA_FIRST_TOUCH_MIN_SIZE elements are initialized and copied by all OpenMP threads (static schedule), such that their pages are distributed over the NUMA nodes of the threads instead of all residing on the node of the master thread.
+constexpr size_t NUMA_FIRST_TOUCH_MIN_SIZE = 65536;  ///< Minimal number of elements of a multiarray for the parallel first touch (see NUMA_FIRST_TOUCH).
+
+constexpr bool CACHE_BUBBLE_VALUES = false;            ///< If true, the 4x4 Keldysh matrices of the bubble Pi(w, v'') are cached for every Bubble object and reused by all diagrammatic classes and channels.
+inline size_t bubble_cache_max_entries = 1000000;     ///< Maximal number of cached bubble values per Bubble object (one entry needs about 300 bytes).
+constexpr double bubble_cache_resolution = 1e-6;      ///< Spacing of the frequency mesh of the bubble cache, relative to the hybridization (Lambda + Gamma)/2. With CACHE_BUBBLE_VALUES, v'' is rounded to this mesh, such that nearby abscissae share an entry.
+
 
 #endif //FPP_MFRG_TECHNICAL_PARAMETERS_H
@@ -171,6 +171,7 @@ void Hartree_Solver::write_out_propagators() const {
     const std::string filename = data_dir + "Hartree_Propagators_with_U_over_Delta_" \
     + std::to_string(config.U / Delta) + "_and_eVg_over_U_" + std::to_string((config.epsilon+config.U*0.5) / config.U) + ".h5";
 
+    std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
     write_h5_rvecs(filename,
                    {"GR_real", "GR_imag", "GK_real", "GK_imag"},
                    {GR_real, GR_imag, GK_real, GK_imag});
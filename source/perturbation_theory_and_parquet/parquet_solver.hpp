@@ -534,6 +534,7 @@ bool parquet_solver(const std::string filename, State<Q>& state_in, const double
     //write_state_to_hdf(filename, Lambda, Nmax + 1, state_in); // save input into 0-th layer of hdf5 file
     write_state_to_hdf(filename, Lambda, trigger_adaptation, state_in); // save input into 0-th layer of hdf5 file
     if (mpi_world_rank() == 0) {
+        std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
         H5::H5File file_out = open_hdf_file_readWrite(filename);
         write_to_hdf_LambdaLayer<double>(file_out, "mixing_parameter", std::vector<double>({mixing_ratio}), 0, Nmax + 1, false);
         file_out.close();
@@ -630,6 +631,7 @@ bool parquet_solver(const std::string filename, State<Q>& state_in, const double
         add_state_to_hdf(filename, iteration%trigger_adaptation, state_out, is_converged);  // store result into file
         //write_state_to_hdf(filename, Lambda, 1, state_in, false, is_converged); // save input into 0-th layer of hdf5 file
         if (mpi_world_rank() == 0) {
+            std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
             H5::H5File file_out = open_hdf_file_readWrite(filename);
             write_to_hdf_LambdaLayer<double>(file_out, "mixing_parameter", std::vector<double>({mixing_adaptive}), iteration%trigger_adaptation, Nmax + 1, true);
             file_out.close();
@@ -135,6 +135,7 @@ void compute_postprocessed_susceptibilities(const std::string& filename) {
     check_convergence_hdf(filename, Lambda_it_max);
 
 
+    std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
     H5::H5File file(filename+"_postproc", H5F_ACC_TRUNC);
 
     for (int iLambda = 0; iLambda <= Lambda_it_max; iLambda++) {
@@ -170,6 +171,7 @@ void compute_proprocessed_susceptibilities_PT2(const std::string& filename) {
     check_convergence_hdf(filename, Lambda_it_max);
 
 
+    std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
     H5::H5File file(filename+"_postproc", H5F_ACC_TRUNC);
     H5::H5File file_PT2_corr(filename+"_postproc_PT2_corr", H5F_ACC_TRUNC);
 
@@ -249,6 +251,7 @@ void save_slices_through_fullvertex(const std::string& filename, const int ispin
     }
 
     //utils::print("Saving results...", true);
+    std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
     H5::H5File file(filename + "_slices" + "_ispin=" + std::to_string(ispin), H5F_ACC_TRUNC);
     write_to_hdf(file, "slices", slices, false);
     write_to_hdf(file, "freqs", frequencies, false);
@@ -367,6 +370,7 @@ void check_FDTs_for_slices_through_fullvertex(const std::string& filename, const
     }
 
     //utils::print("Saving results...", true);
+    std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
     H5::H5File file(filename + "_FDTslices" + "_ispin=" + std::to_string(ispin), H5F_ACC_TRUNC);
     write_to_hdf(file, "FDT_results", FDT_results, false);
     write_to_hdf(file, "freqs", frequencies, false);
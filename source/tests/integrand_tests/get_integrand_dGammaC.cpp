@@ -7,7 +7,7 @@
 
 auto main(int argc, char * argv[]) -> int {
     if (MPI_FLAG) {
-        MPI_Init(nullptr, nullptr);
+        mpi_init_funneled(); // only the master thread communicates via MPI
     }
     std::string job = "U=" + std::to_string(glb_U);
     data_dir = "../Data_KF" + job + "/";
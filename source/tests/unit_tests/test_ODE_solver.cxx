@@ -15,6 +15,28 @@ namespace {
         }
     };
 
+    class rhs_exp_counting_t {
+    public:
+        mutable std::vector<std::pair<double,double>> evaluations; // all points (x, y) of evaluations
+        void operator() (const double& y, double& dy_dx, const double x) const {
+            dy_dx = y;
+            evaluations.emplace_back(x, y);
+        }
+        /// number of evaluations at a point which has been evaluated before
+        int repeated_evaluations() const {
+            int result = 0;
+            for (size_t i = 0; i < evaluations.size(); i++) {
+                for (size_t j = 0; j < i; j++) {
+                    if (std::abs(evaluations[i].first - evaluations[j].first) < 1e-12 and evaluations[i].second == evaluations[j].second) {
+                        result++;
+                        break;
+                    }
+                }
+            }
+            return result;
+        }
+    };
+
     class rhs_quartic_t {
     public:
         void operator() (const double& y, double& dy_dx, const double& x) const {//, const vec<size_t> opt) {
@@ -77,3 +99,89 @@ TEST_CASE( "Does the ODE solver work for a medium ODE?", "[ODEsolver]" ) {
 
 }
 
+
+
+TEST_CASE( "Do the in-place operations of the ODE solver agree with the ones via temporary States?", "[ODEsolver]" ) {
+    fRG_config config;
+    State<state_datatype> y (Lambda_ini, config);
+    y += 0.5;
+    y.selfenergy.asymp_val_R = 0.3;
+    const State<state_datatype> dydx = y * (-3.) + 1.;
+
+    State<state_datatype> y_axpy = y;
+    y_axpy.axpy(0.25, dydx);
+    const State<state_datatype> y_temporaries = y + dydx * 0.25;
+
+    const double a = 1., b = 0.5, rel = 1e-4, abs_err = 1e-8;
+    const double scale_fused = y.norm_of_error_scale(dydx, a, b, rel, abs_err);
+    const double scale_temporaries = ((abs(y) * a + abs(dydx) * b) * rel + abs_err).norm();
+
+    REQUIRE( (y_axpy - y_temporaries).norm() < 1e-12 );
+    REQUIRE( y_axpy.selfenergy.asymp_val_R == y_temporaries.selfenergy.asymp_val_R );
+    REQUIRE( std::abs(scale_fused - scale_temporaries) <= 1e-10 * scale_temporaries );
+}
+
+TEST_CASE( "Does the low-storage Runge-Kutta method work for a medium ODE?", "[ODEsolver]" ) {
+
+    double Lambda_i = 0.;
+    double Lambda_f = 1e1;
+
+    double y_ini = exp(Lambda_i);
+    double result;
+    ODE_solver_config config;
+    config.maximal_number_of_ODE_steps = 800;
+    config.relative_error = 1e-9;
+    config.absolute_error = 1e-8;
+    config.Lambda_i = Lambda_i;
+    config.Lambda_now = Lambda_i;
+    config.Lambda_f = Lambda_f;
+    config.solver_type = low_storage_4_3;
+    ode_solver<double, flowgrid::linear_parametrization, rhs_exp_t>(result, y_ini, rhs_exp_t(),  config, false);
+
+
+    double result_exact = exp(Lambda_f);
+    double difference = std::abs(result - result_exact);
+    SECTION( "Is the correct value retrieved from ODE solver?" ) {
+        REQUIRE( difference / result_exact < 1e-7 );
+    }
+
+}
+
+TEST_CASE( "Does the Dormand-Prince method reuse the last stage (FSAL)?", "[ODEsolver]" ) {
+
+    double Lambda_i = 0.;
+    double Lambda_f = 1e1;
+
+    double y_ini = exp(Lambda_i);
+    ODE_solver_config config;
+    config.maximal_number_of_ODE_steps = 800;
+    config.relative_error = 1e-9;
+    config.absolute_error = 1e-8;
+    config.Lambda_i = Lambda_i;
+    config.Lambda_now = Lambda_i;
+    config.Lambda_f = Lambda_f;
+    config.lambda_checkpoints = {3., 7.5};
+
+    double result_CK;
+    rhs_exp_counting_t rhs_CK;
+    config.solver_type = cash_karp_5_4;
+    ode_solver<double, flowgrid::linear_parametrization, rhs_exp_counting_t>(result_CK, y_ini, rhs_CK, config, false);
+
+    double result_DP;
+    rhs_exp_counting_t rhs_DP;
+    config.Lambda_now = Lambda_i;
+    config.solver_type = dormand_prince_5_4;
+    ode_solver<double, flowgrid::linear_parametrization, rhs_exp_counting_t>(result_DP, y_ini, rhs_DP, config, false);
+
+    utils::print("Evaluations of the right-hand side: Cash-Karp ", rhs_CK.evaluations.size(), ", Dormand-Prince ", rhs_DP.evaluations.size(), "\n");
+
+    double result_exact = exp(Lambda_f);
+    SECTION( "Is the correct value retrieved from ODE solver?" ) {
+        REQUIRE( std::abs(result_DP - result_exact) / result_exact < 1e-7 );
+        REQUIRE( std::abs(result_CK - result_exact) / result_exact < 1e-7 );
+    }
+    SECTION( "Is the right-hand side never evaluated twice at the same point?" ) {
+        REQUIRE( rhs_DP.repeated_evaluations() == 0 );
+    }
+
+}
@@ -0,0 +1,28 @@
+#include "catch.hpp"
+#include "../../bubble/bubble_function.hpp"
+#include "../../perturbation_theory_and_parquet/perturbation_theory.hpp"
+
+
+TEST_CASE("Does the fixed-node quadrature of K3 agree with the adaptive integration?", "[bubbles]") {
+    using Q = state_datatype;
+    using Calculator = BubbleFunctionCalculator<'a', Q, Vertex<Q,false>, Vertex<Q,false>, Vertex<Q,false>, Bubble<Q>>;
+    if constexpr (Calculator::fixed_node_quadrature_K3_supported and MAX_DIAG_CLASS == 3) {
+        // the K1 vertices of the p and t channel in SOPT yield a K3 contribution in an a bubble
+        fRG_config config;
+        State<Q> state (Lambda_ini, config);
+        state.initialize();
+        sopt_state(state);
+
+        Propagator<Q> G (Lambda_ini, state.selfenergy, 'g', config);
+        Bubble<Q> Pi (G, G, false);
+        Vertex<Q,false> dgamma = state.vertex;
+        Calculator calculator (dgamma, state.vertex, state.vertex, Pi, config.number_of_nodes, {false, false, true});
+
+        constexpr int n_samples = 8;
+        for (const int iw : {nBOS3 / 2, nBOS3 / 4}) {
+            const double deviation = calculator.compare_K3_on_fixed_nodes(iw, n_samples);
+            INFO("iw = " << iw << ", " << K3_quadrature_nodes_per_panel << " nodes per panel");
+            CHECK(deviation < 1e-4);
+        }
+    }
+}
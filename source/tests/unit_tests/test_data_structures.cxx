@@ -1,6 +1,7 @@
 #include "catch.hpp"
 #include "../../data_structures.hpp"
 #include "../../utilities/math_utils.hpp"
+#include "../../correlation_functions/n_point/data_container.hpp"
 
 TEST_CASE( "vector operations", "[data_structures]" ) {
 
@@ -237,3 +238,122 @@ TEST_CASE( "Compute finite differences", "[finite_differences]") {
         REQUIRE(errorcount == 0);
     }
 }
+
+
+TEST_CASE( "Does the tiled layout of a multiarray store every element once and return the same stencils?", "[multi-dimensional]" ) {
+    // like K3: {spin, w, v, vp, Keldysh, internal}; the frequency extents are no multiples of the tile size
+    const size_t rank = 6;
+    using layout = multidimensional::tiled_layout<1, 3, 4>;
+    const std::array<size_t,rank> dims = {2, 5, 6, 7, 4, 1};
+    multidimensional::multiarray<double,rank> row_major(dims);
+    multidimensional::multiarray<double,rank,layout> tiled(dims);
+
+    vec<int> count(row_major.size());
+    std::array<size_t,rank> idx;
+    for (size_t iflat = 0; iflat < row_major.size(); iflat++) {
+        getMultIndex<rank>(idx, iflat, dims);
+        const size_t position = layout::flat_index(idx, dims);
+        if (position < count.size()) count[position]++;
+        row_major.at(idx) = std::sin(0.1 * iflat) + iflat;
+        tiled.at(idx) = row_major.at(idx);
+    }
+    int errorcount_positions = 0;
+    for (int c : count) if (c != 1) errorcount_positions++;
+
+    // all stencils of a trilinear interpolation, vectorized over the Keldysh index
+    int errorcount_stencils = 0;
+    for (size_t iflat = 0; iflat < row_major.size(); iflat++) {
+        getMultIndex<rank>(idx, iflat, dims);
+        if (idx[1] + 1 >= dims[1] or idx[2] + 1 >= dims[2] or idx[3] + 1 >= dims[3] or idx[4] != 0) continue;
+        const auto values_row_major = row_major.get_values<3, 1, 4, 2>(idx);
+        const auto values_tiled = tiled.get_values<3, 1, 4, 2>(idx);
+        if ((values_row_major - values_tiled).norm() != 0.) errorcount_stencils++;
+    }
+
+    // the container converts between the layouts, e.g. for HDF5 I/O
+    dataContainerBase<double, rank, double, layout> container(dims);
+    container.set_vec(row_major);
+    const bool round_trip = (container.get_vec() == row_major);
+    container.direct_set(17, -1.);    // flat indices refer to the row-major order
+    getMultIndex<rank>(idx, 17, dims);
+
+    REQUIRE( errorcount_positions == 0 );
+    REQUIRE( errorcount_stencils == 0 );
+    REQUIRE( round_trip );
+    REQUIRE( container.val(idx) == -1. );
+    REQUIRE( container.data_ptr() == nullptr );
+}
+
+TEST_CASE( "Does a container which stores only some Keldysh components return the same values?", "[multi-dimensional]" ) {
+    // like K3: {spin, w, v, vp, Keldysh, internal}; only the Keldysh components 0, 2 and 3 are stored
+    const size_t rank = 6;
+    const int pos_Keldysh = 4;
+    const std::array<size_t,rank> dims = {1, 5, 6, 7, 4, 2};
+    multidimensional::multiarray<double,rank> values(dims);
+    std::array<size_t,rank> idx;
+    for (size_t iflat = 0; iflat < values.size(); iflat++) {
+        getMultIndex<rank>(idx, iflat, dims);
+        if (idx[pos_Keldysh] != 1) values.at(idx) = std::sin(0.1 * iflat) + iflat;
+    }
+
+    dataContainerBase<double, rank, double, multidimensional::row_major_layout, pos_Keldysh> container(dims);
+    container.set_vec(values);
+    container.set_stored_values({0, 2, 3});
+    const bool round_trip = (container.get_vec() == values);
+
+    // all stencils of a trilinear interpolation, vectorized over the internal index
+    int errorcount_stencils = 0;
+    for (size_t iflat = 0; iflat < values.size(); iflat++) {
+        getMultIndex<rank>(idx, iflat, dims);
+        if (idx[1] + 1 >= dims[1] or idx[2] + 1 >= dims[2] or idx[3] + 1 >= dims[3] or idx[5] != 0) continue;
+        const auto values_full = values.get_values<3, 1, 2, 2>(idx);
+        const auto values_reduced = container.get_values<3, 1, 2, 2>(idx);
+        if ((values_full - values_reduced).norm() != 0.) errorcount_stencils++;
+    }
+
+    // components which are not stored can only be set to zero, which has no effect on the stored components
+    idx = {0, 1, 2, 3, 1, 0};
+    container.setvert(0., idx);
+    container.direct_set(getFlatIndex<rank>(idx, dims), 0.);
+    container.setvert_vectorized<2>(Eigen::Matrix<double,2,1>::Zero(), idx);
+    const bool unchanged = (container.get_vec() == values);
+
+    REQUIRE( round_trip );
+    REQUIRE( errorcount_stencils == 0 );
+    REQUIRE( unchanged );
+    REQUIRE( container.val(idx) == 0. );
+    REQUIRE( container.acc(getFlatIndex<rank>(idx, dims)) == 0. );
+    REQUIRE( container.get_dims() == dims );
+    REQUIRE( container.storage_size() == values.size() * 3 / 4 );
+    REQUIRE( container.data_ptr() == nullptr );
+}
+
+TEST_CASE( "Does a large multiarray keep its values when it is initialized and copied (first touch)?", "[multi-dimensional]" ) {
+    // large enough for the parallel first touch if NUMA_FIRST_TOUCH
+    const size_t rank = 3;
+    const std::array<size_t,rank> dims = {4, 128, 130};
+    REQUIRE( dims[0] * dims[1] * dims[2] >= NUMA_FIRST_TOUCH_MIN_SIZE );
+
+    const multidimensional::multiarray<comp,rank> constant(dims, comp(1., -2.));
+    int errorcount_constant = 0;
+    for (const comp& value : constant) if (value != comp(1., -2.)) errorcount_constant++;
+
+    multidimensional::multiarray<comp,rank> original(dims);
+    for (size_t iflat = 0; iflat < original.size(); iflat++) original.flat_at(iflat) = comp(std::sin(0.1 * iflat), iflat);
+    const multidimensional::multiarray<comp,rank> copy(original);
+    multidimensional::multiarray<comp,rank> assigned(dims);
+    assigned = original;            // same size
+    multidimensional::multiarray<comp,rank> resized;
+    resized = original;             // new memory
+
+    REQUIRE( errorcount_constant == 0 );
+    REQUIRE( copy == original );
+    REQUIRE( assigned == original );
+    REQUIRE( resized == original );
+    REQUIRE( resized.length() == dims );
+    REQUIRE( resized.length_cumul() == original.length_cumul() );
+
+    // every touched page is found on some NUMA node (if the placement can be queried)
+    const std::map<int, size_t> pages = utils::count_pages_per_numa_node(copy.begin(), copy.size() * sizeof(comp));
+    REQUIRE( pages.count(-1) == 0 );
+}
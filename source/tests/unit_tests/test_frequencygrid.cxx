@@ -114,6 +114,79 @@ TEST_CASE( "How accurate is the inversion of the frequency grid function?" , "[g
     REQUIRE(tdeviations.max_norm() < tolerance);
 
 }
+
+/// compares the branch-free inverse grid map get_auxgrid_index() of a grid with t_from_frequency() and get_grid_index()
+template <typename gridType>
+void check_branchfree_inverse_grid_map(const gridType& grid) {
+    const int N = grid.number_of_gridpoints;
+    const double range = grid.w_upper - grid.w_lower;
+
+    // frequencies: grid points, points in between (uniform on the auxiliary grid) and points outside of the box
+    std::vector<double> frequencies;
+    for (int i = 0; i < N; i++) frequencies.push_back(grid.get_frequency(i));
+    const int n_aux = 20 * N;
+    for (int i = 0; i < n_aux; i++) frequencies.push_back(grid.frequency_from_t(grid.t_lower + (grid.t_upper - grid.t_lower) * (i + 0.37) / n_aux));
+    for (int i = 0; i <= 100; i++) frequencies.push_back(grid.w_lower - 0.5 * range + 2. * range * i / 100.);
+
+    double max_deviation_t = 0.;
+    bool index_in_range = true;
+    bool offset_in_range = true;
+    bool consistent_with_get_grid_index = true;
+    bool clamped_outside = true;
+    for (const double w : frequencies) {
+        double dt_normalized;
+        const int index = grid.get_auxgrid_index(dt_normalized, w);
+        if (index < 0 or index > N - 2) { index_in_range = false; continue; }
+        if (dt_normalized < 0. or dt_normalized > 1.) offset_in_range = false;
+
+        if (w < grid.w_lower) {
+            if (index != 0 or dt_normalized != 0.) clamped_outside = false;
+        }
+        else if (w > grid.w_upper) {
+            if (index != N - 2 or dt_normalized != 1.) clamped_outside = false;
+        }
+        else {
+            // the reconstructed point on the auxiliary grid has to agree with t(w):
+            const double t_reconstructed = grid.get_auxiliary_gridpoint(index) + dt_normalized * (grid.get_auxiliary_gridpoint(index+1) - grid.get_auxiliary_gridpoint(index));
+            max_deviation_t = std::max(max_deviation_t, std::abs(t_reconstructed - grid.t_from_frequency(w)));
+
+            // the index may only differ from get_grid_index() by rounding at a grid point:
+            freqType t;
+            const int index_reference = grid.get_grid_index(t, w);
+            if (index != index_reference) {
+                const bool at_gridpoint = (index == index_reference + 1 and dt_normalized < 1e-10) or (index == index_reference - 1 and dt_normalized > 1. - 1e-10);
+                if (not at_gridpoint) consistent_with_get_grid_index = false;
+            }
+        }
+    }
+
+    REQUIRE(index_in_range);
+    REQUIRE(offset_in_range);
+    REQUIRE(clamped_outside);
+    REQUIRE(consistent_with_get_grid_index);
+    REQUIRE(max_deviation_t < 1e-10 * (1. + grid.t_upper - grid.t_lower));
+}
+
+TEST_CASE( "Does the branch-free inverse grid map return the correct index and offset?" , "[grid functions]") {
+    fRG_config test_config;
+
+    SECTION("eliasGrid") {
+        FrequencyGrid<eliasGrid> bosonic('b', 2, Lambda_ini, test_config);
+        FrequencyGrid<eliasGrid> fermionic('f', 3, Lambda_ini, test_config);
+        check_branchfree_inverse_grid_map(bosonic);
+        check_branchfree_inverse_grid_map(fermionic);
+    }
+    SECTION("hybridGrid") {
+        FrequencyGrid<hybridGrid> bosonic('b', 2, Lambda_ini, test_config);
+        FrequencyGrid<hybridGrid> fermionic_positive('f', 3, Lambda_ini, test_config, true);
+        check_branchfree_inverse_grid_map(bosonic);
+        check_branchfree_inverse_grid_map(fermionic_positive);
+    }
+    SECTION("angularGrid") {
+        FrequencyGrid<angularGrid> bosonic('b', 3, Lambda_ini, test_config, false);
+        check_branchfree_inverse_grid_map(bosonic);
+    }
+}
 #endif
 
 TEST_CASE("Do I return the correct in frequency indices?", "[frequency index]") {
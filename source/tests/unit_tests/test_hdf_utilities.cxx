@@ -19,4 +19,74 @@ TEST_CASE( "Does it work to read and write States to HDF files?", "[hdf for stat
         REQUIRE( passed );
     }
 
-}
\ No newline at end of file
+}
+
+TEST_CASE( "Are checkpoints written in the background complete after waiting?", "[hdf for vectors/multiarrays]" ) {
+
+    const std::string filename = "test_checkpoint_writer.h5";
+    checkpoint_writer writer;
+    for (int i = 0; i < 3; i++) {
+        const std::vector<double> data(1000, (double) i);
+        writer.submit([filename, data]() {
+            std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
+            H5::H5File file = create_hdf_file(filename);
+            write_to_hdf(file, "data", data, false);
+            file.close();
+        });
+    }
+    writer.wait();
+    REQUIRE( not writer.busy() );
+
+    std::vector<double> result;
+    H5::H5File file = open_hdf_file_readOnly(filename);
+    read_from_hdf(file, "data", result);
+    file.close();
+
+    SECTION( "Is the data of the last checkpoint in the file?" ) {
+        REQUIRE( result == std::vector<double>(1000, 2.) );
+    }
+
+    SECTION( "Is an error of a checkpoint passed on?" ) {
+        writer.submit([]() { throw std::runtime_error("checkpoint failed"); });
+        REQUIRE_THROWS( writer.wait() );
+    }
+
+    SECTION( "Does the terminate handler wait for a running job without joining it?" ) {
+        std::atomic<bool> finished{false};
+        writer.submit([&finished]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            finished = true;
+        });
+        writer.finish_before_terminate(std::chrono::seconds(10));
+        REQUIRE( finished );
+        REQUIRE( writer.busy() ); // still joinable, joined by wait()
+        writer.wait();
+    }
+
+}
+
+TEST_CASE( "Are checkpoints of unfinished computations identified by their info?", "[hdf for states]" ) {
+
+    const std::string filename = "test_midstep_checkpoint.h5";
+    fRG_config config;
+    State<state_datatype> state (Lambda_ini, config);
+    state += 0.5;
+    const State<state_datatype> state_doubled = state * 2.;
+    const std::vector<double> info = {Lambda_ini, state.norm(), 3.};
+    write_checkpoint_to_hdf(filename, info, state, state_doubled);
+
+    std::vector<double> info_read;
+    REQUIRE( read_checkpoint_info_from_hdf(filename, info_read) );
+    REQUIRE( info_read == info );
+    REQUIRE( not std::ifstream(filename + ".tmp").good() ); // written under the temporary name and renamed
+
+    SECTION( "Are the States stored in the Lambda layers?" ) {
+        const State<state_datatype> state_read = read_state_from_hdf(filename, 1);
+        REQUIRE( (state_read - state_doubled).norm() <= 1e-12 * state_doubled.norm() );
+    }
+
+    SECTION( "Is a missing checkpoint recognized?" ) {
+        REQUIRE( not read_checkpoint_info_from_hdf("test_missing_checkpoint.h5", info_read) );
+    }
+
+}
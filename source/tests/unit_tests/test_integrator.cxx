@@ -2,6 +2,7 @@
 #include "../../integrator/integrator.hpp"
 #include "../../utilities/util.hpp"
 #include "../../integrator/integrator_NR.hpp"
+#include "../../integrator/integrator_global_adaptive.hpp"
 #include <string>
 
 /* Test integrand class with int template parameter to select different test integrand functions */
@@ -45,4 +46,130 @@ TEST_CASE( "integrate different test functions", "[integrator]" ) {
         double res = adaptor.integrate(-50., 50.);
         CHECK(res == Approx(exact[i]).epsilon(0.0001));
     }
+
+    WHEN( "globally adaptive Gauss-Kronrod integrator" ) {
+        Adapt_global<TestIntegrand> adaptor(integrator_tol, integrand);
+        double res = adaptor.integrate(-50., 50.);
+        CHECK(res == Approx(exact[i]).epsilon(0.0001));
+    }
+}
+
+/* Test integrand providing a batched evaluation, which counts how many points were requested in batches */
+class TestIntegrandBatched : public TestIntegrand {
+public:
+    mutable int n_batched = 0;
+    TestIntegrandBatched(unsigned int N_in) : TestIntegrand(N_in) {}
+
+    void evaluate_batch(const double* x, int n, double* out) const {
+        n_batched += n;
+        for (int i = 0; i < n; ++i) out[i] = (*this)(x[i]);
+    }
+};
+
+TEST_CASE( "integrate test functions with batched evaluation", "[integrator]" ) {
+
+    auto i = GENERATE( 0, 1, 2, 3, 4 );
+    TestIntegrand integrand (i);
+    TestIntegrandBatched integrand_batched (i);
+
+    Adapt<TestIntegrand> adaptor(integrator_tol, integrand);
+    Adapt<TestIntegrandBatched> adaptor_batched(integrator_tol, integrand_batched);
+    double res = adaptor.integrate(-50., 50.);
+    double res_batched = adaptor_batched.integrate(-50., 50.);
+
+    CHECK(integrand_batched.n_batched >= 13);
+    CHECK(res_batched == res);
+}
+
+/* Test integrand counting its evaluations */
+class TestIntegrandCounted : public TestIntegrand {
+public:
+    mutable int n_evaluations = 0;
+    TestIntegrandCounted(unsigned int N_in) : TestIntegrand(N_in) {}
+
+    auto operator() (double x) const -> double {
+        n_evaluations++;
+        return TestIntegrand::operator()(x);
+    }
+};
+
+TEST_CASE( "globally adaptive integrator needs fewer evaluations for an oscillating integrand", "[integrator]" ) {
+
+    TestIntegrandCounted integrand_recursive (0);
+    TestIntegrandCounted integrand_global (0);
+
+    Adapt<TestIntegrandCounted> adaptor_recursive(integrator_tol, integrand_recursive);
+    Adapt_global<TestIntegrandCounted> adaptor_global(integrator_tol, integrand_global);
+    const double res_recursive = adaptor_recursive.integrate(-50., 50.);
+    const double res_global = adaptor_global.integrate(-50., 50.);
+
+    CHECK(res_global == Approx(res_recursive).epsilon(0.0001));
+    CHECK(integrand_global.n_evaluations == adaptor_global.n_evaluations);
+    CHECK(integrand_global.n_evaluations < integrand_recursive.n_evaluations);
+}
+
+/* Matrix-valued test integrand whose components differ by many orders of magnitude */
+class TestIntegrandMatrix {
+public:
+    using Q = Eigen::Matrix<comp, 2, 2>;
+    auto operator() (double x) const -> Q {
+        Q result;
+        result << exp(-x*x), 1e-8 / (0.01 + (x-1)*(x-1)),
+                  glb_i * cos(x) * exp(-x*x), 0.;
+        return result;
+    }
+};
+
+TEST_CASE( "globally adaptive integrator with component-wise error control", "[integrator]" ) {
+
+    TestIntegrandMatrix integrand;
+    Eigen::Matrix<comp, 2, 2> exact;
+    const double lorentzian = 1e-8 * 10. * (atan(10. * 9.) + atan(10. * 11.)); // integral of the off-diagonal peak
+    exact << 1.7724538509055159, lorentzian,
+             glb_i * 1.3803884470431430, 0.;
+
+    Adapt_global<TestIntegrandMatrix> adaptor(integrator_tol, integrand, componentwise);
+    const Eigen::Matrix<comp, 2, 2> res = adaptor.integrate(-10., 10.);
+
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 2; j++) {
+            INFO("component " << i << ", " << j);
+            CHECK(std::abs(res(i, j) - exact(i, j)) <= 0.0001 * std::abs(exact(i, j)) + 1e-20);
+        }
+    }
+}
+
+TEST_CASE( "Gauss-Legendre rule", "[integrator]" ) {
+    vec<double> nodes, weights;
+
+    SECTION( "Are the nodes and weights correct for n = 3 and n = 4?" ) {
+        gauss_legendre_rule(3, nodes, weights);
+        const std::vector<double> nodes_3 {-sqrt(0.6), 0., sqrt(0.6)};
+        const std::vector<double> weights_3 {5./9., 8./9., 5./9.};
+        for (int i = 0; i < 3; i++) {
+            CHECK(std::abs(nodes[i] - nodes_3[i]) < 1e-14);
+            CHECK(std::abs(weights[i] - weights_3[i]) < 1e-14);
+        }
+
+        gauss_legendre_rule(4, nodes, weights);
+        const std::vector<double> nodes_4 {-0.8611363115940526, -0.3399810435848563, 0.3399810435848563, 0.8611363115940526};
+        const std::vector<double> weights_4 {0.3478548451374538, 0.6521451548625461, 0.6521451548625461, 0.3478548451374538};
+        for (int i = 0; i < 4; i++) {
+            CHECK(std::abs(nodes[i] - nodes_4[i]) < 1e-14);
+            CHECK(std::abs(weights[i] - weights_4[i]) < 1e-14);
+        }
+    }
+
+    SECTION( "Are polynomials up to degree 2n-1 integrated exactly?" ) {
+        for (int n : {1, 2, 5, 8, 16}) {
+            gauss_legendre_rule(n, nodes, weights);
+            for (int degree = 0; degree < 2 * n; degree++) {
+                double result = 0.;
+                for (int i = 0; i < n; i++) result += weights[i] * pow(nodes[i], degree);
+                const double exact = degree % 2 == 0 ? 2. / (degree + 1) : 0.;
+                INFO("n = " << n << ", degree = " << degree);
+                CHECK(std::abs(result - exact) < 1e-13);
+            }
+        }
+    }
 }
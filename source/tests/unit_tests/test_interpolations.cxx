@@ -2,6 +2,7 @@
 #include "../../data_structures.hpp"
 #include "../../multidimensional/multiarray.hpp"
 #include "../../correlation_functions/four_point/r_vertex.hpp"
+#include "../../correlation_functions/n_point/low_rank_buffer.hpp"
 #include "../../symmetries/symmetry_transformations.hpp"
 #include "../../utilities/hdf5_routines.hpp"
 
@@ -827,3 +828,229 @@ TEST_CASE("Does the vectorized interpolation reproduce the results of repeated s
     }
 
 }
+
+
+#if MAX_DIAG_CLASS == 3 and not defined(DENSEGRID)
+TEST_CASE("Does the tricubic interpolation without stored coefficients reproduce the stored spline?", "[interpolations]") {
+    using buffer_type = dataBuffer<state_datatype, k3, K3_config.rank, K3_config.num_freqs, K3_config.position_first_freq_index, bufferFrequencyGrid<k3>, cubic>;
+    using result_type = Eigen::Matrix<state_datatype, 4, 1>;
+
+    const double Lambda = 1.8;
+    fRG_config test_config;
+    buffer_type K3(Lambda, K3_config.dims, test_config);
+
+    // products of quadratic polynomials in the auxiliary frequencies are reproduced exactly by the finite-difference derivatives
+    auto quadraticFunction3D = [](double x, double y, double z) -> state_datatype {return 1. + x - 0.5*y*y + x*y*z + 0.3*x*x*y*z*z;};
+    for (my_index_t iflat = 0; iflat < getFlatSize(K3.get_dims()); iflat++) {
+        my_defs::K3::index_type idx;
+        getMultIndex<rank_K3>(idx, iflat, K3.get_dims());
+        double w, v, vp;
+        K3.frequencies.get_freqs_aux(w, v, vp, idx[my_defs::K3::omega], idx[my_defs::K3::nu], idx[my_defs::K3::nup]);
+        K3.setvert(quadraticFunction3D(w, v, vp) * (1. + idx[my_defs::K3::keldysh]), idx);
+    }
+
+    const int N = 9;
+    const double tw_lower = K3.frequencies.  primary_grid.t_lower, tw_upper = K3.frequencies.  primary_grid.t_upper;
+    const double tv_lower = K3.frequencies.secondary_grid.t_lower, tv_upper = K3.frequencies.secondary_grid.t_upper;
+    const double tvp_lower= K3.frequencies. tertiary_grid.t_lower, tvp_upper= K3.frequencies. tertiary_grid.t_upper;
+    auto interpolate_all = [&](vec<state_datatype>& values, vec<result_type>& values_vectorized) {
+        my_defs::K3::index_type idx{};
+        for (int iw = 0; iw < N; iw++) {
+            for (int iv = 0; iv < N; iv++) {
+                for (int ivp = 0; ivp < N; ivp++) {
+                    const double tw = tw_lower + (tw_upper - tw_lower) * (iw  + 0.37) / N;
+                    const double tv = tv_lower + (tv_upper - tv_lower) * (iv  + 0.61) / N;
+                    const double tvp= tvp_lower+ (tvp_upper- tvp_lower)* (ivp + 0.13) / N;
+                    const std::array<double,3> freqs = {K3.frequencies.  primary_grid.frequency_from_t(tw),
+                                                        K3.frequencies.secondary_grid.frequency_from_t(tv),
+                                                        K3.frequencies. tertiary_grid.frequency_from_t(tvp)};
+                    const int i = (iw * N + iv) * N + ivp;
+                    values[i] = K3.template interpolate_impl<state_datatype>(freqs, idx) - quadraticFunction3D(tw, tv, tvp);
+                    if constexpr(KELDYSH) values_vectorized[i] = K3.template interpolate_impl<result_type>(freqs, idx);
+                }
+            }
+        }
+    };
+
+    vec<state_datatype> errors_coefficients(N*N*N), errors_on_the_fly(N*N*N);
+    vec<result_type> vectorized_coefficients(N*N*N), vectorized_on_the_fly(N*N*N);
+
+    double t_start = utils::get_time();
+    K3.set_spline_storage(spline_coefficients);
+    K3.initInterpolator();
+    const size_t size_coefficients = K3.get_interpolator_size();
+    utils::print("K3 spline with stored coefficients initialized - ");
+    utils::get_time(t_start);
+    t_start = utils::get_time();
+    interpolate_all(errors_coefficients, vectorized_coefficients);
+    utils::print("K3 interpolation with stored coefficients performed - ");
+    utils::get_time(t_start);
+
+    t_start = utils::get_time();
+    K3.set_spline_storage(spline_on_the_fly);
+    K3.initInterpolator();
+    const size_t size_on_the_fly = K3.get_interpolator_size();
+    interpolate_all(errors_on_the_fly, vectorized_on_the_fly);
+    utils::print("K3 interpolation without stored coefficients performed - ");
+    utils::get_time(t_start);
+    utils::print("Memory of the K3 interpolator in units of the data: ", double(size_coefficients) / getFlatSize(K3.get_dims()),
+                 " (stored coefficients) vs. ", double(size_on_the_fly) / getFlatSize(K3.get_dims()), " (on the fly)", "\n");
+
+    REQUIRE(size_on_the_fly == 0);
+    REQUIRE(errors_coefficients.max_norm() < 1e-10);
+    REQUIRE(errors_on_the_fly.max_norm() < 1e-10);
+    REQUIRE((errors_coefficients - errors_on_the_fly).max_norm() < 1e-12);
+    if constexpr(KELDYSH) {
+        double deviation = 0.;
+        for (int i = 0; i < N*N*N; i++) deviation = std::max(deviation, (vectorized_coefficients[i] - vectorized_on_the_fly[i]).template lpNorm<Eigen::Infinity>());
+        REQUIRE(deviation < 1e-12);
+    }
+}
+#endif
+
+
+#if MAX_DIAG_CLASS == 3 and GRID != 2
+TEST_CASE("Does the strided nearest-neighbour lookup agree with interpolate_nearest3D?", "[interpolations]") {
+    using buffer_type = dataBuffer<state_datatype, k3, K3_config.rank, K3_config.num_freqs, K3_config.position_first_freq_index, bufferFrequencyGrid<k3>, linear_on_aux>;
+    constexpr my_index_t pos = K3_config.position_first_freq_index;
+
+    const double Lambda = 1.8;
+    fRG_config test_config;
+    buffer_type K3(Lambda, K3_config.dims, test_config);
+    for (my_index_t iflat = 0; iflat < getFlatSize(K3.get_dims()); iflat++) {
+        my_defs::K3::index_type idx;
+        getMultIndex<rank_K3>(idx, iflat, K3.get_dims());
+        K3.setvert(state_datatype(iflat), idx);
+    }
+    const auto& grids = K3.get_VertexFreqGrid();
+    const multidimensional::multiarray<state_datatype,rank_K3>& data = K3.get_vec();
+    const my_defs::K3::index_type idx_ini{};
+
+    const int N = 10000;
+    vec<state_datatype> result_nested(N);
+    vec<state_datatype> result_strided(N);
+    for (int i = 0; i < N; i++) {
+        const double s = (i + 0.5) / N;
+        const std::array<freqType,3> frequencies = {grids.  primary_grid.frequency_from_t(grids.get_tlower_b_aux() + (grids.get_tupper_b_aux() - grids.get_tlower_b_aux()) * s),
+                                                    grids.secondary_grid.frequency_from_t(grids.get_tlower_f_aux() + (grids.get_tupper_f_aux() - grids.get_tlower_f_aux()) * std::fmod(7.3*s, 1.)),
+                                                    grids. tertiary_grid.frequency_from_t(grids. tertiary_grid.t_lower + (grids. tertiary_grid.t_upper - grids. tertiary_grid.t_lower) * std::fmod(13.7*s, 1.))};
+        my_defs::K3::index_type idx = idx_ini;
+        result_nested[i] = interpolate_nearest3D<state_datatype>(frequencies[0], frequencies[1], frequencies[2],
+                                                                 grids.primary_grid, grids.secondary_grid, grids.tertiary_grid,
+                                                                 [&](int iw, int iv, int ivp) -> state_datatype {
+                                                                     idx[pos] = iw; idx[pos+1] = iv; idx[pos+2] = ivp;
+                                                                     return data.at(idx);
+                                                                 });
+        result_strided[i] = interpolate_nearest_strided<3, pos, 1>(data, idx_ini, frequencies, grids)[0];
+    }
+
+    REQUIRE((result_strided - result_nested).max_norm() == 0.);
+}
+#endif
+
+
+TEST_CASE("How accurate is a vertex buffer stored in single precision?", "[interpolations]") {
+    using container_double = DataContainer<state_datatype, K3_config.rank, K3_config.num_freqs, K3_config.position_first_freq_index, bufferFrequencyGrid<k3>>;
+    using container_single = DataContainer<state_datatype, K3_config.rank, K3_config.num_freqs, K3_config.position_first_freq_index, bufferFrequencyGrid<k3>, single_precision_t<state_datatype>>;
+    using buffer_double = Interpolator<state_datatype, K3_config.rank, K3_config.num_freqs, K3_config.position_first_freq_index, container_double, linear_on_aux>;
+    using buffer_single = Interpolator<state_datatype, K3_config.rank, K3_config.num_freqs, K3_config.position_first_freq_index, container_single, linear_on_aux>;
+
+    const double Lambda = 1.8;
+    fRG_config test_config;
+    buffer_double K3_double(Lambda, K3_config.dims, test_config);
+    buffer_single K3_single(Lambda, K3_config.dims, test_config);
+    REQUIRE(container_single::reduced_precision);
+    REQUIRE(K3_single.data_ptr() == nullptr);
+
+    auto testFunction3D = [](double x, double y, double z) -> state_datatype {return 1. + x - 0.5*y*y + std::sin(3.*x*y*z);};
+    for (my_index_t iflat = 0; iflat < getFlatSize(K3_double.get_dims()); iflat++) {
+        my_defs::K3::index_type idx;
+        getMultIndex<rank_K3>(idx, iflat, K3_double.get_dims());
+        double w, v, vp;
+        K3_double.frequencies.get_freqs_aux(w, v, vp, idx[my_defs::K3::omega], idx[my_defs::K3::nu], idx[my_defs::K3::nup]);
+        const state_datatype value = testFunction3D(w, v, vp) * (1. + idx[my_defs::K3::keldysh]);
+        K3_double.setvert(value, idx);
+        K3_single.setvert(value, idx);
+    }
+    K3_double.initInterpolator();
+    K3_single.initInterpolator();
+
+    const double deviation_data = (K3_single.get_vec() - K3_double.get_vec()).max_norm() / K3_double.get_vec().max_norm();
+
+    const int N = 9;
+    double deviation_interpolation = 0., max_value = 0.;
+    my_defs::K3::index_type idx{};
+    for (int iw = 0; iw < N; iw++) {
+        for (int iv = 0; iv < N; iv++) {
+            for (int ivp = 0; ivp < N; ivp++) {
+                const std::array<double,3> freqs = {
+                        K3_double.frequencies.  primary_grid.frequency_from_t(K3_double.frequencies.  primary_grid.t_lower + (K3_double.frequencies.  primary_grid.t_upper - K3_double.frequencies.  primary_grid.t_lower) * (iw  + 0.37) / N),
+                        K3_double.frequencies.secondary_grid.frequency_from_t(K3_double.frequencies.secondary_grid.t_lower + (K3_double.frequencies.secondary_grid.t_upper - K3_double.frequencies.secondary_grid.t_lower) * (iv  + 0.61) / N),
+                        K3_double.frequencies. tertiary_grid.frequency_from_t(K3_double.frequencies. tertiary_grid.t_lower + (K3_double.frequencies. tertiary_grid.t_upper - K3_double.frequencies. tertiary_grid.t_lower) * (ivp + 0.13) / N)};
+                const state_datatype value_double = K3_double.template interpolate_impl<state_datatype>(freqs, idx);
+                const state_datatype value_single = K3_single.template interpolate_impl<state_datatype>(freqs, idx);
+                deviation_interpolation = std::max(deviation_interpolation, std::abs(value_single - value_double));
+                max_value = std::max(max_value, std::abs(value_double));
+            }
+        }
+    }
+    deviation_interpolation /= max_value;
+
+    utils::print("Relative deviation of K3 stored in single precision: data ", deviation_data, ", interpolation ", deviation_interpolation,
+                 "; memory ", sizeof(single_precision_t<state_datatype>), " instead of ", sizeof(state_datatype), " bytes per entry", "\n");
+
+    REQUIRE(deviation_data < 1e-6);
+    REQUIRE(deviation_interpolation < 1e-6);
+}
+
+TEST_CASE("Does the low-rank compression of K3 respect its tolerance?", "[interpolations]") {
+    using buffer_dense = rvert<state_datatype>::buffer_type_K3;
+    using buffer_compressed = lowRankBuffer<state_datatype, K3_config.rank, K3_config.position_first_freq_index, bufferFrequencyGrid<k3>, linear_on_aux>;
+
+    const double Lambda = 1.8;
+    fRG_config test_config;
+    buffer_dense K3(Lambda, K3_config.dims, test_config);
+
+    // vertex-like function of unknown rank in (v, vp): peaks along the diagonal and the anti-diagonal
+    auto testFunction3D = [](double x, double y, double z) -> state_datatype {
+        return 1. / (1. + x*x + (y - z)*(y - z)) + 0.5 / (2. + (y + z)*(y + z)) / (1. + 0.1 * x*x) + 0.2 * std::exp(-0.1 * (y*y + z*z));
+    };
+    for (my_index_t iflat = 0; iflat < getFlatSize(K3.get_dims()); iflat++) {
+        my_defs::K3::index_type idx;
+        getMultIndex<rank_K3>(idx, iflat, K3.get_dims());
+        double w, v, vp;
+        K3.frequencies.get_freqs_w(w, v, vp, idx[my_defs::K3::omega], idx[my_defs::K3::nu], idx[my_defs::K3::nup]);
+        K3.setvert(testFunction3D(w, v, vp) * (1. + idx[my_defs::K3::keldysh]), idx);
+    }
+    K3.initInterpolator();
+    const double max_value = K3.get_vec().max_norm();
+
+    Eigen::Index rank_previous = 0;
+    for (const double tolerance : {1e-5, 1e-4, 1e-3, 1e-2}) {
+        const buffer_compressed K3_compressed(K3, tolerance);
+        const double deviation_data = (K3_compressed.get_vec() - K3.get_vec()).max_norm() / max_value;
+
+        double deviation_interpolation = 0.;
+#ifndef DENSEGRID
+        const int N = 7;
+        for (int iw = 0; iw < N; iw++) {
+            for (int iv = 0; iv < N; iv++) {
+                for (int ivp = 0; ivp < N; ivp++) {
+                    const VertexInput input(0, 0, -8. + 16. * (iw + 0.37) / N, -8. + 16. * (iv + 0.61) / N, -8. + 16. * (ivp + 0.13) / N, 0, 'a');
+                    deviation_interpolation = std::max(deviation_interpolation, std::abs(K3_compressed.interpolate(input) - K3.interpolate(input)));
+                }
+            }
+        }
+        deviation_interpolation /= max_value;
+#endif
+
+        utils::print("Compression of K3 by truncated SVDs at tolerance ", tolerance, ": ratio ", K3_compressed.compression_ratio(), ", max. rank ", K3_compressed.max_rank(),
+                     ", rel. deviation: data ", deviation_data, ", interpolation ", deviation_interpolation, "\n");
+
+        REQUIRE(K3_compressed.get_max_error() <= tolerance * max_value);
+        REQUIRE(deviation_data <= tolerance);
+        REQUIRE(deviation_interpolation <= tolerance);
+        if (rank_previous > 0) REQUIRE(K3_compressed.max_rank() <= rank_previous); // a looser tolerance never needs a larger rank
+        rank_previous = K3_compressed.max_rank();
+    }
+}
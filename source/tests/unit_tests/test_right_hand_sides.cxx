@@ -0,0 +1,39 @@
+#include "catch.hpp"
+#include "../../mfRG_flow/right_hand_sides.hpp"
+#include "../../perturbation_theory_and_parquet/perturbation_theory.hpp"
+
+// evaluates the 3-loop right-hand side twice, hence hidden from the default run (select it by its tag)
+TEST_CASE( "Does a right-hand side resumed after loop order 2 agree with an uninterrupted evaluation?", "[.][midstep checkpoints]" ) {
+
+    fRG_config config;
+    config.nloops = 3;
+    State<state_datatype> Psi (Lambda_ini, config);
+    Psi.initialize();     // bare vertex and Hartree term in the self-energy
+    sopt_state(Psi);
+
+    rhs_n_loop_flow_t<state_datatype> rhs (config);
+    rhs.checkpoint_config = {"test_rhs_checkpoint", 2, cash_karp_5_4};
+    State<state_datatype> dPsi_uninterrupted (Lambda_ini, config);
+    rhs(Psi, dPsi_uninterrupted, Lambda_ini);   // writes the side files of all loop orders
+
+    // interrupted during loop order 3: its side file has not been written
+    if constexpr (ASYNC_CHECKPOINTS) async_checkpoints().wait();
+    if (mpi_world_rank() == 0) std::remove(rhs_checkpoint<state_datatype>::file_name(rhs.checkpoint_config.filename, 3).c_str());
+    REQUIRE( rhs_checkpoint<state_datatype>(rhs.checkpoint_config, Psi, Lambda_ini, config.nloops).loops_completed == 2 );
+
+    State<state_datatype> dPsi_resumed (Lambda_ini, config);
+    rhs(Psi, dPsi_resumed, Lambda_ini);
+
+    // no SECTIONs, since every SECTION would repeat the evaluations above
+    REQUIRE( (dPsi_resumed - dPsi_uninterrupted).norm() <= 1e-12 * dPsi_uninterrupted.norm() );
+
+    // the side files are only used by the same stage of the same method
+    rhs_checkpoint_config other_stage = rhs.checkpoint_config;
+    other_stage.stage = 3;
+    REQUIRE( rhs_checkpoint<state_datatype>(other_stage, Psi, Lambda_ini, config.nloops).loops_completed == 0 );
+    rhs_checkpoint_config other_method = rhs.checkpoint_config;
+    other_method.method = dormand_prince_5_4;
+    REQUIRE( rhs_checkpoint<state_datatype>(other_method, Psi, Lambda_ini, config.nloops).loops_completed == 0 );
+
+    rhs.remove_checkpoints();
+}
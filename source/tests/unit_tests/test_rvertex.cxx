@@ -236,6 +236,37 @@ TEST_CASE("Does the update of the frequency grid work (for shrinking grids)?", "
     }
 }
 
+TEST_CASE("Is the cached iteration space of a bubble invalidated when the frequency grid changes?", "[update grid]") {
+    fRG_config test_config;
+    rvert<state_datatype> testvertex('a', Lambda_ini, test_config, true);
+
+    auto& frequencies = testvertex.K1.frequencies;
+    frequencies.iteration_space.valid = true;
+    frequencies.iteration_space.channel = 'a';
+    frequencies.iteration_space.flat_size = 10;
+    frequencies.iteration_space.freq_transformations = testvertex.freq_transformations.K1;
+    const std::vector<int>& symmetries = testvertex.freq_transformations.K1;
+
+    SECTION("Is the cache found for matching channel, size and frequency symmetries only?") {
+        REQUIRE(frequencies.has_iteration_space('a', 10, symmetries));
+        REQUIRE(not frequencies.has_iteration_space('p', 10, symmetries));
+        REQUIRE(not frequencies.has_iteration_space('a', 11, symmetries));
+        std::vector<int> other_symmetries (symmetries.size(), 0); // no symmetry-reduced sector
+        REQUIRE(not frequencies.has_iteration_space('a', 10, other_symmetries));
+    }
+
+    SECTION("Is the cache invalidated by a new grid?") {
+        auto bfreqK1 = testvertex.K1.get_VertexFreqGrid();
+        testvertex.K1.set_VertexFreqGrid(bfreqK1);
+        REQUIRE(not frequencies.has_iteration_space('a', 10, symmetries));
+    }
+
+    SECTION("Is the cache invalidated by a rescaling of the grid?") {
+        frequencies.guess_essential_parameters(Lambda_ini, test_config);
+        REQUIRE(not frequencies.has_iteration_space('a', 10, symmetries));
+    }
+}
+
 #if not KELDYSH_FORMALISM
 TEST_CASE( "Are frequency symmetries enforced by enforce_freqsymmetriesK1() for K1a?", "[frequency_symmetries]" ) {
     rvert<state_datatype> avertex('a', Lambda_ini, fRG_config(), true);
@@ -35,7 +35,7 @@
 
 int main(int argc, char* argv[]) {
 #ifdef USE_MPI
-    MPI_Init(nullptr, nullptr);
+    mpi_init_funneled(); // only the master thread communicates via MPI
 #endif
 #ifdef INTEGRATION_TESTS
 
@@ -0,0 +1,68 @@
+#include "checkpoint_writer.hpp"
+#include "util.hpp"
+
+void checkpoint_writer::join() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (worker.joinable()) worker.join();
+}
+
+checkpoint_writer::~checkpoint_writer() {
+    flush();
+}
+
+void checkpoint_writer::submit(std::function<void()> job) {
+    wait();
+    std::lock_guard<std::mutex> lock(mutex);
+    job_running = true;
+    worker = std::thread([this, job = std::move(job)]() {
+        worker_id = std::this_thread::get_id();
+        try { job(); }
+        catch (...) { error = std::current_exception(); }
+        job_running = false;
+    });
+}
+
+void checkpoint_writer::wait() {
+    join();
+    if (error) {
+        std::exception_ptr e = error;
+        error = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+void checkpoint_writer::flush() noexcept {
+    try { wait(); }
+    catch (const std::exception& e) { utils::print("Error while writing a checkpoint: ", e.what(), "\n"); }
+    catch (...) { utils::print("Error while writing a checkpoint.\n"); }
+}
+
+bool checkpoint_writer::busy() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return worker.joinable();
+}
+
+void checkpoint_writer::finish_before_terminate(const std::chrono::seconds timeout) noexcept {
+    if (std::this_thread::get_id() == worker_id.load()) return; // the job itself terminated
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (job_running and std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+checkpoint_writer& async_checkpoints() {
+    // constructed at the first use (after the HDF5 library has been initialized), hence destroyed, i.e. flushed,
+    // at exit() before the HDF5 library is closed
+    static checkpoint_writer writer;
+    static const std::terminate_handler previous_handler = std::set_terminate([]() {
+        async_checkpoints().finish_before_terminate(std::chrono::seconds(60)); // give the last checkpoint a chance to be completed before aborting
+        if (previous_handler != nullptr) previous_handler();
+        std::abort();
+    });
+    return writer;
+}
+
+std::recursive_mutex& hdf5_mutex() {
+    static std::recursive_mutex mutex;
+    return mutex;
+}
@@ -0,0 +1,60 @@
+/**
+ * Background thread for writing checkpoints (e.g. States of the ODE solver into HDF5 files), such that the computation
+ * can continue while the data is written.
+ */
+
+#ifndef KELDYSH_MFRG_CHECKPOINT_WRITER_HPP
+#define KELDYSH_MFRG_CHECKPOINT_WRITER_HPP
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <exception>
+
+/**
+ * Runs one write job at a time in a background thread. A job has to own all of its data (e.g. a copy of the State).
+ * Back-pressure: submitting a new job first waits until the previous one has finished, such that at most one snapshot
+ * is kept in memory.
+ * Pending jobs are finished by wait(), flush(), the destructor (also during stack unwinding after an exception) and, for the
+ * global instance async_checkpoints(), at exit(). In std::terminate, the running job is only given a limited time to finish
+ * (see finish_before_terminate()); the worker is never joined there.
+ */
+class checkpoint_writer {
+    std::thread worker;
+    std::exception_ptr error;    // exception thrown by the last job, rethrown by wait()
+    std::mutex mutex;            // guards worker
+    std::atomic<bool> job_running{false};           // cleared by the worker when its job has finished
+    std::atomic<std::thread::id> worker_id{};       // id of the thread running the current job
+
+    void join();
+public:
+    checkpoint_writer() = default;
+    checkpoint_writer(const checkpoint_writer&) = delete;
+    checkpoint_writer& operator= (const checkpoint_writer&) = delete;
+    ~checkpoint_writer();
+
+    /// Waits for the previous job, then starts job in the background and returns immediately
+    void submit(std::function<void()> job);
+    /// Waits until the current job is finished; rethrows an exception of the job
+    void wait();
+    /// Waits until the current job is finished; an exception of the job is only printed
+    void flush() noexcept;
+    /// True if a job has been submitted which has not been waited for
+    bool busy();
+    /**
+     * Waits at most timeout for the running job to finish, without joining the worker and without locking, such that it
+     * can be called from a terminate handler (which may run in the worker itself or while another thread holds the mutex).
+     * Returns immediately if called from the worker.
+     */
+    void finish_before_terminate(std::chrono::seconds timeout) noexcept;
+};
+
+/// Writer of the checkpoints of the ODE solver (see ASYNC_CHECKPOINTS)
+checkpoint_writer& async_checkpoints();
+
+/// Mutex for all accesses to HDF5 files which may run concurrently to the checkpoint writer (the HDF5 library is not necessarily thread-safe)
+std::recursive_mutex& hdf5_mutex();
+
+#endif //KELDYSH_MFRG_CHECKPOINT_WRITER_HPP
@@ -59,6 +59,7 @@ hsize_t h5_cast(int dim) {
 
 
 State<state_datatype,false> read_state_from_hdf(const H5std_string& filename, const int Lambda_it) {
+    std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
     H5::H5File file_out = open_hdf_file_readOnly(filename);
 
     std::vector<double> Lambda;
@@ -66,6 +67,13 @@ State<state_datatype,false> read_state_from_hdf(const H5std_string& filename, co
     fRG_config config = read_config_from_hdf(filename);
     State<state_datatype,false> state(Lambda[0], config);
 
+    // reads the data of a vertex buffer via a temporary array, since the buffer may be stored in reduced precision
+    auto read_buffer = [&](const H5std_string& dataset_name, auto& buffer) {
+        typename std::decay_t<decltype(buffer)>::buffer_type values(buffer.get_dims());
+        read_from_hdf_LambdaLayer<state_datatype>(file_out, dataset_name, values, Lambda_it);
+        buffer.set_vec(values);
+    };
+
     std::vector<state_datatype> Sigma_H;
     read_from_hdf_LambdaLayer<state_datatype>(file_out, SELF_LIST, state.selfenergy.Sigma.data, Lambda_it);
     read_from_hdf_LambdaLayer<state_datatype>(file_out, HARTREE, Sigma_H, Lambda_it);
@@ -75,19 +83,19 @@ State<state_datatype,false> read_state_from_hdf(const H5std_string& filename, co
     read_from_hdf_LambdaLayer<state_datatype>(file_out, DATASET_K1_p, state.vertex.pvertex().K1.data, Lambda_it);
     read_from_hdf_LambdaLayer<state_datatype>(file_out, DATASET_K1_t, state.vertex.tvertex().K1.data, Lambda_it);
 #if MAX_DIAG_CLASS>1
-    read_from_hdf_LambdaLayer<state_datatype>(file_out, DATASET_K2_a, state.vertex.avertex().K2.data, Lambda_it);
-    read_from_hdf_LambdaLayer<state_datatype>(file_out, DATASET_K2_p, state.vertex.pvertex().K2.data, Lambda_it);
-    read_from_hdf_LambdaLayer<state_datatype>(file_out, DATASET_K2_t, state.vertex.tvertex().K2.data, Lambda_it);
+    read_buffer(DATASET_K2_a, state.vertex.avertex().K2);
+    read_buffer(DATASET_K2_p, state.vertex.pvertex().K2);
+    read_buffer(DATASET_K2_t, state.vertex.tvertex().K2);
 #if DEBUG_SYMMETRIES
-    read_from_hdf_LambdaLayer<state_datatype>(file_out, DATASET_K2b_a, state.vertex.avertex().K2b.data, Lambda_it);
-    read_from_hdf_LambdaLayer<state_datatype>(file_out, DATASET_K2b_p, state.vertex.pvertex().K2b.data, Lambda_it);
-    read_from_hdf_LambdaLayer<state_datatype>(file_out, DATASET_K2b_t, state.vertex.tvertex().K2b.data, Lambda_it);
+    read_buffer(DATASET_K2b_a, state.vertex.avertex().K2b);
+    read_buffer(DATASET_K2b_p, state.vertex.pvertex().K2b);
+    read_buffer(DATASET_K2b_t, state.vertex.tvertex().K2b);
 #endif
 #endif
 #if MAX_DIAG_CLASS>2
-    read_from_hdf_LambdaLayer<state_datatype>(file_out, DATASET_K3_a, state.vertex.avertex().K3.data, Lambda_it);
-    read_from_hdf_LambdaLayer<state_datatype>(file_out, DATASET_K3_p, state.vertex.pvertex().K3.data, Lambda_it);
-    read_from_hdf_LambdaLayer<state_datatype>(file_out, DATASET_K3_t, state.vertex.tvertex().K3.data, Lambda_it);
+    read_buffer(DATASET_K3_a, state.vertex.avertex().K3);
+    read_buffer(DATASET_K3_p, state.vertex.pvertex().K3);
+    read_buffer(DATASET_K3_t, state.vertex.tvertex().K3);
 #endif
     H5::Group group_freqparams(file_out.openGroup(FREQ_PARAMS));
     H5::Group group_freqparams_ffreqs (group_freqparams.openGroup(FFREQS_LIST ));
@@ -192,6 +200,7 @@ State<state_datatype,false> read_state_from_hdf(const H5std_string& filename, co
 
 
 bool check_convergence_hdf(const H5std_string& filename, int& Lambda_it) {
+    std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
     H5::H5File file_out;
     H5::Exception::dontPrint();
     bool is_converged;
@@ -213,12 +222,37 @@ bool check_convergence_hdf(const H5std_string& filename, int& Lambda_it) {
 }
 
 
+bool read_checkpoint_info_from_hdf(const H5std_string& filename, std::vector<double>& info) {
+    // process 0 reads, all processes take the same decision
+    vec<double> header = {0., 0.}; // found, size of info
+    if (mpi_world_rank() == 0) {
+        std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
+        if (std::ifstream(filename).good()) {
+            H5::Exception::dontPrint();
+            try {
+                H5::H5File file(filename, H5F_ACC_RDONLY);
+                read_from_hdf(file, CHECKPOINT_INFO, info);
+                file.close();
+                header = {1., (double) info.size()};
+            } catch(const H5::Exception&) {}
+        }
+    }
+    mpi_request request = mpi_ibroadcast(header.data(), header.size(), 0);
+    mpi_wait(request);
+    if (header[0] == 0.) return false;
+    info.resize((size_t) header[1]);
+    request = mpi_ibroadcast(info.data(), info.size(), 0);
+    mpi_wait(request);
+    return true;
+}
+
 
 rvec read_Lambdas_from_hdf(const H5std_string FILE_NAME){
 
 
 
     // Open the file. Access rights: read-only
+    std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
     H5::H5File file = open_hdf_file_readOnly(FILE_NAME);
 
     H5::DataSet lambda_dataset = file.openDataSet("lambdas");
@@ -267,6 +301,7 @@ bool test_read_write_data_hdf(bool verbose) {
     //if (verbose) utils::print("File name: " + testfile_name, true);
 
     // write to hdf file
+    std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
     H5::H5File file_out = create_hdf_file(testfile_name.c_str());
     //if (verbose) utils::print("Created file.", true);
     //H5::H5std_string FILE_NAME(data_dir + "test.h5");
@@ -390,6 +425,7 @@ bool test_read_write_state_hdf(bool verbose) {
 
 
 fRG_config read_config_from_hdf(const H5std_string FILE_NAME) {
+    std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
     H5::H5File file_out(FILE_NAME, H5F_ACC_RDONLY);
 
     fRG_config config;
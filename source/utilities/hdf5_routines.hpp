@@ -8,8 +8,12 @@
 #include <stdexcept>
 #include <cmath>
 #include <vector>
+#include <fstream>                // existence of checkpoint files
+#include <cstdio>                 // std::rename
+#include <tuple>                  // snapshots of asynchronous checkpoints
 #include "../parameters/master_parameters.hpp"         // system parameters (necessary for vector lengths etc.)
 #include "util.hpp"               // printing text
+#include "checkpoint_writer.hpp"  // mutex for accesses concurrent to the background checkpoints
 #include "../data_structures.hpp"    // comp data type, std::real/complex vector class
 #include "../grids/frequency_grid.hpp"     // store frequency grid parameters
 #include "H5Cpp.h"              // HDF5 functions
@@ -612,6 +616,7 @@ namespace hdf5_impl {
 
     template<typename Q, bool diff>
     void write_state_to_hdf_LambdaLayer(const H5std_string& filename, const State<Q, diff>& state, const int Lambda_it, const int numberLambdaLayers, const std::string write_mode, const bool is_converged=false, const bool verbose=true) {
+        std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
         H5::H5File file_out;
         //H5::Exception::dontPrint();
         const bool keep_existing_file = (write_mode == "rw");
@@ -841,6 +846,7 @@ void write_state_to_hdf(const H5std_string FILE_NAME, double Lambda_i, const int
     if (mpi_world_rank() == 0)  // only the process with ID 0 writes into file to avoid collisions
 #endif
     {
+        std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
         hdf5_impl::write_state_to_hdf_LambdaLayer(FILE_NAME, state_in, 0, Lambda_size, "w", is_converged);
         if (verbose) {
             utils::print("Successfully saved in hdf5 file: ", FILE_NAME);
@@ -867,6 +873,7 @@ void add_state_to_hdf(const H5std_string FILE_NAME, int Lambda_it, const State<Q
     if (mpi_world_rank() == 0)  // only the process with ID 0 writes into file to avoid collisions
 #endif
     {
+        std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
         multidimensional::multiarray<double,2> Lambdas;
         H5::H5File file_out = open_hdf_file_readWrite(FILE_NAME);
         read_from_hdf<double>(file_out, LAMBDA_LIST, Lambdas);
@@ -896,6 +903,60 @@ void add_state_to_hdf(const H5std_string FILE_NAME, int Lambda_it, const State<Q
 State<state_datatype,false> read_state_from_hdf(const H5std_string& filename, int Lambda_it) ;
 bool check_convergence_hdf(const H5std_string& filename, int& Lambda_it);
 
+const H5std_string  CHECKPOINT_INFO("checkpoint_info");
+
+/**
+ * Write a checkpoint of an unfinished computation: the States are stored in the Lambda layers 0, 1, ... of the file,
+ * together with numbers which identify the checkpoint (e.g. Lambda and a checksum of the input of the computation).
+ * The file is written under a temporary name and renamed afterwards, such that an interrupted write never replaces a
+ * complete checkpoint by an incomplete one.
+ * @param filename Name of the checkpoint file.
+ * @param info Numbers identifying the checkpoint, see read_checkpoint_info_from_hdf().
+ * @param state_first State stored in Lambda layer 0.
+ * @param states_rest States stored in the following Lambda layers.
+ */
+template <typename Q, bool diff, typename... States>
+void write_checkpoint_to_hdf(const H5std_string& filename, const std::vector<double>& info, const State<Q,diff>& state_first, const States&... states_rest) {
+    if (mpi_world_rank() == 0) {  // only the process with ID 0 writes into file to avoid collisions
+        std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
+        const std::string filename_tmp = filename + ".tmp";
+        const int number_of_layers = 1 + sizeof...(States);
+        write_state_to_hdf(filename_tmp, state_first.Lambda, number_of_layers, state_first, false);
+        int layer = 1;
+        (add_state_to_hdf(filename_tmp, layer++, states_rest, false, false), ...);
+
+        H5::H5File file = open_hdf_file_readWrite(filename_tmp);
+        write_to_hdf(file, CHECKPOINT_INFO, info, false);
+        file.close();
+        std::rename(filename_tmp.c_str(), filename.c_str());
+    }
+}
+
+/**
+ * Write a checkpoint as write_checkpoint_to_hdf(). With ASYNC_CHECKPOINTS, the States are copied (or moved, if passed as
+ * temporaries) and written by async_checkpoints() in the background, after the previous checkpoint has been completed.
+ */
+template <typename... States>
+void write_checkpoint_to_hdf_async(const H5std_string& filename, const std::vector<double>& info, States&&... states) {
+    if constexpr (ASYNC_CHECKPOINTS) {
+        if (mpi_world_rank() != 0) return;
+        async_checkpoints().wait(); // at most one snapshot is kept in memory
+        async_checkpoints().submit([filename, info, snapshot = std::make_tuple(std::forward<States>(states)...)]() {
+            std::apply([&](const auto&... states_snapshot) { write_checkpoint_to_hdf(filename, info, states_snapshot...); }, snapshot);
+        });
+    }
+    else {
+        write_checkpoint_to_hdf(filename, info, states...);
+    }
+}
+
+/**
+ * Read the numbers identifying a checkpoint written by write_checkpoint_to_hdf(). Has to be called by all MPI processes:
+ * the file is read by process 0 and the result is broadcast, such that all processes take the same decision.
+ * @return False if there is no (readable) checkpoint file.
+ */
+bool read_checkpoint_info_from_hdf(const H5std_string& filename, std::vector<double>& info);
+
 /// --- Functions for reading data from file --- ///
 
 /**
@@ -1,5 +1,69 @@
 #include "mpi_setup.hpp"
+#include <iostream>
+#include <climits>
 #ifdef USE_MPI
+namespace {
+/**
+ * Count and datatype describing a buffer of n elements of a predefined datatype. MPI counts are int: larger buffers
+ * are described by a single element of a derived datatype (blocks of INT_MAX elements and a remainder). The derived
+ * datatype is released by the destructor, which may happen while a non-blocking operation using it is still pending.
+ * Not for reductions, which are only defined for predefined datatypes.
+ */
+class mpi_large_count {
+public:
+    int count;
+    MPI_Datatype type;
+
+    mpi_large_count(const size_t n, const MPI_Datatype element_type) : count(static_cast<int>(n)), type(element_type) {
+        if (n <= INT_MAX) return;
+        const size_t n_blocks = n / INT_MAX;
+        assert(n_blocks <= INT_MAX);
+        MPI_Datatype blocks, remainder;
+        MPI_Type_vector(static_cast<int>(n_blocks), INT_MAX, INT_MAX, element_type, &blocks);
+        MPI_Type_contiguous(static_cast<int>(n % INT_MAX), element_type, &remainder);
+        MPI_Aint lower_bound, extent;
+        MPI_Type_get_extent(element_type, &lower_bound, &extent);
+        int block_lengths[2] = {1, 1};
+        MPI_Aint displacements[2] = {0, static_cast<MPI_Aint>(n_blocks * INT_MAX) * extent};
+        MPI_Datatype types[2] = {blocks, remainder};
+        MPI_Type_create_struct(2, block_lengths, displacements, types, &type);
+        MPI_Type_commit(&type);
+        MPI_Type_free(&blocks);
+        MPI_Type_free(&remainder);
+        count = 1;
+        derived = true;
+    }
+    ~mpi_large_count() {if (derived) MPI_Type_free(&type);}
+    mpi_large_count(const mpi_large_count&) = delete;
+    mpi_large_count& operator=(const mpi_large_count&) = delete;
+private:
+    bool derived = false;
+};
+
+/// MPI_Iallgatherv in place, with counts and displacements in units of tasks (see mpi_gather_layout)
+mpi_request iallgatherv_in_place(void* data, const mpi_gather_layout& layout, const MPI_Datatype element_type) {
+    assert(layout.n_elements_per_task <= INT_MAX);
+    MPI_Datatype task_type;
+    MPI_Type_contiguous(static_cast<int>(layout.n_elements_per_task), element_type, &task_type);
+    MPI_Type_commit(&task_type);
+    mpi_request request;
+    MPI_Iallgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
+                    data, layout.counts.data(), layout.displacements.data(), task_type, layout.comm, &request);
+    MPI_Type_free(&task_type);
+    return request;
+}
+}
+
+void mpi_init_funneled() {
+    int mpi_thread_support;
+    MPI_Init_thread(nullptr, nullptr, MPI_THREAD_FUNNELED, &mpi_thread_support);
+    if (mpi_thread_support < MPI_THREAD_FUNNELED) {
+        std::cerr << "Error: MPI library only provides thread support level " << mpi_thread_support
+                  << ", but MPI_THREAD_FUNNELED is required." << std::endl;
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+}
+
 int mpi_world_rank() {
     int world_rank= 0;
     if constexpr (MPI_FLAG) MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
@@ -12,19 +76,145 @@ int mpi_world_size() {
     return world_size;
 }
 
-void mpi_collect(vec<comp>& buffer, vec<comp>& result, int n_mpi, int n_omp) {
-    int world_size = mpi_world_size();
-    MPI_Allgather(&buffer[0], static_cast<int>(2*n_omp*(n_mpi/world_size+1)), MPI_COMPLEX,
-                  &result[0], static_cast<int>(2*n_omp*(n_mpi/world_size+1)), MPI_COMPLEX, MPI_COMM_WORLD);
+int mpi_comm_rank(const mpi_communicator comm) {
+    int rank = 0;
+    MPI_Comm_rank(comm, &rank);
+    return rank;
+}
+
+int mpi_comm_size(const mpi_communicator comm) {
+    int size = 1;
+    MPI_Comm_size(comm, &size);
+    return size;
+}
+
+mpi_communicator mpi_split_world(const int color) {
+    mpi_communicator comm;
+    MPI_Comm_split(MPI_COMM_WORLD, color, mpi_world_rank(), &comm);
+    return comm;
+}
+
+void mpi_free_communicator(mpi_communicator& comm) {
+    MPI_Comm_free(&comm);
+}
+
+mpi_request mpi_iallgatherv_in_place(comp* data, const mpi_gather_layout& layout) {
+    return iallgatherv_in_place(data, layout, MPI_CXX_DOUBLE_COMPLEX);
+}
+
+mpi_request mpi_iallgatherv_in_place(double* data, const mpi_gather_layout& layout) {
+    return iallgatherv_in_place(data, layout, MPI_DOUBLE);
+}
+
+mpi_request mpi_iallgatherv_in_place(std::complex<float>* data, const mpi_gather_layout& layout) {
+    return iallgatherv_in_place(data, layout, MPI_CXX_FLOAT_COMPLEX);
+}
+
+mpi_request mpi_iallgatherv_in_place(float* data, const mpi_gather_layout& layout) {
+    return iallgatherv_in_place(data, layout, MPI_FLOAT);
+}
+
+mpi_request mpi_iallreduce_sum(comp* data, const size_t size, const mpi_communicator comm) {
+    // complex numbers are summed component-wise as pairs of doubles
+    return mpi_iallreduce_sum(reinterpret_cast<double*>(data), 2*size, comm);
+}
+
+mpi_request mpi_iallreduce_sum(double* data, const size_t size, const mpi_communicator comm) {
+    assert(size <= INT_MAX); // MPI_SUM is only defined for predefined datatypes, see mpi_large_count
+    mpi_request request;
+    MPI_Iallreduce(MPI_IN_PLACE, data, static_cast<int>(size), MPI_DOUBLE, MPI_SUM, comm, &request);
+    return request;
+}
+
+mpi_request mpi_iallreduce_sum(std::complex<float>* data, const size_t size, const mpi_communicator comm) {
+    // complex numbers are summed component-wise as pairs of floats
+    return mpi_iallreduce_sum(reinterpret_cast<float*>(data), 2*size, comm);
+}
+
+mpi_request mpi_iallreduce_sum(float* data, const size_t size, const mpi_communicator comm) {
+    assert(size <= INT_MAX); // MPI_SUM is only defined for predefined datatypes, see mpi_large_count
+    mpi_request request;
+    MPI_Iallreduce(MPI_IN_PLACE, data, static_cast<int>(size), MPI_FLOAT, MPI_SUM, comm, &request);
+    return request;
+}
+
+mpi_request mpi_ibroadcast(comp* data, const size_t size, const int root) {
+    mpi_request request;
+    const mpi_large_count n (size, MPI_CXX_DOUBLE_COMPLEX);
+    MPI_Ibcast(data, n.count, n.type, root, MPI_COMM_WORLD, &request);
+    return request;
+}
+
+mpi_request mpi_ibroadcast(double* data, const size_t size, const int root) {
+    mpi_request request;
+    const mpi_large_count n (size, MPI_DOUBLE);
+    MPI_Ibcast(data, n.count, n.type, root, MPI_COMM_WORLD, &request);
+    return request;
+}
+
+mpi_request mpi_ibroadcast(std::complex<float>* data, const size_t size, const int root) {
+    mpi_request request;
+    const mpi_large_count n (size, MPI_CXX_FLOAT_COMPLEX);
+    MPI_Ibcast(data, n.count, n.type, root, MPI_COMM_WORLD, &request);
+    return request;
+}
+
+mpi_request mpi_ibroadcast(float* data, const size_t size, const int root) {
+    mpi_request request;
+    const mpi_large_count n (size, MPI_FLOAT);
+    MPI_Ibcast(data, n.count, n.type, root, MPI_COMM_WORLD, &request);
+    return request;
 }
 
-void mpi_collect(vec<double>& buffer, vec<double>& result, int n_mpi, int n_omp) {
-    int world_size = mpi_world_size();
+bool mpi_test(mpi_request& request) {
+    int completed;
+    MPI_Test(&request, &completed, MPI_STATUS_IGNORE);
+    return completed;
+}
+
+void mpi_wait(mpi_request& request) {
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+}
+
+vec<double> mpi_gather_on_root(const double value, const mpi_communicator comm) {
+    const int rank = mpi_comm_rank(comm);
+    vec<double> values (rank == 0 ? mpi_comm_size(comm) : 0);
+    MPI_Gather(&value, 1, MPI_DOUBLE, values.data(), 1, MPI_DOUBLE, 0, comm);
+    return values;
+}
 
-    MPI_Allgather(&buffer[0], static_cast<int>(n_omp*(n_mpi/world_size+1)), MPI_DOUBLE,
-                  &result[0], static_cast<int>(n_omp*(n_mpi/world_size+1)), MPI_DOUBLE, MPI_COMM_WORLD);
+mpi_dynamic_scheduler::mpi_dynamic_scheduler(const size_t n_tasks_in, const size_t chunk_size_in, const mpi_communicator comm_in)
+        : n_tasks(n_tasks_in), chunk_size(std::max(chunk_size_in, (size_t) 1)), comm(comm_in) {
+    const int rank = mpi_comm_rank(comm);
+    const MPI_Aint window_size = rank == 0 ? sizeof(long) : 0;
+    MPI_Win_allocate(window_size, sizeof(long), MPI_INFO_NULL, comm, &counter, &window);
+    if (rank == 0) {
+        MPI_Win_lock(MPI_LOCK_EXCLUSIVE, 0, 0, window);
+        *counter = 0;
+        MPI_Win_unlock(0, window);
+    }
+    MPI_Barrier(comm);    // counter must be initialized before anybody fetches a chunk
+    MPI_Win_lock_all(0, window);
+}
+
+mpi_dynamic_scheduler::~mpi_dynamic_scheduler() {
+    MPI_Win_unlock_all(window);
+    MPI_Win_free(&window);
+}
+
+bool mpi_dynamic_scheduler::next_chunk(size_t& begin, size_t& end) {
+    const long increment = 1;
+    long i_chunk;
+    MPI_Fetch_and_op(&increment, &i_chunk, MPI_LONG, 0, 0, MPI_SUM, window);
+    MPI_Win_flush(0, window);
+    begin = i_chunk * chunk_size;
+    if (begin >= n_tasks) return false;
+    end = std::min(begin + chunk_size, n_tasks);
+    return true;
 }
 #else
+void mpi_init_funneled() {}
+
 int mpi_world_rank() {
     return 0;
 }
@@ -32,11 +222,76 @@ int mpi_world_rank() {
 int mpi_world_size() {
     return 1;
 }
-void mpi_collect(vec<comp>& buffer, vec<comp>& result, int n_mpi, int n_omp) {
-    result = buffer;
+
+int mpi_comm_rank(const mpi_communicator comm) {
+    return 0;
+}
+
+int mpi_comm_size(const mpi_communicator comm) {
+    return 1;
 }
 
-void mpi_collect(vec<double>& buffer, vec<double>& result, int n_mpi, int n_omp) {
-    result = buffer;
+mpi_communicator mpi_split_world(const int color) {
+    return MPI_COMM_WORLD_HANDLE;
 }
-#endif
\ No newline at end of file
+
+void mpi_free_communicator(mpi_communicator& comm) {}
+
+mpi_request mpi_iallgatherv_in_place(comp* data, const mpi_gather_layout& layout) {return 0;}
+
+mpi_request mpi_iallgatherv_in_place(double* data, const mpi_gather_layout& layout) {return 0;}
+
+mpi_request mpi_iallgatherv_in_place(std::complex<float>* data, const mpi_gather_layout& layout) {return 0;}
+
+mpi_request mpi_iallgatherv_in_place(float* data, const mpi_gather_layout& layout) {return 0;}
+
+mpi_request mpi_iallreduce_sum(comp* data, const size_t size, const mpi_communicator comm) {return 0;}
+
+mpi_request mpi_iallreduce_sum(double* data, const size_t size, const mpi_communicator comm) {return 0;}
+
+mpi_request mpi_iallreduce_sum(std::complex<float>* data, const size_t size, const mpi_communicator comm) {return 0;}
+
+mpi_request mpi_iallreduce_sum(float* data, const size_t size, const mpi_communicator comm) {return 0;}
+
+mpi_request mpi_ibroadcast(comp* data, const size_t size, const int root) {return 0;}
+
+mpi_request mpi_ibroadcast(double* data, const size_t size, const int root) {return 0;}
+
+mpi_request mpi_ibroadcast(std::complex<float>* data, const size_t size, const int root) {return 0;}
+
+mpi_request mpi_ibroadcast(float* data, const size_t size, const int root) {return 0;}
+
+bool mpi_test(mpi_request& request) {return true;}
+
+void mpi_wait(mpi_request& request) {}
+
+vec<double> mpi_gather_on_root(const double value, const mpi_communicator comm) {
+    return vec<double> (1, value);
+}
+
+mpi_dynamic_scheduler::mpi_dynamic_scheduler(const size_t n_tasks_in, const size_t chunk_size_in, const mpi_communicator comm_in)
+        : n_tasks(n_tasks_in), chunk_size(std::max(chunk_size_in, (size_t) 1)), comm(comm_in) {}
+
+mpi_dynamic_scheduler::~mpi_dynamic_scheduler() = default;
+
+bool mpi_dynamic_scheduler::next_chunk(size_t& begin, size_t& end) {
+    begin = (counter++) * chunk_size;
+    if (begin >= n_tasks) return false;
+    end = std::min(begin + chunk_size, n_tasks);
+    return true;
+}
+#endif
+
+mpi_gather_layout::mpi_gather_layout(const size_t n_tasks_in, const size_t n_elements_per_task_in, const mpi_communicator comm_in)
+        : n_tasks(n_tasks_in), n_elements_per_task(std::max(n_elements_per_task_in, (size_t) 1)), comm(comm_in) {
+    assert(n_tasks <= INT_MAX); // counts and displacements are int (in units of tasks)
+    const size_t comm_size = mpi_comm_size(comm);
+    counts.resize(comm_size);
+    displacements.resize(comm_size);
+    for (size_t rank = 0; rank < comm_size; rank++) {
+        const size_t first = n_tasks * rank / comm_size;
+        const size_t last  = n_tasks * (rank + 1) / comm_size;
+        counts[rank]        = static_cast<int>(last - first);
+        displacements[rank] = static_cast<int>(first);
+    }
+}
\ No newline at end of file
@@ -10,87 +10,195 @@
 #include <mpi.h>             // basic mpi functionality
 #endif
 
+#ifdef USE_MPI
+using mpi_request = MPI_Request;   // handle of a non-blocking MPI operation
+#define MPI_REQUEST_NULL_HANDLE MPI_REQUEST_NULL
+using mpi_communicator = MPI_Comm; // handle of a group of MPI processes
+#define MPI_COMM_WORLD_HANDLE MPI_COMM_WORLD
+#else
+using mpi_request = int;
+#define MPI_REQUEST_NULL_HANDLE 0
+using mpi_communicator = int;
+#define MPI_COMM_WORLD_HANDLE 0
+#endif
+
+/**
+ * initialize MPI with thread support MPI_THREAD_FUNNELED, i.e. only the master thread communicates via MPI, while
+ * OpenMP threads (e.g. the tasks of the dynamic bubble scheduler) compute in parallel. Aborts all processes with an
+ * error message if the MPI library provides a lower level of thread support.
+ */
+void mpi_init_funneled();
+
 // Get the rank(ID) of the current process
 int mpi_world_rank();
 
 // Get the number of processes
 int mpi_world_size();
 
+// Get the rank(ID) of the current process within the communicator comm
+int mpi_comm_rank(mpi_communicator comm);
+
+// Get the number of processes within the communicator comm
+int mpi_comm_size(mpi_communicator comm);
+
+/**
+ * split MPI_COMM_WORLD into groups of processes, using MPI_Comm_split (collective call).
+ * The ranks within each group keep the order of the world ranks.
+ * @param color : number of the group of the current process
+ * @return mpi_communicator : communicator of the group of the current process; to be released by mpi_free_communicator
+ */
+mpi_communicator mpi_split_world(int color);
+
+// release a communicator created by mpi_split_world(...)
+void mpi_free_communicator(mpi_communicator& comm);
+
+/**
+ * Layout of a vector that is distributed over all MPI processes of a communicator in contiguous blocks, as needed for
+ * MPI_Allgatherv. The tasks [0, n_tasks) are split into one block of (almost) equal size per process; each task owns
+ * n_elements_per_task consecutive elements of the vector. Counts and displacements are given in units of tasks (MPI
+ * communicates one task as one element of a derived datatype), such that they fit into an int also for large vectors.
+ */
+struct mpi_gather_layout {
+    size_t n_tasks;
+    size_t n_elements_per_task;
+    mpi_communicator comm;              // processes over which the vector is distributed
+    std::vector<int> counts;            // number of tasks owned by each process
+    std::vector<int> displacements;     // first task of the block of each process
+
+    mpi_gather_layout(size_t n_tasks_in, size_t n_elements_per_task_in, mpi_communicator comm_in = MPI_COMM_WORLD_HANDLE);
+
+    /// first task of the block of process rank
+    size_t first_task(int rank) const {return displacements[rank];}
+    /// one past the last task of the block of process rank
+    size_t last_task(int rank) const {return displacements[rank] + counts[rank];}
+};
+
+/**
+ * distribute the blocks of all MPI processes to all processes, using MPI_Iallgatherv in place (for data type comp).
+ * No intermediate buffers are needed, such that the results can be collected directly in their final destination.
+ * data and layout must not be touched until the returned request is completed by mpi_wait(...).
+ * @param data   : pointer to the distributed vector; the block of the current process must be filled on entry,
+ *                 the full vector is filled on completion
+ * @param layout : block layout of the vector
+ */
+mpi_request mpi_iallgatherv_in_place(comp* data, const mpi_gather_layout& layout);
+
+/**
+ * distribute the blocks of all MPI processes to all processes, using MPI_Iallgatherv in place (for data type double).
+ * data and layout must not be touched until the returned request is completed by mpi_wait(...).
+ */
+mpi_request mpi_iallgatherv_in_place(double* data, const mpi_gather_layout& layout);
+
+/**
+ * distribute the blocks of all MPI processes to all processes, using MPI_Iallgatherv in place (for data stored in
+ * single precision, see K2_SINGLE_PRECISION and K3_SINGLE_PRECISION).
+ * data and layout must not be touched until the returned request is completed by mpi_wait(...).
+ */
+mpi_request mpi_iallgatherv_in_place(std::complex<float>* data, const mpi_gather_layout& layout);
+mpi_request mpi_iallgatherv_in_place(float* data, const mpi_gather_layout& layout);
+
+/**
+ * sum up the buffers of all MPI processes element-wise, using MPI_Iallreduce in place (for data type comp).
+ * data must not be touched until the returned request is completed by mpi_wait(...).
+ * The number of doubles (2*size for comp) must not exceed INT_MAX.
+ * @param data : pointer to the (partial) results of the current process; contains the sum over all processes on
+ *               completion
+ * @param size : number of elements
+ * @param comm : processes over which the sum is taken
+ */
+mpi_request mpi_iallreduce_sum(comp* data, size_t size, mpi_communicator comm = MPI_COMM_WORLD_HANDLE);
+
 /**
- * initialize buffer into which each MPI process can write
- * @tparam Q      : result data type (comp or double)
- * @param n_mpi   : # of MPI tasks (# of grid points for external variable(s) in which we do MPI parallelization)
- * @param n_omp   : # of OMP tasks (# of grid points for external variable(s) in which we do OMP parallelization)
- * @return vec<Q> : empty buffer vector with length corresponding to total number of tasks that the current process
- *                  will compute
- */
-template <typename Q>
-vec<Q> mpi_initialize_buffer(size_t n_mpi, size_t n_omp) {
-    size_t world_size = mpi_world_size();
-    vec<Q> buffer (n_omp*(n_mpi/world_size+1));
-    return buffer;
-}
-
-/**
- * initialize result buffer into which results of all MPI processes are collected
- * @tparam Q      : result data type (comp or double)
- * @param n_mpi   : # of MPI tasks (# of grid points for external variable(s) in which we do MPI parallelization)
- * @param n_omp   : # of OMP tasks (# of grid points for external variable(s) in which we do OMP parallelization)
- * @return vec<Q> : empty result buffer vector with length corresponding to the sum of total numbers of tasks
- *                  for all current processes
- */
-template <typename Q>
-vec<Q> mpi_initialize_result(int n_mpi, int n_omp) {
-    int world_size = mpi_world_size();
-    vec<Q> result (n_omp * (n_mpi - (n_mpi % world_size) + world_size));
-    return result;
-}
-
-/**
- * distribute results between all MPI processes, using MPI_Allgather (for data type comp)
- * @param buffer : buffer vector containing the results of the current process
- * @param result : buffer vector in which the results of all processes are written
- * @param n_mpi  : # of MPI tasks (# of grid points for external variable(s) in which we do MPI parallelization)
- * @param n_omp  : # of OMP tasks (# of grid points for external variable(s) in which we do OMP parallelization)
- */
-void mpi_collect(vec<comp>& buffer, vec<comp>& result, int n_mpi, int n_omp);
-
-/**
- * distribute results between all MPI processes, using MPI_Allgather (for data type double)
- * @param buffer : buffer vector containing the results of the current process
- * @param result : buffer vector in which the results of all processes are written
- * @param n_mpi  : # of MPI tasks (# of grid points for external variable(s) in which we do MPI parallelization)
- * @param n_omp  : # of OMP tasks (# of grid points for external variable(s) in which we do OMP parallelization)
- */
-void mpi_collect(vec<double>& buffer, vec<double>& result, int n_mpi, int n_omp);
-
-/**
- * bring results collected from all MPI processes via mpi_collect(...) into the correct order to store them into
- * the vertex objects
- * @tparam Q
- * @param result
- * @param n_mpi
- * @param n_omp
- * @return
- */
-template <typename Q>
-vec<Q> mpi_reorder_result(vec<Q>& result, int n_mpi, int n_omp) {
-    int world_size = mpi_world_size();
-    vec<Q> ordered_result;
-    for (int i=0; i<n_mpi/world_size; ++i) {
-        for (int j=0; j<world_size; ++j) {
-            typename vec<Q>::const_iterator first = result.begin() + (j*(n_mpi/world_size+1) + i) * n_omp;
-            typename vec<Q>::const_iterator last = first + n_omp;
-            ordered_result.insert(ordered_result.end(), first, last);
-        }
-    }
-    for (int j=0; j<world_size; ++j) {
-        if (n_mpi % world_size > j) {
-            typename vec<Q>::const_iterator first = result.begin() + (j*(n_mpi/world_size+1) + n_mpi/world_size) * n_omp;
-            typename vec<Q>::const_iterator last = first + n_omp;
-            ordered_result.insert(ordered_result.end(), first, last);
-        }
-    }
-    return ordered_result;
-}
+ * sum up the buffers of all MPI processes element-wise, using MPI_Iallreduce in place (for data type double).
+ * data must not be touched until the returned request is completed by mpi_wait(...).
+ */
+mpi_request mpi_iallreduce_sum(double* data, size_t size, mpi_communicator comm = MPI_COMM_WORLD_HANDLE);
+
+/**
+ * sum up the buffers of all MPI processes element-wise, using MPI_Iallreduce in place (for data stored in single
+ * precision, see K2_SINGLE_PRECISION and K3_SINGLE_PRECISION).
+ * data must not be touched until the returned request is completed by mpi_wait(...).
+ * The number of floats (2*size for std::complex<float>) must not exceed INT_MAX.
+ */
+mpi_request mpi_iallreduce_sum(std::complex<float>* data, size_t size, mpi_communicator comm = MPI_COMM_WORLD_HANDLE);
+mpi_request mpi_iallreduce_sum(float* data, size_t size, mpi_communicator comm = MPI_COMM_WORLD_HANDLE);
+
+/**
+ * send a buffer from the process root to all processes, using MPI_Ibcast on MPI_COMM_WORLD (for data type comp).
+ * data must not be touched until the returned request is completed by mpi_wait(...).
+ * Buffers with more than INT_MAX elements are sent as a single element of a derived datatype.
+ * @param data : pointer to the buffer; filled on the process root on entry, on all processes on completion
+ * @param size : number of elements
+ * @param root : world rank of the sending process
+ */
+mpi_request mpi_ibroadcast(comp* data, size_t size, int root);
+
+/**
+ * send a buffer from the process root to all processes, using MPI_Ibcast on MPI_COMM_WORLD (for data type double).
+ * data must not be touched until the returned request is completed by mpi_wait(...).
+ */
+mpi_request mpi_ibroadcast(double* data, size_t size, int root);
+
+/**
+ * send a buffer from the process root to all processes, using MPI_Ibcast on MPI_COMM_WORLD (for data stored in single
+ * precision, see K2_SINGLE_PRECISION and K3_SINGLE_PRECISION).
+ * data must not be touched until the returned request is completed by mpi_wait(...).
+ */
+mpi_request mpi_ibroadcast(std::complex<float>* data, size_t size, int root);
+mpi_request mpi_ibroadcast(float* data, size_t size, int root);
+
+/**
+ * check whether a non-blocking MPI operation is completed. Also gives the MPI library the opportunity to progress
+ * the operation, so it should be called regularly (from the master thread) while computing something else.
+ * @param request : handle of the operation
+ * @return bool   : true if the operation is completed
+ */
+bool mpi_test(mpi_request& request);
+
+/**
+ * wait until a non-blocking MPI operation is completed
+ * @param request : handle of the operation
+ */
+void mpi_wait(mpi_request& request);
+
+/**
+ * collect one value from every MPI process on rank 0, using MPI_Gather
+ * @param value   : value of the current process
+ * @param comm    : processes from which the values are collected (on their rank 0)
+ * @return vec<double> : values of all processes, ordered by rank (only filled on rank 0)
+ */
+vec<double> mpi_gather_on_root(double value, mpi_communicator comm = MPI_COMM_WORLD_HANDLE);
+
+/**
+ * Distributes a flat iteration space [0, n_tasks) dynamically over all MPI processes of a communicator.
+ * The iteration space is cut into chunks of chunk_size consecutive tasks. Processes fetch the next unprocessed chunk
+ * by incrementing a shared counter on rank 0 via MPI one-sided communication (MPI_Fetch_and_op), such that fast
+ * processes simply fetch more chunks and no process has to act as a dedicated coordinator.
+ * Construction and destruction are collective calls. next_chunk(...) must only be called by the master thread.
+ */
+class mpi_dynamic_scheduler {
+    const size_t n_tasks;
+    const size_t chunk_size;
+    const mpi_communicator comm;
+#ifdef USE_MPI
+    MPI_Win window;
+    long* counter = nullptr;    // shared chunk counter, exposed by rank 0
+#else
+    long counter = 0;
+#endif
+public:
+    mpi_dynamic_scheduler(size_t n_tasks_in, size_t chunk_size_in, mpi_communicator comm_in = MPI_COMM_WORLD_HANDLE);
+    ~mpi_dynamic_scheduler();
+    mpi_dynamic_scheduler(const mpi_dynamic_scheduler&) = delete;
+    mpi_dynamic_scheduler& operator=(const mpi_dynamic_scheduler&) = delete;
+
+    /**
+     * fetch the next unprocessed chunk
+     * @param begin : first task of the chunk
+     * @param end   : one past the last task of the chunk
+     * @return bool : false if all chunks have been handed out already
+     */
+    bool next_chunk(size_t& begin, size_t& end);
+};
+
 #endif //KELDYSH_MFRG_MPI_SETUP_HPP
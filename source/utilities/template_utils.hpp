@@ -1,6 +1,9 @@
 #ifndef FPP_MFRG_TEMPLATE_UTILS_H
 #define FPP_MFRG_TEMPLATE_UTILS_H
 
+#include <complex>
+#include <type_traits>
+
 /// bool pack:
 template<bool...> struct bool_pack;
 template<bool... bs>
@@ -18,5 +21,13 @@ template<class... Ts>
 using are_all_unsigned = all_true<(!std::is_signed<Ts>::value)...>;
 
 
+/// single-precision counterpart of a real or complex data type:
+template<typename T> struct single_precision {using type = T;};
+template<> struct single_precision<double> {using type = float;};
+template<> struct single_precision<std::complex<double>> {using type = std::complex<float>;};
+template<typename T>
+using single_precision_t = typename single_precision<T>::type;
+
+
 
 #endif //FPP_MFRG_TEMPLATE_UTILS_H
@@ -1,5 +1,8 @@
 #include "util.hpp"
 #include <omp.h>
+#ifdef __linux__
+#include <sys/syscall.h>   // move_pages
+#endif
 
 namespace utils {
 
@@ -112,6 +115,56 @@ namespace utils {
         }
     }
 
+    std::map<int, size_t> count_pages_per_numa_node(const void* data, const size_t n_bytes) {
+        std::map<int, size_t> result;
+    #if defined(__linux__) and defined(SYS_move_pages)
+        if (data == nullptr or n_bytes == 0) return result;
+        const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+        const uintptr_t first_page = reinterpret_cast<uintptr_t>(data) / page_size * page_size;
+        const uintptr_t end = reinterpret_cast<uintptr_t>(data) + n_bytes;
+        const size_t n_pages = (end - first_page + page_size - 1) / page_size;
+
+        // move_pages without target nodes only returns the current node of every page
+        const size_t chunk_size = 4096;
+        std::vector<void*> pages (chunk_size);
+        std::vector<int> status (chunk_size);
+        for (size_t i_first = 0; i_first < n_pages; i_first += chunk_size) {
+            const size_t n = std::min(chunk_size, n_pages - i_first);
+            for (size_t i = 0; i < n; i++) pages[i] = reinterpret_cast<void*>(first_page + (i_first + i) * page_size);
+            if (syscall(SYS_move_pages, 0, n, pages.data(), nullptr, status.data(), 0) != 0) return {};
+            for (size_t i = 0; i < n; i++) result[status[i] >= 0 ? status[i] : -1]++;
+        }
+    #endif
+        return result;
+    }
+
+    void print_page_placement(const std::string& name, const void* data, const size_t n_bytes) {
+        const std::map<int, size_t> pages = count_pages_per_numa_node(data, n_bytes);
+        if (mpi_world_rank() != 0) return;
+        std::cout << "\t" << name << ": ";
+        if (pages.empty()) std::cout << "page placement not available";
+        for (const auto& [node, count] : pages) {
+            if (node < 0) std::cout << "untouched: " << count << " pages \t";
+            else std::cout << "node " << node << ": " << count << " pages \t";
+        }
+        std::cout << std::endl;
+    }
+
+    void print_memory_usage() {
+        double current = 0., peak = 0.; // in GB
+    #ifdef __linux__
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.rfind("VmRSS:", 0) == 0) current = std::stod(line.substr(6)) / (1024. * 1024.); // given in kB
+            else if (line.rfind("VmHWM:", 0) == 0) peak = std::stod(line.substr(6)) / (1024. * 1024.);
+        }
+    #endif
+        if (mpi_world_rank() == 0) {
+            std::cout << "memory usage: " << current << " GB, peak: " << peak << " GB" << std::endl;
+        }
+    }
+
     void check_input(const fRG_config& config) {
         static_assert(!(VECTORIZED_INTEGRATION and !KELDYSH and ZERO_TEMP), "No vectorized integration for zero-T MF (for now).");
     #ifdef STATIC_FEEDBACK
@@ -160,6 +160,16 @@ namespace utils {
 
     void makedir(const std::string& dir_str);
 
+    // count the pages of the memory [data, data + n_bytes) per NUMA node (node -1: not touched yet);
+    // returns an empty map if the page placement cannot be queried
+    std::map<int, size_t> count_pages_per_numa_node(const void* data, size_t n_bytes);
+
+    // print the distribution of the pages of [data, data + n_bytes) over the NUMA nodes
+    void print_page_placement(const std::string& name, const void* data, size_t n_bytes);
+
+    // print the current and the peak resident memory of the process (of rank 0)
+    void print_memory_usage();
+
 
     void check_input(const fRG_config& config);
 
@@ -18,6 +18,7 @@ void test_write_dat_rvecs() {
 
 void write_h5_rvecs(std::string path, std::initializer_list<std::string> key_list, std::initializer_list<rvec> rvec_list) {
     if (mpi_world_rank() == 0){
+        std::lock_guard<std::recursive_mutex> lock(hdf5_mutex());
         H5::H5File myfile(path, H5F_ACC_TRUNC); // create file at path
         std::vector<std::string> keys; // store keys in a vector
         for (auto mykey : key_list) keys.push_back(mykey); // fill keys vector
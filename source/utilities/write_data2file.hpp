@@ -3,6 +3,7 @@
 
 #include "../data_structures.hpp" // real/complex vector classes
 #include "mpi_setup.hpp"
+#include "checkpoint_writer.hpp" // mutex for accesses concurrent to the background checkpoints
 #include <fstream>           // standard file input/output
 #include "H5Cpp.h"           // HDF5 package
 